@@ -4,6 +4,7 @@ import time
 import re
 import serial.tools.list_ports as list_ports
 import csv
+import struct
 
 #import time
 
@@ -186,6 +187,151 @@ END_MARKER = 0x7F
 ESCAPE_BYTE = 0x7D
 ESCAPE_XOR = 0x20
 
+#Auxiliary frames, first byte is the frame ID. Never 3, 12 or 20 bytes long
+AUX_FRAME_PULSE = 1
+PULSE_FRAME_LENGTH = 11
+PULSE_CHANNELS = ["IGNITER", "CAMERA"]
+PULSE_ROSE = 1
+PULSE_FELL = 2
+PULSE_CANCELLED = 4
+AUX_FRAME_PROFILE = 2
+PROFILE_HISTOGRAM_BINS = 8
+PROFILE_FRAME_LENGTH = 10 + PROFILE_HISTOGRAM_BINS
+PROFILE_PHASES = ["TEST_INPUT", "LATEST_VALUES", "CHECK", "OUTPUTS", "MODE_SWITCH", "SERIAL"]
+PROFILE_TICK_US = 4
+AUX_FRAME_TIMING = 3
+TIMING_HISTOGRAM_BINS = 8
+TIMING_FRAME_LENGTH = 10 + TIMING_HISTOGRAM_BINS
+AUX_FRAME_EXECUTIVE = 4
+EXECUTIVE_TASKS = ["SENSE", "CHECK", "SEQUENCE", "VERIFICATION", "COMMS", "INDICATORS", "STATISTICS"]
+EXECUTIVE_FRAME_LENGTH = 4 + 2 * len(EXECUTIVE_TASKS)
+AUX_FRAME_TASK_TIMES = 11
+TASK_TIMES_FRAME_LENGTH = 2 + 2 * len(EXECUTIVE_TASKS)
+TASK_TICK_US = 4
+AUX_FRAME_BOOT = 5
+BOOT_FRAME_LENGTH = 9
+STALL_IN_TASK = 0x80
+NO_STALL = 0xFF
+RESET_FLAGS = ["POWER-ON", "EXTERNAL", "BROWN-OUT", "WATCHDOG", "JTAG"]
+SW_MODES = ["INIT", "TEST", "WAIT", "SEQUENCE", "SAFE", "SHUTDOWN"]
+AUX_FRAME_CONFIG = 6
+CONFIG_CHUNK_BYTES = 16
+CONFIG_FRAME_LENGTH = 3 + CONFIG_CHUNK_BYTES
+CONFIG_VERSION = 2
+#config_t of Globals.h: calibrationADC, 4 pressure lines, load line, 8 redline limits,
+#3 cross check limits (floats), 5 tare offsets, tare count, version and CRC
+CONFIG_FORMAT = '<' + 'f' * (1 + 2 * 4 + 2 + 2 * 8 + 3) + 'h' * 5 + 'HHH'
+#Tare offsets are in 1/TARE_FRACTION ADC counts, pressures first, then the load cell
+TARE_FRACTION = 16
+CONFIG_BLOCK_LENGTH = struct.calcsize(CONFIG_FORMAT)
+CONFIG_CHUNK_COUNT = (CONFIG_BLOCK_LENGTH + CONFIG_CHUNK_BYTES - 1) // CONFIG_CHUNK_BYTES
+CONFIG_SOURCES = ["EEPROM", "defaults, no stored block", "defaults, stored block corrupted",
+                  "defaults, stored block out of range"]
+AUX_FRAME_ACK = 7
+ACK_FRAME_LENGTH = 6
+ACK_STATUSES = ["OK", "UNKNOWN COMMAND", "REJECTED", "BAD LENGTH", "BUSY"]
+AUX_FRAME_STATISTICS = 8
+STATISTICS_FRAME_LENGTH = 13
+#Mean and standard deviation are in 1/STATISTICS_FRACTION ADC counts
+STATISTICS_FRACTION = 16
+#sensorChannel_t of Globals.h with statistics, name and the conversion of the raw counts
+STATISTICS_CHANNELS = [("NitrogenPressure", lambda raw: readPressure5V(raw, FEEDING_PRESSURE_N2)),
+                       ("LinePressure", lambda raw: readPressure5V(raw, LINE_PRESSURE)),
+                       ("ChamberPressure", lambda raw: readPressure5V(raw, CHAMBER_PRESSURE)),
+                       ("OxidizerPressure", lambda raw: readPressure5V(raw, FEEDING_PRESSURE_OXIDIZER)),
+                       ("LoadCell", readLoad)]
+AUX_FRAME_BURN = 9
+BURN_FRAME_LENGTH = 16
+BURN_FLAGS = ["VALID", "ABORTED", "RESTORED", "NO_THRUST"]
+AUX_FRAME_BURN_EVENT = 10
+BURN_EVENT_FRAME_LENGTH = 11
+BURN_EVENTS = ["Ignition", "Steady state", "Tail-off", "Flame-out"]
+#Time of an event from a command that was not given
+BURN_EVENT_NO_COMMAND = -2**31
+
+#Commands to the Arduino, see commandId_t of Globals.h. Multi-byte values are big-endian
+CMD_PING = 1
+CMD_REQUEST_CONFIG = 2
+CMD_SET_RATES = 3
+CMD_START_VERIFICATION = 4
+CMD_SET_BAUD = 5
+CMD_RESET = 6
+CMD_CONFIG_CHUNK = 7
+CMD_CONFIG_STORE = 8
+CMD_TARE = 9
+COMMAND_NAMES = {CMD_PING: "PING", CMD_REQUEST_CONFIG: "REQUEST_CONFIG", CMD_SET_RATES: "SET_RATES",
+                 CMD_START_VERIFICATION: "START_VERIFICATION", CMD_SET_BAUD: "SET_BAUD", CMD_RESET: "RESET",
+                 CMD_CONFIG_CHUNK: "CONFIG_CHUNK", CMD_CONFIG_STORE: "CONFIG_STORE", CMD_TARE: "TARE"}
+commandSequence = 0
+#Time between commands sent back to back (s)
+COMMAND_INTERVAL = 0.05
+
+def crcCcittUpdate(crc, data):
+    """CRC-16/CCITT step of avr-libc <util/crc16.h>, reflected polynomial 0x8408"""
+    data ^= crc & 0xFF
+    data = (data ^ (data << 4)) & 0xFF
+    return ((data << 8) | (crc >> 8)) ^ (data >> 4) ^ (data << 3)
+
+def applyConfig(block, source):
+    """Take the calibration of the Arduino into use, so the data is converted
+    with exactly the coefficients the firmware checks its limits with"""
+    global calibrationADC, pressureCalibration_K, pressureCalibration_B, loadCellLine_K, loadCellLine_B
+
+    crc = 0xFFFF
+    for byte in block[:-2]:
+        crc = crcCcittUpdate(crc, byte)
+
+    fields = struct.unpack(CONFIG_FORMAT, block)
+    version, blockCrc = fields[-2], fields[-1]
+    if version != CONFIG_VERSION or crc != blockCrc:
+        print(f'Config block rejected: version {version}, CRC {"ok" if crc == blockCrc else "error"}')
+        return
+
+    #A tare moves the zero of a line: value = K * (raw - offset) * volts per count + B
+    calibrationADC = fields[0]
+    tare = fields[30:35]
+    voltsPerCount = calibrationADC * refADC / (maxADC * TARE_FRACTION)
+    pressureCalibration_K = [fields[1 + 2 * i] for i in range(4)]
+    pressureCalibration_B = [fields[2 + 2 * i] - fields[1 + 2 * i] * tare[i] * voltsPerCount for i in range(4)]
+    loadCellLine_K = fields[9]
+    loadCellLine_B = fields[10] - fields[9] * tare[4] * voltsPerCount
+    print(f'Config of the Arduino in use ({CONFIG_SOURCES[source] if source < len(CONFIG_SOURCES) else source}): '
+          f'pressure K {pressureCalibration_K}, B {pressureCalibration_B}, load K {loadCellLine_K}, B {loadCellLine_B}, '
+          f'tares {fields[35]}')
+
+def send_command(ser, command, payload=b''):
+    """Send a command frame [sequence][command][payload][CRC high][CRC low], framed like
+    the data from the Arduino. The leading end marker resynchronizes the receiver.
+    Commands are only received outside SEQUENCE, each one is answered with an AUX_FRAME_ACK"""
+    global commandSequence
+
+    commandSequence = (commandSequence + 1) & 0xFF
+    frame = bytes([commandSequence, command]) + bytes(payload)
+    crc = 0xFFFF
+    for byte in frame:
+        crc = crcCcittUpdate(crc, byte)
+    frame += bytes([crc >> 8, crc & 0xFF])
+
+    stuffed = bytearray([END_MARKER])
+    for byte in frame:
+        if byte == END_MARKER or byte == ESCAPE_BYTE:
+            stuffed += bytes([ESCAPE_BYTE, byte ^ ESCAPE_XOR])
+        else:
+            stuffed.append(byte)
+    stuffed.append(END_MARKER)
+    ser.write(stuffed)
+    return commandSequence
+
+def send_config(ser, block):
+    """Send a config block in the layout of CONFIG_FORMAT and store it to the EEPROM of
+    the Arduino. Taken into use at the next reset. The chunks are paced, since the
+    Arduino parses one command per 20 ms and buffers only 64 received bytes"""
+    block = bytes(block).ljust(CONFIG_CHUNK_COUNT * CONFIG_CHUNK_BYTES, b'\0')
+    for index in range(CONFIG_CHUNK_COUNT):
+        send_command(ser, CMD_CONFIG_CHUNK, bytes([index]) + block[index * CONFIG_CHUNK_BYTES:(index + 1) * CONFIG_CHUNK_BYTES])
+        time.sleep(COMMAND_INTERVAL)
+    send_command(ser, CMD_CONFIG_STORE)
+
 def read_message(ser):
     data = bytearray(20)
     index = 0
@@ -232,7 +378,7 @@ if ser.is_open == True:
     print(f'Serial port {ser.port} is open\n')
     print(ser, '\n')
 
-with open("data.csv", "w", newline='') as file:
+with open("data.csv", "w", newline='') as file, open("statistics.csv", "w", newline='') as statisticsFile:
     writer = csv.writer(file)
     #Header to the csv data file
     writer.writerow(["ArduinoTime", "NitrogenPressure", "LinePressure", "ChamberPressure", "OxidizerPressure",
@@ -241,6 +387,13 @@ with open("data.csv", "w", newline='') as file:
                      "IgnitionButtonStatus", "NitrogenFeedingButtonStatus", "OxidizerValveButtonStatus", 
                      "IgnitionSwState", "ValveSwSstate", "CurrentSwMode", "CurrentSwSubstate", "MessageIndex"])
 
+    #Channel statistics of each reporting interval, ArduinoTime of the last data line before the frame
+    statisticsWriter = csv.writer(statisticsFile)
+    statisticsWriter.writerow(["ArduinoTime", "Channel", "SwMode", "Samples", "Min", "Max", "Mean", "StandardDeviation"])
+
+    #Chunks of the config block received so far
+    configChunks = {}
+
     #Init values that aren't received always
     botTemp = 0
     nozzT = 0
@@ -271,6 +424,9 @@ with open("data.csv", "w", newline='') as file:
 
     ser.reset_input_buffer()
 
+    #Ask for the config block instead of waiting for the next periodic pass
+    send_command(ser, CMD_REQUEST_CONFIG)
+
     while True:
         bufferWait = ser.inWaiting()
         if bufferWait >= maxBufferWait:
@@ -392,3 +548,114 @@ with open("data.csv", "w", newline='') as file:
                              dumpButton, heatButton, igniButton, n2Button, oxButton, ignStatus, valveStatus, 
                              swMode, swSub, msgIndex])
             file.flush()
+
+        elif length == PULSE_FRAME_LENGTH and byteList[0] == AUX_FRAME_PULSE:
+            #Hardware timed pulse edges, times in Arduino micros()
+            channel = PULSE_CHANNELS[byteList[1]] if byteList[1] < len(PULSE_CHANNELS) else byteList[1]
+            flags = byteList[2]
+            riseTime = byteList[3] << 24 | byteList[4] << 16 | byteList[5] << 8 | byteList[6]
+            fallTime = byteList[7] << 24 | byteList[8] << 16 | byteList[9] << 8 | byteList[10]
+
+            edgeText = f'{channel} pulse:'
+            if flags & PULSE_ROSE:
+                edgeText += f' rise {riseTime} us'
+            if flags & PULSE_FELL:
+                edgeText += f' fall {fallTime} us'
+            if flags & PULSE_ROSE and flags & PULSE_FELL:
+                edgeText += f' width {(fallTime - riseTime) & 0xFFFFFFFF} us'
+            if flags & PULSE_CANCELLED:
+                edgeText += f' cancelled at {fallTime} us'
+            print(edgeText)
+
+        elif length == PROFILE_FRAME_LENGTH and byteList[0] == AUX_FRAME_PROFILE:
+            #Loop phase statistics of a -DPROFILE_BUILD firmware, durations in Timer1 ticks
+            phase = PROFILE_PHASES[byteList[1]] if byteList[1] < len(PROFILE_PHASES) else byteList[1]
+            count = byteList[2] << 8 | byteList[3]
+            minTime = (byteList[4] << 8 | byteList[5]) * PROFILE_TICK_US
+            maxTime = (byteList[6] << 8 | byteList[7]) * PROFILE_TICK_US
+            meanTime = (byteList[8] << 8 | byteList[9]) * PROFILE_TICK_US
+            shares = [round(100 * share / 255) for share in byteList[10:10 + PROFILE_HISTOGRAM_BINS]]
+            print(f'{phase} phase: n {count}, min {minTime} us, mean {meanTime} us, max {maxTime} us, histogram % {shares}')
+
+        elif length == TIMING_FRAME_LENGTH and byteList[0] == AUX_FRAME_TIMING:
+            #Sample deadline statistics of senseLoop since the mode was entered
+            mode = SW_MODES[byteList[1]] if byteList[1] < len(SW_MODES) else byteList[1]
+            samples = byteList[2] << 24 | byteList[3] << 16 | byteList[4] << 8 | byteList[5]
+            misses = byteList[6] << 8 | byteList[7]
+            maxLateness = byteList[8] << 8 | byteList[9]
+            shares = [round(100 * share / 255) for share in byteList[10:10 + TIMING_HISTOGRAM_BINS]]
+            print(f'{mode} timing: samples {samples}, deadline misses {misses}, max lateness {maxLateness} us, lateness histogram % {shares}')
+
+        elif length == BOOT_FRAME_LENGTH and byteList[0] == AUX_FRAME_BOOT:
+            #Sent once after a reset of the Arduino
+            causes = [name for i, name in enumerate(RESET_FLAGS) if byteList[1] & (1 << i)] or ["UNKNOWN"]
+            start = "warm" if byteList[2] else "cold"
+            mode = SW_MODES[byteList[3]] if byteList[3] < len(SW_MODES) else byteList[3]
+            warmRestarts = byteList[4] << 8 | byteList[5]
+            watchdogStalls = byteList[7] << 8 | byteList[8]
+            print(f'Arduino reset ({", ".join(causes)}): {start} start in {mode}, warm restarts {warmRestarts}, watchdog stalls {watchdogStalls}')
+            if byteList[6] != NO_STALL:
+                #Task of the executive that was started last when the watchdog expired
+                task = byteList[6] & ~STALL_IN_TASK
+                name = EXECUTIVE_TASKS[task] if task < len(EXECUTIVE_TASKS) else task
+                where = "inside" if byteList[6] & STALL_IN_TASK else "after"
+                print(f'Watchdog stall {where} the {name} task, outputs were forced safe before the reset')
+
+        elif length == EXECUTIVE_FRAME_LENGTH and byteList[0] == AUX_FRAME_EXECUTIVE:
+            #Overrun counts of the cyclic executive since startup
+            mode = SW_MODES[byteList[1]] if byteList[1] < len(SW_MODES) else byteList[1]
+            frameOverruns = byteList[2] << 8 | byteList[3]
+            taskOverruns = {task: byteList[4 + 2 * i] << 8 | byteList[5 + 2 * i] for i, task in enumerate(EXECUTIVE_TASKS)}
+            print(f'{mode} executive: frame overruns {frameOverruns}, task budget overruns {taskOverruns}')
+
+        elif length == TASK_TIMES_FRAME_LENGTH and byteList[0] == AUX_FRAME_TASK_TIMES:
+            #Longest run of each task of the cyclic executive since the mode was entered
+            mode = SW_MODES[byteList[1]] if byteList[1] < len(SW_MODES) else byteList[1]
+            taskTimes = {task: (byteList[2 + 2 * i] << 8 | byteList[3 + 2 * i]) * TASK_TICK_US for i, task in enumerate(EXECUTIVE_TASKS)}
+            print(f'{mode} executive: longest task runs (us) {taskTimes}')
+
+        elif length == CONFIG_FRAME_LENGTH and byteList[0] == AUX_FRAME_CONFIG:
+            #One chunk of the config block, sent after a reset and every 10 s outside SEQUENCE
+            if byteList[1] == 0:
+                configChunks = {}
+            configChunks[byteList[1]] = bytes(byteList[3:3 + CONFIG_CHUNK_BYTES])
+            if len(configChunks) == CONFIG_CHUNK_COUNT:
+                block = b''.join(configChunks[i] for i in range(CONFIG_CHUNK_COUNT))[:CONFIG_BLOCK_LENGTH]
+                configChunks = {}
+                applyConfig(block, byteList[2])
+
+        elif length == ACK_FRAME_LENGTH and byteList[0] == AUX_FRAME_ACK:
+            #Answer of the Arduino to a command
+            command = COMMAND_NAMES.get(byteList[2], byteList[2])
+            status = ACK_STATUSES[byteList[3]] if byteList[3] < len(ACK_STATUSES) else byteList[3]
+            badFrames = byteList[4] << 8 | byteList[5]
+            print(f'Command {byteList[1]} {command}: {status}, bad command frames {badFrames}')
+
+        elif length == STATISTICS_FRAME_LENGTH and byteList[0] == AUX_FRAME_STATISTICS and byteList[1] < len(STATISTICS_CHANNELS):
+            #Statistics of a channel over the interval between two slow samples
+            name, convert = STATISTICS_CHANNELS[byteList[1]]
+            mode = SW_MODES[byteList[2]] if byteList[2] < len(SW_MODES) else byteList[2]
+            samples, minRaw, maxRaw, meanRaw, deviationRaw = (byteList[3 + 2 * i] << 8 | byteList[4 + 2 * i] for i in range(5))
+            #The conversions are linear, the deviation only takes the slope
+            deviation = convert(deviationRaw / STATISTICS_FRACTION) - convert(0)
+            statisticsWriter.writerow([timestamp, name, mode, samples, f'{convert(minRaw):.2f}', f'{convert(maxRaw):.2f}',
+                                       f'{convert(meanRaw / STATISTICS_FRACTION):.2f}', f'{deviation:.3f}'])
+            statisticsFile.flush()
+
+        elif length == BURN_FRAME_LENGTH and byteList[0] == AUX_FRAME_BURN:
+            #Burn metrics integrated on the Arduino, sent after the burn and kept over a reset
+            flags = [name for i, name in enumerate(BURN_FLAGS) if byteList[1] & (1 << i)]
+            impulse = int.from_bytes(bytes(byteList[2:6]), 'big', signed=True) / 10
+            peakThrust, averageThrust, peakPressure = (int.from_bytes(bytes(byteList[6 + 2 * i:8 + 2 * i]), 'big', signed=True) for i in range(3))
+            riseTime = (byteList[12] << 8 | byteList[13]) / 10
+            burnDuration = byteList[14] << 8 | byteList[15]
+            print(f'Burn ({", ".join(flags)}): total impulse {impulse:.1f} Ns, peak thrust {peakThrust} N, average thrust {averageThrust} N, '
+                  f'peak chamber pressure {peakPressure / 100:.2f} bar, rise time {riseTime:.1f} ms, burn duration {burnDuration} ms')
+
+        elif length == BURN_EVENT_FRAME_LENGTH and byteList[0] == AUX_FRAME_BURN_EVENT:
+            #Event of the burn timed on the Arduino from the igniter and main valve commands
+            event = BURN_EVENTS[byteList[1]] if byteList[1] < len(BURN_EVENTS) else byteList[1]
+            channel = STATISTICS_CHANNELS[byteList[2]][0] if byteList[2] < len(STATISTICS_CHANNELS) else byteList[2]
+            sinceIgniter, sinceValve = (int.from_bytes(bytes(byteList[3 + 4 * i:7 + 4 * i]), 'big', signed=True) for i in range(2))
+            valve = '-' if sinceValve == BURN_EVENT_NO_COMMAND else f'{sinceValve / 1000:+.3f} ms'
+            print(f'Burn event {event} ({channel}): igniter {sinceIgniter / 1000:+.3f} ms, main valve {valve}')
@@ -0,0 +1,42 @@
+/* Filename:      Bench.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Cycle count markers for the AVR benchmark in bench/.
+ *                The markers are single OUT instructions to the general
+ *                purpose IO registers, which the simulator watches:
+ *
+ *                GPIOR0: benchMarker_t of a function at its entry, the same
+ *                        with BENCH_EXIT_FLAG at its exit
+ *                GPIOR1: mode_t at the start of every software loop
+ *
+ *                Only compiled in with -DBENCH_BUILD, otherwise the macros
+ *                are empty. Also included by the simulator, so plain C.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+//Measured functions. Keep in sync with benchFunctionNames in bench/bench.c
+typedef enum {
+  BENCH_SENSE_LOOP = 1,       //senseLoop() after the sample period wait
+  BENCH_WRITE_VALUES,         //writeValues(), includes sendByteArray()
+  BENCH_SEND_BYTE_ARRAY,
+  BENCH_CHECK_DATA,
+  BENCH_MARKER_COUNT
+} benchMarker_t;
+
+#define BENCH_EXIT_FLAG 0x80
+
+#ifdef BENCH_BUILD
+#define BENCH_ENTER(marker) (GPIOR0 = (marker))
+#define BENCH_EXIT(marker)  (GPIOR0 = (marker) | BENCH_EXIT_FLAG)
+#define BENCH_LOOP(mode)    (GPIOR1 = (mode))
+#else
+#define BENCH_ENTER(marker) ((void) 0)
+#define BENCH_EXIT(marker)  ((void) 0)
+#define BENCH_LOOP(mode)    ((void) 0)
+#endif
+
+#endif
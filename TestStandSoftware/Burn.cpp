@@ -0,0 +1,262 @@
+/* Filename:      Burn.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Integrates the thrust and follows the chamber pressure while
+ *                the main valve is open, and summarizes the burn: total
+ *                impulse, peak and average thrust, peak chamber pressure,
+ *                pressure rise time and burn duration. The summary is sent
+ *                right after the burn and kept over a reset.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Burn.h"
+#include "Config.h"
+#include "Retained.h"
+
+/* Integration explanation:
+ * The burn is followed in raw readings, a sample costs a multiply, a 64-bit addition and a
+ * few compares. The thrust is integrated as (reading - zero) * ticks since the previous
+ * sample, in 1/burnFraction counts, so uneven sampling is handled and the tare is applied.
+ * For the rise time the first crossing of every 1 << burnLevelShift counts of the chamber
+ * pressure is timed. The 10% and 90% levels of the peak are only known at the end, their
+ * times are interpolated between the crossings around them.
+ * The calibration is converted when SEQUENCE is entered and the summary when the burn ends,
+ * the floats are never used on the samples.
+ * The signed force is integrated, see Globals.h. A burn without a reading above
+ * loadCellBurnThrust, or with an unhealthy load cell, is flagged BURN_NO_THRUST instead of
+ * reporting the integral of a disconnected or drifting load cell as the impulse.
+ */
+
+static burnSummary_t summary;
+static bool summaryPending;
+static uint32_t lastSummaryTime;
+
+//Readings of the load cell in 1/burnFraction counts, converted when SEQUENCE is entered
+static bool levelsReady;
+static int16_t loadZero;          //Reading of 0 N
+static int16_t loadBurnLevel;     //Reading of loadCellBurnThrust above loadZero
+
+//Integration of the running burn
+static bool burning;
+static uint32_t startTick;
+static uint32_t lastTick;
+static int64_t impulseSum;        //1/burnFraction counts * ticks
+static uint16_t peakLoad;
+static bool thrustSeen;
+static bool loadFaulty;           //The load cell was unhealthy during the burn
+static uint32_t thrustStartTick;
+static uint32_t thrustEndTick;
+static uint16_t peakPressure;
+static uint32_t peakPressureTick;
+static uint8_t reachedLevel;
+static uint32_t levelTicks[burnLevelCount];
+
+//Raw ADC counts per volt of the config in use
+static float countsPerVolt(){
+  return maxADC / (getConfig()->calibrationADC * refADC);
+}
+
+//Value of a linearly calibrated sensor to a reading in 1/burnFraction counts
+static int16_t lineToFraction(calibrationLine_t line, float value){
+  float reading = (value - line.B) / line.K * countsPerVolt() * burnFraction;
+  return reading > 32767 ? 32767 : (reading < -32767 ? -32767 : (int16_t) reading);
+}
+
+//Raw reading of a linearly calibrated sensor to its value
+static float rawToLine(calibrationLine_t line, float raw){
+  return line.K * raw / countsPerVolt() + line.B;
+}
+
+static int16_t roundInt16(float value){
+  if (value > 32767){return 32767;}
+  if (value < -32767){return -32767;}
+  return (int16_t) (value < 0 ? value - 0.5f : value + 0.5f);
+}
+
+static uint16_t roundUint16(float value){
+  if (value > 0xFFFF){return 0xFFFF;}
+  if (value < 0){return 0;}
+  return (uint16_t) (value + 0.5f);
+}
+
+static void prepareLevels(){
+  calibrationLine_t load = getCalibration(CH_LOAD_CELL);
+
+  loadZero = lineToFraction(load, 0);
+  loadBurnLevel = lineToFraction(load, getConfig()->loadCellBurnThrust) - loadZero;
+  levelsReady = true;
+}
+
+static void startBurn(const values_t& values){
+  burning = true;
+  startTick = values.hot.tick;
+  lastTick = startTick;
+  impulseSum = 0;
+  peakLoad = values.hot.loadCell;
+  thrustSeen = false;
+  loadFaulty = false;
+  peakPressure = values.hot.combustionPressure;
+  peakPressureTick = startTick;
+  reachedLevel = 0;
+  levelTicks[0] = startTick;
+}
+
+static void integrateBurn(const values_t& values, bool loadHealthy){
+  uint32_t tick = values.hot.tick;
+  uint32_t elapsed = tick - lastTick;
+  lastTick = tick;
+
+  if (!loadHealthy){
+    loadFaulty = true;
+  }
+
+  int16_t force = values.hot.loadCell * burnFraction - loadZero;
+  impulseSum += (int32_t) force * (uint16_t) (elapsed > 0xFFFF ? 0xFFFF : elapsed);
+
+  if (values.hot.loadCell > peakLoad){
+    peakLoad = values.hot.loadCell;
+  }
+  if (force >= loadBurnLevel){
+    if (!thrustSeen){
+      thrustSeen = true;
+      thrustStartTick = tick;
+    }
+    thrustEndTick = tick;
+  }
+
+  uint16_t pressure = values.hot.combustionPressure;
+  if (pressure > peakPressure){
+    peakPressure = pressure;
+    peakPressureTick = tick;
+  }
+  uint8_t level = pressure >> burnLevelShift;
+  while (reachedLevel < level){
+    levelTicks[++reachedLevel] = tick;
+  }
+}
+
+//Ticks from the start until the chamber pressure first reached a raw level at most peakPressure
+static float levelTime(float level){
+  uint8_t index = (uint16_t) level >> burnLevelShift;
+  if (index > reachedLevel){
+    index = reachedLevel;
+  }
+
+  float lowLevel = index << burnLevelShift;
+  float lowTime = levelTicks[index] - startTick;
+  float highLevel = peakPressure;
+  float highTime = peakPressureTick - startTick;
+
+  if (index < reachedLevel){
+    highLevel = (index + 1) << burnLevelShift;
+    highTime = levelTicks[index + 1] - startTick;
+  }
+  if (highLevel <= lowLevel || level <= lowLevel){
+    return lowTime;
+  }
+  return lowTime + (highTime - lowTime) * (level - lowLevel) / (highLevel - lowLevel);
+}
+
+static void finishBurn(bool aborted){
+  burning = false;
+
+  calibrationLine_t load = getCalibration(CH_LOAD_CELL);
+  calibrationLine_t chamber = getCalibration(CH_CHAMBER_PRESSURE);
+  const float secondsPerTick = timebaseTickMicros / 1000000.0f;
+
+  float impulse = impulseSum * (load.K / countsPerVolt() / burnFraction * secondsPerTick);
+  float duration = thrustSeen ? (thrustEndTick - thrustStartTick) * secondsPerTick : 0;
+
+  //Rise from 10% to 90% of the peak above the reading of 0 bar
+  float zero = -chamber.B / chamber.K * countsPerVolt();
+  if (zero < 0){
+    zero = 0;
+  }
+  float span = peakPressure - zero;
+  float riseTicks = 0;
+  if (span > 0){
+    riseTicks = levelTime(zero + 0.9f * span) - levelTime(zero + 0.1f * span);
+  }
+
+  float totalImpulse = impulse * 10;
+  summary.flags = BURN_VALID | (aborted ? BURN_ABORTED : 0);
+  summary.totalImpulse = (int32_t) (totalImpulse < 0 ? totalImpulse - 0.5f : totalImpulse + 0.5f);
+  summary.peakThrust = roundInt16(rawToLine(load, peakLoad));
+  summary.averageThrust = duration > 0 ? roundInt16(impulse / duration) : 0;
+  summary.peakPressure = roundInt16(rawToLine(chamber, peakPressure) * 100);
+  summary.riseTime = roundUint16(riseTicks * timebaseTickMicros / 100);
+  summary.burnDuration = roundUint16(duration * 1000);
+
+  //The chamber pressure metrics are kept, the thrust metrics would only describe the load cell fault
+  if (!thrustSeen || loadFaulty){
+    summary.flags |= BURN_NO_THRUST;
+    summary.totalImpulse = 0;
+    summary.peakThrust = 0;
+    summary.averageThrust = 0;
+    summary.burnDuration = 0;
+  }
+
+  retainBurn(summary);
+  summaryPending = true;
+}
+
+void initBurn(){
+  retainedState_t state;
+  getRetained(&state);
+
+  summary = state.burn;
+  summaryPending = false;
+  if (summary.flags & BURN_VALID){
+    summary.flags |= BURN_RESTORED;
+    summaryPending = true;
+  }
+  lastSummaryTime = 0;
+
+  levelsReady = false;
+  burning = false;
+}
+
+void addBurnSample(const values_t& values, bool loadHealthy, mode_t currentMode, substate_t currentSubstate){
+  if (currentMode != SEQUENCE){
+    //SAFE or the end of the sequence before PURGING, the calibration may change from here on
+    if (burning){
+      finishBurn(true);
+    }
+    levelsReady = false;
+    return;
+  }
+  if (!levelsReady){
+    //Converted in ALL_OFF, before the ignition
+    prepareLevels();
+  }
+
+  if (currentSubstate == VALVE_ON || currentSubstate == IGNIT_OFF || currentSubstate == VALVE_OFF){
+    if (!burning){
+      startBurn(values);
+    }
+    integrateBurn(values, loadHealthy);
+  }else if (burning){
+    finishBurn(false);
+  }
+}
+
+bool getBurnSummary(burnSummary_t* report, mode_t currentMode){
+  if (!(summary.flags & BURN_VALID)){
+    return false;
+  }
+
+  uint32_t now = millis();
+  if (!summaryPending && (currentMode == SEQUENCE || now - lastSummaryTime < burnFrameInterval)){
+    return false;
+  }
+  summaryPending = false;
+  lastSummaryTime = now;
+
+  *report = summary;
+  return true;
+}
@@ -0,0 +1,51 @@
+/* Filename:      Burn.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Burn <<passive>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef BURN_H
+#define BURN_H
+
+/* Function:      Initialize the Burn object. The summary of the last burn is
+ *                restored from the Retained object. Must be called after
+ *                initRetained().
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initBurn(void);
+
+
+/* Function:      Add the latest sample to the burn metrics. The integration
+ *                starts when the sequence enters VALVE_ON and the summary is
+ *                finished when it reaches PURGING or SEQUENCE is left. The
+ *                finished summary is kept over a reset.
+ *
+ * IN:            Reference to a values_t struct with the latest measurements,
+ *                Boolean telling if the load cell is healthy, see SensorHealth.h,
+ *                mode_t current mode,
+ *                substate_t current substate
+ * OUT:           Nothing
+ */
+void addBurnSample(const values_t& values, bool loadHealthy, mode_t currentMode, substate_t currentSubstate);
+
+
+/* Function:      Fetch the summary of the last burn once after it is finished
+ *                or restored, and then every burnFrameInterval ms outside
+ *                SEQUENCE.
+ *
+ * IN:            Pointer to a burnSummary_t struct for the summary,
+ *                mode_t current mode
+ * OUT:           true if the summary was fetched
+ */
+bool getBurnSummary(burnSummary_t* summary, mode_t currentMode);
+
+#endif
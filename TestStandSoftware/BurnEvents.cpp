@@ -0,0 +1,290 @@
+/* Filename:      BurnEvents.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Detects the ignition, steady state, tail-off and flame-out
+ *                of the burn from the chamber pressure and the load cell, and
+ *                times them from the igniter and main valve commands. Gives
+ *                the ignition delay of every run without reading the plots.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+#include "BurnEvents.h"
+#include "Config.h"
+#include "Trend.h"
+
+/* Detection explanation:
+ * Each channel has a comparator with hysteresis on the raw readings. The events follow
+ * each other in a fixed order:
+ * ARMED -> ignition: a channel starts burning and its slope is above the ignition rate.
+ *          The slope check keeps a single spike over the level from passing as an ignition.
+ * BURNING -> steady: the chamber pressure slope stays within +-steady rate. The mean of the
+ *          chamber pressure over that time sets the level of a third comparator.
+ * STEADY -> tail-off: the chamber pressure falls below the tail-off level and is falling.
+ * any of the above -> flame-out: neither channel is burning.
+ * A level crossing is timed by interpolating between the samples on both sides of the level,
+ * the steady state from the sample where the slope entered the band. The times are Timer1
+ * ticks like the sample times, so the resolution is the timebase tick, not the sample period.
+ * The slopes are read from the Trend object, which the FaultDetection object updates with
+ * the prefiltered sample in the CHECK task before this is called in the SEQUENCE task.
+ */
+
+typedef enum{
+  DETECT_IDLE,        //Waiting for the igniter command
+  DETECT_ARMED,       //Waiting for the ignition
+  DETECT_BURNING,     //Waiting for the steady state or the tail-off
+  DETECT_STEADY,      //Waiting for the tail-off
+  DETECT_TAIL_OFF     //Waiting for the flame-out
+}detectState_t;
+
+//Burn level comparator of a channel, the levels are raw readings
+struct burnChannel_t {
+  sensorChannel_t channel;
+  int16_t onLevel;
+  int16_t offLevel;
+  int16_t riseRate;       //Q8 counts/ms, see lineRateToRaw()
+  bool burning;
+  bool crossed;           //Burning has changed since the igniter command
+  uint32_t crossTick;     //Interpolated tick of the last change of burning
+  int16_t lastValue;
+};
+
+static const uint8_t CHAMBER = 0;
+static const uint8_t LOAD = 1;
+static burnChannel_t channels[2];
+
+//Chamber pressure comparator of the tail-off, set at the steady state
+static burnChannel_t tailOff;
+
+static const uint32_t steadyTicks = burnEventSteadyTime * 1000UL / timebaseTickMicros;
+
+static detectState_t state;
+static bool firstSample;
+static uint32_t lastTick;
+static int16_t steadyRate;
+static int16_t tailOffRate;
+static int16_t chamberZero;         //Raw reading of 0 bar
+static int16_t tailOffHysteresis;
+
+//Tick where the slope entered the steady band and the sum of the chamber pressure since, valid while holding
+static bool steadyHolding;
+static uint32_t steadyStartTick;
+static int32_t steadySum;
+static uint16_t steadySamples;
+
+static uint32_t commandTicks[BURN_COMMAND_VALVE + 1];
+static bool commandGiven[BURN_COMMAND_VALVE + 1];
+
+//Ring buffer of the events not fetched yet
+static burnEvent_t queue[burnEventQueueLength];
+static uint8_t queueFirst;
+static uint8_t queueCount;
+
+//Converted from the calibration and limits of the config when the igniter is commanded
+static void prepareLevels(){
+  const config_t* config = getConfig();
+  calibrationLine_t chamber = getCalibration(CH_CHAMBER_PRESSURE);
+  calibrationLine_t load = getCalibration(CH_LOAD_CELL);
+
+  channels[CHAMBER].channel = CH_CHAMBER_PRESSURE;
+  channels[CHAMBER].onLevel = lineToADC(chamber, config->calibrationADC, config->chamberBurnPressure);
+  channels[CHAMBER].offLevel = lineToADC(chamber, config->calibrationADC, config->chamberBurnPressure - burnEventPressureHysteresis);
+  channels[CHAMBER].riseRate = lineRateToRaw(chamber, config->calibrationADC, burnEventIgnitionRate);
+
+  channels[LOAD].channel = CH_LOAD_CELL;
+  channels[LOAD].onLevel = lineToADC(load, config->calibrationADC, config->loadCellBurnThrust);
+  channels[LOAD].offLevel = lineToADC(load, config->calibrationADC, config->loadCellBurnThrust - burnEventThrustHysteresis);
+  channels[LOAD].riseRate = lineRateToRaw(load, config->calibrationADC, burnEventThrustRate);
+
+  steadyRate = lineRateToRaw(chamber, config->calibrationADC, burnEventSteadyRate);
+  tailOffRate = lineRateToRaw(chamber, config->calibrationADC, burnEventTailOffRate);
+  chamberZero = lineToADC(chamber, config->calibrationADC, 0);
+  tailOffHysteresis = lineDeltaToADC(chamber, config->calibrationADC, burnEventPressureHysteresis);
+  tailOff.channel = CH_CHAMBER_PRESSURE;
+}
+
+static int32_t ticksSince(burnCommand_t command, uint32_t tick){
+  if (!commandGiven[command]){
+    return burnEventNoCommand;
+  }
+  return (int32_t) (tick - commandTicks[command]) * timebaseTickMicros;
+}
+
+static void addEvent(burnEventType_t type, sensorChannel_t channel, uint32_t tick){
+  if (queueCount == burnEventQueueLength){
+    queueFirst = (queueFirst + 1) % burnEventQueueLength;
+    queueCount--;
+  }
+
+  burnEvent_t* event = &queue[(queueFirst + queueCount) % burnEventQueueLength];
+  event->type = type;
+  event->channel = channel;
+  event->sinceIgniter = ticksSince(BURN_COMMAND_IGNITER, tick);
+  event->sinceValve = ticksSince(BURN_COMMAND_VALVE, tick);
+  queueCount++;
+}
+
+//Update the comparator of a channel with the newest reading
+static void updateChannel(burnChannel_t* channel, int16_t value, uint32_t tick){
+  int16_t level = channel->burning ? channel->offLevel : channel->onLevel;
+  bool changed = channel->burning ? value < level : value > level;
+
+  if (changed){
+    //Tick where the line between the two samples crosses the level. A comparator started
+    //on the wrong side of its level changes without a step, timed at the newest sample
+    uint32_t elapsed = tick - lastTick;
+    if (elapsed > 0xFFFF){
+      elapsed = 0xFFFF;
+    }
+    if (value == channel->lastValue){
+      channel->crossTick = tick;
+    }else{
+      channel->crossTick = tick - elapsed + (int32_t) elapsed * (level - channel->lastValue) / (value - channel->lastValue);
+    }
+    channel->burning = !channel->burning;
+    channel->crossed = true;
+  }
+  channel->lastValue = value;
+}
+
+//Set the tail-off level from the mean of the steady state chamber pressure
+//A chamber pressure already below the level counts as crossed at the newest sample
+static void startTailOff(int16_t chamber, uint32_t tick){
+  int16_t steady = steadySum / steadySamples;
+  int16_t level = chamberZero + (int32_t) (steady - chamberZero) * burnEventTailOffPercent / 100;
+
+  tailOff.offLevel = level;
+  tailOff.onLevel = level + tailOffHysteresis;
+  tailOff.burning = chamber > tailOff.offLevel;
+  tailOff.crossed = !tailOff.burning;
+  tailOff.crossTick = tick;
+  tailOff.lastValue = chamber;
+}
+
+//Follow the chamber pressure slope in the steady band, true once it has stayed there for steadyTicks
+static bool steadyReached(int16_t chamber, uint32_t tick){
+  if (slopeAbove(CH_CHAMBER_PRESSURE, steadyRate) || slopeBelow(CH_CHAMBER_PRESSURE, -steadyRate)){
+    steadyHolding = false;
+    return false;
+  }
+  if (!steadyHolding){
+    steadyHolding = true;
+    steadyStartTick = tick;
+    steadySum = 0;
+    steadySamples = 0;
+  }
+  if (steadySamples < 0xFFFF){
+    steadySum += chamber;
+    steadySamples++;
+  }
+  return tick - steadyStartTick >= steadyTicks;
+}
+
+void initBurnEvents(){
+  state = DETECT_IDLE;
+  commandGiven[BURN_COMMAND_IGNITER] = false;
+  commandGiven[BURN_COMMAND_VALVE] = false;
+  queueFirst = 0;
+  queueCount = 0;
+}
+
+void addBurnCommand(burnCommand_t command, uint32_t tick){
+  if (command == BURN_COMMAND_IGNITER){
+    prepareLevels();
+    state = DETECT_ARMED;
+    firstSample = true;
+    commandGiven[BURN_COMMAND_VALVE] = false;
+  }else if (state == DETECT_IDLE){
+    return;
+  }
+
+  commandTicks[command] = tick;
+  commandGiven[command] = true;
+}
+
+void addBurnEventSample(const values_t& values, mode_t currentMode){
+  if (state == DETECT_IDLE){
+    return;
+  }
+  if (currentMode == WAIT || currentMode == TEST){
+    //The sequence ended without a flame-out
+    state = DETECT_IDLE;
+    return;
+  }
+
+  uint32_t tick = values.hot.tick;
+  int16_t chamber = values.hot.combustionPressure;
+  int16_t load = values.hot.loadCell;
+
+  if (firstSample){
+    //A channel already over its level at the igniter command has to fall below it first
+    firstSample = false;
+    channels[CHAMBER].burning = chamber > channels[CHAMBER].onLevel;
+    channels[CHAMBER].crossed = false;
+    channels[CHAMBER].lastValue = chamber;
+    channels[LOAD].burning = load > channels[LOAD].onLevel;
+    channels[LOAD].crossed = false;
+    channels[LOAD].lastValue = load;
+    lastTick = tick;
+    return;
+  }
+
+  updateChannel(&channels[CHAMBER], chamber, tick);
+  updateChannel(&channels[LOAD], load, tick);
+  if (state == DETECT_STEADY){
+    updateChannel(&tailOff, chamber, tick);
+  }
+  lastTick = tick;
+
+  if (state == DETECT_ARMED){
+    //The channel may have started burning before its slope caught up, the crossing is kept
+    for (uint8_t i = CHAMBER; i <= LOAD; i++){
+      if (channels[i].burning && channels[i].crossed && slopeAbove(channels[i].channel, channels[i].riseRate)){
+        addEvent(BURN_EVENT_IGNITION, channels[i].channel, channels[i].crossTick);
+        state = DETECT_BURNING;
+        steadyHolding = false;
+        break;
+      }
+    }
+    return;
+  }
+
+  if (!channels[CHAMBER].burning && !channels[LOAD].burning){
+    //Timed by the channel that stopped burning last
+    uint8_t last = CHAMBER;
+    if (channels[LOAD].crossed && (!channels[CHAMBER].crossed || (int32_t) (channels[LOAD].crossTick - channels[CHAMBER].crossTick) > 0)){
+      last = LOAD;
+    }
+    addEvent(BURN_EVENT_FLAME_OUT, channels[last].channel, channels[last].crossTick);
+    state = DETECT_IDLE;
+    return;
+  }
+
+  if (state == DETECT_BURNING){
+    if (steadyReached(chamber, tick)){
+      addEvent(BURN_EVENT_STEADY, CH_CHAMBER_PRESSURE, steadyStartTick);
+      startTailOff(chamber, tick);
+      state = DETECT_STEADY;
+    }
+  }else if (state == DETECT_STEADY){
+    //The tail-off level may be crossed before the slope falls fast enough, the crossing is kept
+    if (!tailOff.burning && tailOff.crossed && slopeBelow(CH_CHAMBER_PRESSURE, -tailOffRate)){
+      addEvent(BURN_EVENT_TAIL_OFF, CH_CHAMBER_PRESSURE, tailOff.crossTick);
+      state = DETECT_TAIL_OFF;
+    }
+  }
+}
+
+bool getBurnEvent(burnEvent_t* event){
+  if (queueCount == 0){
+    return false;
+  }
+
+  *event = queue[queueFirst];
+  queueFirst = (queueFirst + 1) % burnEventQueueLength;
+  queueCount--;
+  return true;
+}
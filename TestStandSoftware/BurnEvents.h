@@ -0,0 +1,57 @@
+/* Filename:      BurnEvents.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the BurnEvents <<passive>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef BURNEVENTS_H
+#define BURNEVENTS_H
+
+/* Function:      Initialize the BurnEvents object. The detector waits for
+ *                the igniter command.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initBurnEvents(void);
+
+
+/* Function:      Record the time of an actuator command. The igniter command
+ *                arms the detector and converts the burn levels and rates
+ *                from the config. The valve command is only recorded after it.
+ *
+ * IN:            burnCommand_t command that was given,
+ *                uint32_t Timer1 tick of the command
+ * OUT:           Nothing
+ */
+void addBurnCommand(burnCommand_t command, uint32_t tick);
+
+
+/* Function:      Add the latest sample to the event detector. Must be called
+ *                after the Trend object was updated with the same sample.
+ *                The detector stops after the flame-out or when WAIT or TEST
+ *                is entered. Constant time, integer only apart from the
+ *                division of an interpolated event time.
+ *
+ * IN:            Reference to a values_t struct with the latest measurements,
+ *                mode_t current mode
+ * OUT:           Nothing
+ */
+void addBurnEventSample(const values_t& values, mode_t currentMode);
+
+
+/* Function:      Fetch the oldest detected event not fetched yet.
+ *
+ * IN:            Pointer to a burnEvent_t struct for the event
+ * OUT:           true if an event was fetched
+ */
+bool getBurnEvent(burnEvent_t* event);
+
+#endif
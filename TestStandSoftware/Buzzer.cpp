@@ -5,15 +5,17 @@
  *
  * Purpose:       Controls a buzzer that is used to indicate a restart of the 
  *                system as well as act as a warning if any of the sensor values 
- *                go outside set limits.
+ *                go outside set limits. The buzzer patterns are played from
+ *                a timer interrupt.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 //#include <Arduino_FreeRTOS.h>
 //#include <semphr.h>
 #include <stdint.h>
 
 #include "Globals.h"
+#include "Gpio.h"
 #include "Buzzer.h"
 
 /* First version of the Test Bench utilizes one of the valve driver mosfets (pin 4) to drive the 
@@ -22,83 +24,148 @@
  * version should have more Mosfets and relays for improved controllability.
  */
 
-//static SemaphoreHandle_t buzzerSemaphore;
-static uint32_t buzzerStartTime;
+/* Pattern explanation:
+ * The patterns of buzzerTiming_t are played by the Timer1 compare unit C interrupt, so
+ * they keep running in SEQUENCE and cost nothing in the loop. Timer1 is started by the
+ * Timebase object. Every ON and OFF time is given to the compare unit in steps of at most
+ * buzzerMaxStep ticks, as the 16-bit timer wraps every 262ms. Only the interrupt of the
+ * last step of a time switches the pin. The OC1C pin is not connected.
+ */
 
-//Current version does not support buzzer patterns
-//static int16_t buzzerPatternIndex;
-//static int16_t buzzerCycleCount;
-//static int16_t* currentPattern;
-//static int16_t patternLength;
-//static buzzerPattern_t currentPatternName;
-//static buzzerTiming_t buzzerTimings;
+static const buzzerTiming_t buzzerTimings = buzzerTiming_t();
 
-static bool timedSequence;
+static const int16_t* volatile patternTimes;    //ON and OFF times (ms) of the current pattern
+static volatile uint8_t patternLength;
+static volatile uint8_t patternIndex;
+static volatile int16_t cyclesLeft;             //0 = indefinite
+static volatile uint32_t remainingTicks;        //Ticks of the current time not yet given to the compare unit
+static volatile buzzerPattern_t currentPattern;
 
 void initBuzzer(){
   pinMode(BUZZER_CONTROL_PIN, OUTPUT);
-  
-  //Turn Buzzer ON when software starts, turns off after ~1 second.
-  digitalWrite(BUZZER_CONTROL_PIN, HIGH);
+  fastWrite<BUZZER_CONTROL_PIN>(LOW);
+
+  TIMSK1 &= ~(1 << OCIE1C);
+  currentPattern = BUZZER_OFF;
+  patternTimes = NULL;
+  patternLength = 0;
+  patternIndex = 0;
+  cyclesLeft = 0;
+  remainingTicks = 0;
+}
 
-  timedSequence = true;
-  buzzerStartTime = millis();
+//Give the next part of the current time to the compare unit. Interrupts must be disabled
+static void scheduleBuzzer(){
+  uint32_t step = remainingTicks;
+  if (step > buzzerMaxStep){
+    step = buzzerMaxStep;
+  }
 
-  //buzzerSemaphore = xSemaphoreCreateMutex();
+  remainingTicks -= step;
+  OCR1C = OCR1C + (uint16_t) step;
 }
 
+//Stop the pattern and turn the buzzer off. Interrupts must be disabled
+static void stopPattern(){
+  TIMSK1 &= ~(1 << OCIE1C);
+  fastWrite<BUZZER_CONTROL_PIN>(LOW);
+  currentPattern = BUZZER_OFF;
+}
 
-void setBuzzer(bool state){
-  //digitalWrite(BUZZER_CONTROL_PIN, state);
-  if (state == true){PORTD |=  (1 << BUZZER_CONTROL_PIN_PORTD);}
-  else              {PORTD &= ~(1 << BUZZER_CONTROL_PIN_PORTD);}
+ISR(TIMER1_COMPC_vect){
+  if (remainingTicks > 0){
+    scheduleBuzzer();
+    return;
+  }
 
-}
+  patternIndex++;
+  if (patternIndex == patternLength){
+    patternIndex = 0;
 
-void updateBuzzer(){
-  /*
-  if (currentPatternName != BUZZER_OFF){
-    ;
-  }*/
-  if (timedSequence == true){
-    if (millis() - buzzerStartTime >= buzzerOnTime){
-      setBuzzer(false);
-      timedSequence = false;
+    if (cyclesLeft != 0 && --cyclesLeft == 0){
+      stopPattern();
+      return;
     }
   }
+
+  //Even indexes are ON times, odd ones OFF times
+  fastWrite<BUZZER_CONTROL_PIN>((patternIndex & 1) == 0);
+  remainingTicks = (uint32_t) patternTimes[patternIndex] * (1000 / timebaseTickMicros);
+  scheduleBuzzer();
 }
 
-//Current version does not support buzzer patterns
+void setBuzzer(bool state){
+  uint8_t oldSREG = SREG;
+  cli();
 
-/*
-void startBuzzerPattern(buzzerPattern_t newPattern){
-  currentPatternName = newPattern;
+  //Direct control overrides a playing pattern
+  stopPattern();
+  fastWrite<BUZZER_CONTROL_PIN>(state);
 
-  if (currentPatternName == BUZZER_OFF){
-    setBuzzer(false);
-    return;
-  }
-  
-  buzzerStartTime = millis();
+  SREG = oldSREG;
+}
 
-  buzzerPatternIndex = 1;
-  buzzerCycleCount = 0;
+void startBuzzerPattern(buzzerPattern_t newPattern){
+  const int16_t* times;
+  uint8_t length;
 
   switch (newPattern){
     case BUZZER_WARNING:
-      currentPattern = &buzzerTimings.warning
-      patternLength = sizeof(buzzerTimings.warning/sizeof(buzzerTimings.warning[0]) - 1;
+      times = buzzerTimings.warning;
+      length = sizeof(buzzerTimings.warning) / sizeof(buzzerTimings.warning[0]);
       break;
 
     case BUZZER_RESET:
-      currentPattern = &buzzerTimings.reset
-      patternLength = sizeof(buzzerTimings.reset/sizeof(buzzerTimings.reset[0]) - 1;
+      times = buzzerTimings.reset;
+      length = sizeof(buzzerTimings.reset) / sizeof(buzzerTimings.reset[0]);
       break;
 
     case BUZZER_TEST:
-      currentPattern = &buzzerTimings.test
-      patternLength = sizeof(buzzerTimings.test/sizeof(buzzerTimings.test[0]) - 1;
+      times = buzzerTimings.test;
+      length = sizeof(buzzerTimings.test) / sizeof(buzzerTimings.test[0]);
+      break;
+
+    case BUZZER_TARE_DONE:
+      times = buzzerTimings.tareDone;
+      length = sizeof(buzzerTimings.tareDone) / sizeof(buzzerTimings.tareDone[0]);
+      break;
+
+    case BUZZER_TARE_FAILED:
+      times = buzzerTimings.tareFailed;
+      length = sizeof(buzzerTimings.tareFailed) / sizeof(buzzerTimings.tareFailed[0]);
+      break;
+
+    default:
+      times = NULL;
+      length = 0;
       break;
   }
+
+  uint8_t oldSREG = SREG;
+  cli();
+
+  stopPattern();
+
+  //The first index is the cycle count, a pattern needs at least one ON time
+  if (length > 1){
+    currentPattern = newPattern;
+    cyclesLeft = times[0];
+    patternTimes = times + 1;
+    patternLength = length - 1;
+    patternIndex = 0;
+
+    fastWrite<BUZZER_CONTROL_PIN>(HIGH);
+    remainingTicks = (uint32_t) patternTimes[0] * (1000 / timebaseTickMicros);
+    OCR1C = TCNT1;
+    scheduleBuzzer();
+
+    TIFR1 = (1 << OCF1C);   //Cleared by writing one
+    TIMSK1 |= (1 << OCIE1C);
+  }
+
+  SREG = oldSREG;
+}
+
+buzzerPattern_t getBuzzerPattern(){
+  return currentPattern;
 }
-*/
\ No newline at end of file
@@ -13,14 +13,15 @@
  #ifndef BUZZER_H
  #define BUZZER_H
 
-/* Function:      Initialize the pins used to control the buzzer.     
+/* Function:      Initialize the pins used to control the buzzer. The buzzer
+ *                starts off, Timer1 must be running.
  *
  * IN:            Nothing
  * OUT:           Nothing
  */
 void initBuzzer(void);
 
-/* Function:      Set buzzer to a desired state
+/* Function:      Set buzzer to a desired state. Stops a playing pattern.
  *
  * IN:            State to set the buzzer to: true = ON, false = OFF
  * OUT:           Nothing
@@ -28,19 +29,23 @@ void initBuzzer(void);
 void setBuzzer(bool state);
 
 
-/* Function:      Update the buzzer based on current timing(/pattern)
+/* Function:      Start playing a desired pattern with the buzzer. Replaces
+ *                the pattern being played, BUZZER_OFF stops it. The pattern
+ *                is played by the Timer1 compare C interrupt, no updates are
+ *                needed from the loop.
  *
- * IN:            Nothing
+ * IN:            New pattern to be played
  * OUT:           Nothing
  */
-void updateBuzzer(void);
+void startBuzzerPattern(buzzerPattern_t newPattern);
 
 
-/* Function:      Start playing a desired pattern with the buzzer
+/* Function:      Get the pattern being played. Patterns with a cycle count
+ *                return to BUZZER_OFF when they finish.
  *
- * IN:            New pattern to be played
- * OUT:           Nothing
+ * IN:            Nothing
+ * OUT:           buzzerPattern_t being played
  */
-//void startBuzzerPattern(buzzerPattern_t newPattern)
+buzzerPattern_t getBuzzerPattern(void);
 
 #endif
\ No newline at end of file
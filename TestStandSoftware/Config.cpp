@@ -0,0 +1,317 @@
+/* Filename:      Config.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Keeps the calibration of the sensors and the limits of the
+ *                redlines and cross checks in a versioned, CRC protected block
+ *                of the EEPROM, so a sensor swap doesn't need a reflash. The
+ *                block is read once at startup into RAM and sent to the Rock,
+ *                which converts the data with the same coefficients.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include "Globals.h"
+#include "Config.h"
+
+/* Config explanation:
+ * The block is only read in initConfig(). The objects using it convert their limits to
+ * raw values in their own initialization, so the checks on the hot path stay integer
+ * compares of constants in RAM, like with the compiled limits before.
+ * An erased EEPROM reads 0xFF and fails the version check, the compiled defaults of
+ * Globals.h are used until a block is stored.
+ * A block is only taken into use if every float of it is finite, no calibration line is
+ * flat and every limit is within the range of its sensor. A limit outside the range would
+ * be clamped to the rail of the ADC when converted, and a NaN never trips. A block of the
+ * Rock failing the check is rejected, a stored one is replaced by the compiled defaults.
+ * A new block is received from the Rock in chunks and written one byte per call of
+ * continueConfigStore(), since waiting for the whole write would trip the watchdog.
+ * A reset in the middle of the write leaves a block that fails the CRC check.
+ * A tare changes the block in use right away. Its offsets are folded into the calibration
+ * lines by getCalibration(), so the limits converted from them move with the zero and the
+ * samples are sent and checked raw, without a correction per sample.
+ */
+
+static_assert(offsetof(config_t, crc) + sizeof(uint16_t) == sizeof(config_t), "config_t has padding");
+
+static config_t storedConfig EEMEM;
+
+static config_t config;
+static configSource_t source;
+
+static uint8_t nextChunk;
+static uint32_t lastPassTime;
+
+//Block received from the Rock, and the bytes of it already written
+static config_t pendingConfig;
+static uint16_t receivedChunks;   //Bit of each received chunk
+static uint8_t storedBytes;       //sizeof(config_t) when no block is being stored
+
+static_assert(configChunkCount <= 16, "receivedChunks has a bit per chunk");
+
+static uint16_t configCrc(const config_t* block){
+  const uint8_t* bytes = (const uint8_t*) block;
+  uint16_t crc = 0xFFFF;
+
+  for (uint8_t i = 0; i < offsetof(config_t, crc); i++){
+    crc = _crc_ccitt_update(crc, bytes[i]);
+  }
+
+  return crc;
+}
+
+static void loadDefaults(){
+  config.calibrationADC = calibrationADC;
+  for (uint8_t i = 0; i < pressureCount5V; i++){
+    config.pressure[i] = pressureCalibration[i];
+  }
+  config.load = loadCellCalibration;
+  for (uint8_t i = 0; i < REDLINE_COUNT; i++){
+    config.redlines[i] = defaultRedlineLimits[i];
+  }
+  config.lineFeedTolerance = lineFeedPressureTolerance;
+  config.chamberBurnPressure = chamberBurnPressure;
+  config.loadCellBurnThrust = loadCellBurnThrust;
+  for (uint8_t i = 0; i < tareChannelCount; i++){
+    config.tare[i] = 0;
+  }
+  config.tareCount = 0;
+  config.version = configVersion;
+  config.crc = configCrc(&config);
+}
+
+//A reading higher by the offset gives the same value. Value = K * (raw - offset) * volts per count + B
+static calibrationLine_t taredLine(const config_t* block, calibrationLine_t line, uint8_t tareChannel){
+  line.B -= line.K * block->tare[tareChannel] * block->calibrationADC * refADC / ((float) maxADC * tareFraction);
+  return line;
+}
+
+static calibrationLine_t blockCalibration(const config_t* block, sensorChannel_t channel){
+  switch (channel){
+    case CH_N2_FEEDING_PRESSURE:  return taredLine(block, block->pressure[FEEDING_PRESSURE_N2], FEEDING_PRESSURE_N2);
+    case CH_LINE_PRESSURE:        return taredLine(block, block->pressure[LINE_PRESSURE], LINE_PRESSURE);
+    case CH_CHAMBER_PRESSURE:     return taredLine(block, block->pressure[CHAMBER_PRESSURE], CHAMBER_PRESSURE);
+    case CH_N2O_FEEDING_PRESSURE: return taredLine(block, block->pressure[FEEDING_PRESSURE_OXIDIZER], FEEDING_PRESSURE_OXIDIZER);
+    case CH_LOAD_CELL:            return taredLine(block, block->load, TARE_LOAD_CELL);
+    default:                      return {1, 0};
+  }
+}
+
+//Raw value of a value of a channel with the calibration of a block, not limited to the range of the ADC
+static float blockToRaw(const config_t* block, sensorChannel_t channel, float value, bool difference){
+  calibrationLine_t line = blockCalibration(block, channel);
+  if (difference){
+    line.B = 0;
+  }
+  return (value - line.B) / line.K / (block->calibrationADC * refADC) * maxADC;
+}
+
+//The comparisons are false for a NaN, so a value that isn't finite is out of range as well
+static bool levelInRange(const config_t* block, sensorChannel_t channel, float value){
+  float raw = blockToRaw(block, channel, value, false);
+  return raw >= 0 && raw <= maxADC;
+}
+
+static bool deltaInRange(const config_t* block, sensorChannel_t channel, float delta){
+  float raw = blockToRaw(block, channel, delta, true);
+  return raw >= 0 && raw <= maxADC;
+}
+
+//Rate limits have to fit lineRateToRaw() without clamping
+static bool rateInRange(const config_t* block, sensorChannel_t channel, float rate){
+  float raw = blockToRaw(block, channel, rate / 1000, true) * 256;
+  return raw >= -32767 && raw <= 32767;
+}
+
+static bool lineValid(calibrationLine_t line){
+  return isfinite(line.K) && isfinite(line.B) && line.K != 0;
+}
+
+static bool redlineLimitValid(const config_t* block, uint8_t index){
+  const redlineInput_t* input = &redlineInputs[index];
+  const redlineLimit_t* limit = &block->redlines[index];
+
+  if (input->channel == CH_NOZZLE_TEMPERATURE || input->channel == CH_PIPING_TEMPERATURE){
+    return limit->threshold >= thermocoupleMinTemperature && limit->threshold <= thermocoupleMaxTemperature
+           && limit->hysteresis >= 0 && limit->hysteresis <= thermocoupleMaxTemperature - thermocoupleMinTemperature;
+  }
+  if (input->rate){
+    return rateInRange(block, input->channel, limit->threshold) && limit->hysteresis >= 0
+           && rateInRange(block, input->channel, limit->hysteresis);
+  }
+  return levelInRange(block, input->channel, limit->threshold) && deltaInRange(block, input->channel, limit->hysteresis);
+}
+
+//Check every float of a block before it is taken into use
+static bool configValid(const config_t* block){
+  if (!isfinite(block->calibrationADC) || block->calibrationADC <= 0){
+    return false;
+  }
+  for (uint8_t i = 0; i < pressureCount5V; i++){
+    if (!lineValid(block->pressure[i])){
+      return false;
+    }
+  }
+  if (!lineValid(block->load)){
+    return false;
+  }
+
+  for (uint8_t i = 0; i < REDLINE_COUNT; i++){
+    if (!redlineLimitValid(block, i)){
+      return false;
+    }
+  }
+
+  return deltaInRange(block, CH_LINE_PRESSURE, block->lineFeedTolerance)
+         && levelInRange(block, CH_CHAMBER_PRESSURE, block->chamberBurnPressure)
+         && levelInRange(block, CH_LOAD_CELL, block->loadCellBurnThrust);
+}
+
+void initConfig(){
+  eeprom_read_block(&config, &storedConfig, sizeof(config_t));
+
+  if (config.version != configVersion){
+    source = CONFIG_DEFAULT_VERSION;
+    loadDefaults();
+  }else if (config.crc != configCrc(&config)){
+    source = CONFIG_DEFAULT_CRC;
+    loadDefaults();
+  }else if (!configValid(&config)){
+    source = CONFIG_DEFAULT_RANGE;
+    loadDefaults();
+  }else{
+    source = CONFIG_STORED;
+  }
+
+  nextChunk = 0;
+  lastPassTime = 0;
+
+  receivedChunks = 0;
+  storedBytes = sizeof(config_t);
+}
+
+const config_t* getConfig(){
+  return &config;
+}
+
+configSource_t getConfigSource(){
+  return source;
+}
+
+calibrationLine_t getCalibration(sensorChannel_t channel){
+  return blockCalibration(&config, channel);
+}
+
+ackStatus_t receiveConfigChunk(uint8_t index, const uint8_t* bytes){
+  if (storedBytes < sizeof(config_t)){
+    return ACK_BUSY;
+  }
+  if (index >= configChunkCount){
+    return ACK_REJECTED;
+  }
+
+  uint8_t* block = (uint8_t*) &pendingConfig;
+  uint8_t offset = index * configChunkBytes;
+
+  for (uint8_t i = 0; i < configChunkBytes && offset + i < sizeof(config_t); i++){
+    block[offset + i] = bytes[i];
+  }
+  receivedChunks |= 1 << index;
+
+  return ACK_OK;
+}
+
+ackStatus_t storeReceivedConfig(){
+  if (storedBytes < sizeof(config_t)){
+    return ACK_BUSY;
+  }
+  if (receivedChunks != (1 << configChunkCount) - 1){
+    return ACK_REJECTED;
+  }
+  if (!configValid(&pendingConfig)){
+    //The chunks have to be sent again
+    receivedChunks = 0;
+    return ACK_REJECTED;
+  }
+
+  pendingConfig.version = configVersion;
+  pendingConfig.crc = configCrc(&pendingConfig);
+  receivedChunks = 0;
+  storedBytes = 0;
+
+  return ACK_OK;
+}
+
+void continueConfigStore(){
+  if (storedBytes >= sizeof(config_t) || !eeprom_is_ready()){
+    return;
+  }
+
+  //Unchanged bytes are only read, eeprom_update_byte() doesn't wait for the write to finish
+  eeprom_update_byte((uint8_t*) &storedConfig + storedBytes, ((uint8_t*) &pendingConfig)[storedBytes]);
+  storedBytes++;
+}
+
+bool setTare(const int16_t* offsets){
+  if (storedBytes < sizeof(config_t)){
+    return false;
+  }
+
+  for (uint8_t i = 0; i < tareChannelCount; i++){
+    config.tare[i] = offsets[i];
+  }
+  if (config.tareCount < UINT16_MAX){
+    config.tareCount++;
+  }
+  config.version = configVersion;
+  config.crc = configCrc(&config);
+
+  //The block in use is written as a whole, and sent to the Rock right away
+  pendingConfig = config;
+  storedBytes = 0;
+  nextChunk = 0;
+
+  return true;
+}
+
+bool isConfigStoring(){
+  return storedBytes < sizeof(config_t);
+}
+
+void requestConfig(){
+  nextChunk = 0;
+}
+
+bool getConfigChunk(configChunk_t* chunk, mode_t currentMode){
+  uint32_t now = millis();
+
+  if (nextChunk >= configChunkCount){
+    if (now - lastPassTime < configFrameInterval){
+      return false;
+    }
+    nextChunk = 0;
+  }
+  //A pass is held back during the burn and continued after it
+  if (currentMode == SEQUENCE){
+    return false;
+  }
+  if (nextChunk == 0){
+    lastPassTime = now;
+  }
+
+  const uint8_t* bytes = (const uint8_t*) &config;
+  uint8_t offset = nextChunk * configChunkBytes;
+
+  chunk->index = nextChunk;
+  chunk->source = source;
+  for (uint8_t i = 0; i < configChunkBytes; i++){
+    chunk->bytes[i] = (offset + i < sizeof(config_t)) ? bytes[offset + i] : 0;
+  }
+  nextChunk++;
+
+  return true;
+}
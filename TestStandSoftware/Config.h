@@ -0,0 +1,130 @@
+/* Filename:      Config.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Config <<passive>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+/* Function:      Initialize the Config object. Reads the config block from the
+ *                EEPROM and falls back to the compiled defaults if its version
+ *                or CRC doesn't match or a value is out of range. Must be
+ *                called before the objects that convert their limits from the
+ *                config.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initConfig(void);
+
+
+/* Function:      Get the config in use. Read once at startup, only a tare
+ *                changes it before the next reset.
+ *
+ * IN:            Nothing
+ * OUT:           Pointer to the config_t in use
+ */
+const config_t* getConfig(void);
+
+
+/* Function:      Tell where the config in use came from.
+ *
+ * IN:            Nothing
+ * OUT:           configSource_t
+ */
+configSource_t getConfigSource(void);
+
+
+/* Function:      Get the calibration line of a channel from the config in use,
+ *                shifted by the tare offset of the channel. The raw readings
+ *                are never corrected, the limits converted with this line and
+ *                the Rock take the tare into account instead.
+ *                Channels without a calibration line read in volts.
+ *
+ * IN:            sensorChannel_t channel
+ * OUT:           calibrationLine_t of the channel
+ */
+calibrationLine_t getCalibration(sensorChannel_t channel);
+
+
+/* Function:      Take a chunk of a new config block from the Rock.
+ *
+ * IN:            uint8_t index of the chunk,
+ *                Pointer to the configChunkBytes bytes of the chunk
+ * OUT:           ackStatus_t, ACK_REJECTED for an index out of range,
+ *                ACK_BUSY while a block is being stored
+ */
+ackStatus_t receiveConfigChunk(uint8_t index, const uint8_t* bytes);
+
+
+/* Function:      Start storing the block of the received chunks to the EEPROM
+ *                with the version and CRC of this firmware. The bytes are
+ *                written by continueConfigStore(). The block is taken into use
+ *                at the next reset.
+ *
+ * IN:            Nothing
+ * OUT:           ackStatus_t, ACK_REJECTED if a chunk is missing or a value
+ *                of the block is not finite, a calibration slope is zero or a
+ *                limit is out of the range of its sensor. The chunks of a
+ *                block out of range have to be sent again.
+ *                ACK_BUSY while the previous block is being stored
+ */
+ackStatus_t storeReceivedConfig(void);
+
+
+/* Function:      Write the next changed byte of a block being stored, if the
+ *                EEPROM is ready. Never waits, a byte takes 3.4ms to write,
+ *                so a whole block takes about 420ms of calls. Must not be
+ *                called in SEQUENCE.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void continueConfigStore(void);
+
+
+/* Function:      Take the zero offsets of a tare into use and start storing
+ *                them to the EEPROM with the rest of the config in use.
+ *
+ * IN:            Pointer to tareChannelCount offsets (1/tareFraction ADC counts)
+ * OUT:           Boolean telling if the offsets were taken into use. Not while
+ *                another block is being stored
+ */
+bool setTare(const int16_t* offsets);
+
+
+/* Function:      Tell if a config block is being written to the EEPROM.
+ *
+ * IN:            Nothing
+ * OUT:           Boolean
+ */
+bool isConfigStoring(void);
+
+
+/* Function:      Restart the pass of getConfigChunk() from the first chunk.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void requestConfig(void);
+
+
+/* Function:      Fetch the next chunk of the config block. A pass over the
+ *                whole block starts after a reset and every
+ *                configFrameInterval, nothing is fetched in SEQUENCE.
+ *
+ * IN:            configChunk_t pointer where the chunk will be stored,
+ *                mode_t current mode
+ * OUT:           Boolean telling if a chunk was fetched
+ */
+bool getConfigChunk(configChunk_t* chunk, mode_t currentMode);
+
+#endif
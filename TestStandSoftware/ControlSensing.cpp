@@ -7,10 +7,11 @@
  *                passed to the Arduino Shield.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 #include <stdint.h>
 
 #include "ControlSensing.h"
+#include "DigitalInputs.h"
 
 void initControlSensing(){
   pinMode(DUMP_VALVE_BUTTON_PIN, INPUT);
@@ -22,25 +23,25 @@ void initControlSensing(){
 
 bool readDumpValveButton(){
   //return digitalRead(DUMP_VALVE_BUTTON_PIN);
-  return PINB & (1 << DUMP_VALVE_BUTTON_PIN_PORTB);
+  return inputHigh(IN_DUMP_VALVE_BUTTON);
 }
 
 bool readIgnitionButton(){
   //return digitalRead(IGNITION_SENSE_PIN);
-  return PINH & (1 << IGNITION_SENSE_PIN_PORTH);
+  return inputHigh(IN_IGNITION_SENSE);
 }
 
 bool readHeatingButton(){
   //return digitalRead(HEATING_SENSE_PIN);
-  return PINH & (1 << HEATING_SENSE_PIN_PORTH);
+  return inputHigh(IN_HEATING_SENSE);
 }
 
 bool readN2FeedingValveButton(){
   //return digitalRead(FEEDING_VALVE_BUTTON_PIN);
-  return PIND & (1 << FEEDING_VALVE_BUTTON_PIN_PORTD);
+  return inputHigh(IN_FEEDING_VALVE_BUTTON);
 }
 
 bool readOxidizerValveButton(){
   //return digitalRead(MAIN_VALVE_BUTTON_PIN);
-  return PIND & (1 << MAIN_VALVE_BUTTON_PIN_PORTD);
+  return inputHigh(IN_MAIN_VALVE_BUTTON);
 }
\ No newline at end of file
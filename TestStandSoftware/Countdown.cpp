@@ -6,291 +6,539 @@
  * Purpose:       This object handles the countdown sequence. It controls the 
  *                mode and substate of the system based on timing or sensor
  *                readings to move through the automated sequence.
- *                Contains the FreeRTOS task called countdownLoop.
+ *                Contains the FreeRTOS task called countdownLoop. The loop
+ *                is split into tasks run by the Executive object.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 
 #include "Countdown.h"
 #include "TestAutomation.h"
 #include "Valves.h"
 #include "Ignition.h"
+#include "Pulse.h"
 #include "Heating.h"
 #include "Globals.h"
 #include "Verification.h"
+#include "Bench.h"
+#include "Profiler.h"
+#include "Executive.h"
+#include "Retained.h"
 
-void(* resetFunc) (void) = 0;
+static values_t values;
 
-void initCountdown(){
-  // Nothing to initialize there currently
-  pinMode(CAMERA_TRIGGER_PIN, OUTPUT);
+static mode_t currentMode;
+static substate_t currentSubstate;
+static testInput_t testInput;
+static bool ignitionValveStateFlag;
 
-  //Trigger the camera in case of a reset
-  digitalWrite(CAMERA_TRIGGER_PIN, HIGH);
-  delay(500); //Keep pin high for 500ms
-  digitalWrite(CAMERA_TRIGGER_PIN, LOW);
+static statusValues_t statusValues;
 
+static bool lastDump;
 
-}
+static uint32_t currentTime;
 
-void countdownLoop(){
-  values_t values;
+static bool verificationDone;
+
+static uint32_t countdownStartTime;
+static uint32_t ignitionPressTime;
 
+//Holding the repeat sequence button in WAIT starts a tare
+static uint32_t repeatReleaseTime;
+static bool tareArmed;
+
+//Sample time of the last sample added to the channel statistics
+static uint32_t statisticsTick;
+
+void initCountdown(){
   //Initialize the timing values
-  values.timestamp = 0;
-  values.msTimestamp = 0;
-  values.checkTimestamp = 0;
-  values.timeOverflowOffset = 0;
+  values.hot.tick = 0;
 
   //Initialize the sending of slower values
-  values.slowUpdated = false;
+  values.cold.slowUpdated = false;
+  values.cold.mediumUpdated = false;
 
   //Initialize the values after startup
-  values.N2FeedingPressure = 0;      //N2 Feeding pressure 
-  values.linePressure = 0;      //Oxidizer line pressure 
-  values.combustionPressure = 0;      //Combustion chamber pressure 
-  values.N2OFeedingPressure = 0;      //Oxidizer Feeding pressure 
-  values.loadCell = 0;       //Back of the engine
-  values.bottleTemperature = 0;   //Bottle temperature - Switched to TMP36 output, uses different pin
-  values.notConnectedTemperature = 0;   //Injector temperature - Usually outputs NaN, not used in live_grapher_V3.py
-  values.nozzleTemperature = 0;   //Nozzle temperature
-  values.pipingTemperature = 0;   //Piping temperature
-  values.IR = 0;             //Plume Temperature
+  values.cold.N2FeedingPressure = 0;      //N2 Feeding pressure 
+  values.cold.linePressure = 0;      //Oxidizer line pressure 
+  values.hot.combustionPressure = 0;      //Combustion chamber pressure 
+  values.cold.N2OFeedingPressure = 0;      //Oxidizer Feeding pressure 
+  values.hot.loadCell = 0;       //Back of the engine
+  values.cold.bottleTemperature = 0;   //Bottle temperature - Switched to TMP36 output, uses different pin
+  values.cold.notConnectedTemperature = 0;   //Injector temperature - Usually outputs NaN, not used in live_grapher_V3.py
+  values.cold.nozzleTemperature = 0;   //Nozzle temperature
+  values.cold.pipingTemperature = 0;   //Piping temperature
+  values.cold.IR = 0;             //Plume Temperature
+  values.cold.temperatureFaults = 0;   //Thermocouple fault bits
+
+  values.cold.dumpValveButton = true;        //Dump Valve button status. Initialized true, since new nominal state is dump valve open (inverted afterwards due to normally open valve)
+  values.cold.heatingBlanketButton = false;  //Heating button status
+  values.cold.ignitionButton = false;        //Ignition button status
+  values.cold.n2FeedingButton = false;       //N2 Feeding valve status
+  values.cold.oxidizerValveButton = false;   //Main oxidizer valve status
+
+  ignitionValveStateFlag = false;
+  lastDump = true;
+  currentTime = 0;
+  verificationDone = true;
+  countdownStartTime = 0;
+  ignitionPressTime = 0;
+  repeatReleaseTime = 0;
+  tareArmed = false;
+  statisticsTick = 0;
+
+  //Trigger the camera in case of a reset. The pulse is ended by the timer hardware
+  startPulse(PULSE_CAMERA, 0, cameraResetPulseTime * 1000UL);
+}
 
-  values.dumpValveButton = true;        //Dump Valve button status. Initialized true, since new nominal state is dump valve open (inverted afterwards due to normally open valve)
-  values.heatingBlanketButton = false;  //Heating button status
-  values.ignitionButton = false;        //Ignition button status
-  values.n2FeedingButton = false;       //N2 Feeding valve status
-  values.oxidizerValveButton = false;   //Main oxidizer valve status
+static void senseTask(){
+  //All digital inputs of this frame are read at this moment
+  latchInputs();
 
+  // Read test pins, read all of them only outside SEQUENCE
+  // If more sampling rate is needed, this could be fully skipped
+  // in certain substates >ALL_OFF and <PURGING
+  getTestInput(&testInput, currentMode != SEQUENCE);
+  PROFILE_PHASE_END(PHASE_TEST_INPUT);
 
-  mode_t currentMode;
-  substate_t currentSubstate;
-  testInput_t testInput;
-  bool ignitionValveStateFlag;
+  //Perform and fetch latest measurements
+  forwardGetLatestValues(&values, currentMode);
+  PROFILE_PHASE_END(PHASE_LATEST_VALUES);
+}
 
-  statusValues_t statusValues;
-  bool valveState;
-  bool ignitionState;
+static void checkTask(){
+  //Check latest values for anomalies
+  sendToCheck(values);
+  PROFILE_PHASE_END(PHASE_CHECK);
+}
 
-  bool lastDump = true;
+static uint16_t payloadU16(const uint8_t* bytes){
+  return (uint16_t) bytes[0] << 8 | bytes[1];
+}
 
-  uint32_t currentTime = 0;
+static uint32_t payloadU32(const uint8_t* bytes){
+  return (uint32_t) payloadU16(bytes) << 16 | payloadU16(bytes + 2);
+}
 
-  bool verificationDone = true;
+//Payload length of each commandId_t, 0xFF for unknown IDs
+static uint8_t commandLength(uint8_t id){
+  switch (id){
+    case CMD_PING:
+    case CMD_REQUEST_CONFIG:
+    case CMD_START_VERIFICATION:
+    case CMD_RESET:
+    case CMD_CONFIG_STORE:
+    case CMD_TARE:                return 0;
+    case CMD_SET_RATES:           return 4;
+    case CMD_SET_BAUD:            return 4;
+    case CMD_CONFIG_CHUNK:        return 1 + configChunkBytes;
+    default:                      return 0xFF;
+  }
+}
 
-  uint32_t countdownStartTime = 0;
-  uint32_t ignitionPressTime = 0;
+static void commandStep(mode_t mode){
+  command_t command;
 
-  while (true){
-    getCurrentMode(&currentMode);
-    getCurrentSubstate(&currentSubstate);
+  //Also turns the receiver off in SEQUENCE
+  if (!forwardGetCommand(&command, mode)){
+    return;
+  }
 
-    // Read test pins, read all of them only outside SEQUENCE
-    // If more sampling rate is needed, this could be fully skipped
-    // in certain substates >ALL_OFF and <PURGING
-    getTestInput(&testInput, currentMode != SEQUENCE);
+  ackStatus_t status = ACK_OK;
+  uint32_t baudrate = 0;
+
+  if (commandLength(command.id) == 0xFF){
+    status = ACK_UNKNOWN;
+  }else if (command.length != commandLength(command.id)){
+    status = ACK_BAD_LENGTH;
+  }else{
+    switch (command.id){
+      case CMD_REQUEST_CONFIG:
+        requestConfigFrames();
+        break;
 
-    //Perform and fetch latest measurements
-    forwardGetLatestValues(&values, currentMode);
+      case CMD_SET_RATES:
+        if (!setNewSensorRates(payloadU16(&command.payload[0]), payloadU16(&command.payload[2]))){
+          status = ACK_REJECTED;
+        }
+        break;
 
-    //Check latest values for anomalies
-    sendToCheck(values);
+      case CMD_START_VERIFICATION:
+        //The same verification as with the start test input at startup
+        if (mode != WAIT){
+          status = ACK_REJECTED;
+        }else{
+          initVerification();
+          setNewMode(TEST);
+          setNewTestModeIndicator(true);
+          tareArmed = false;
+        }
+        break;
 
-    // The dump valve is within the main loop as it must always be accessible.
-    // As of V1.31 the dump is always operable
-    if (lastDump != values.dumpValveButton){
-      setValve(pin_names_t::DUMP_VALVE_PIN, !values.dumpValveButton); //Inverted due to valve being normally open
-      lastDump = values.dumpValveButton;
-    }
+      case CMD_TARE:
+        status = forwardStartTare(mode);
+        break;
 
-    // Limit the amount of things done in sequence mode to make the burst mode sampling faster
-    if (currentMode != SEQUENCE){
+      case CMD_SET_BAUD:
+        baudrate = payloadU32(command.payload);
+        if (baudrate < serialBaudMin || baudrate > serialBaudMax){
+          status = ACK_REJECTED;
+        }
+        break;
 
-      if (testInput.resetSW){
-        //Ability to reset the Arduino through software
-        resetFunc();
-      }
+      case CMD_CONFIG_CHUNK:
+        status = forwardConfigChunk(command.payload[0], &command.payload[1]);
+        break;
 
-      callBuzzerUpdate();
+      case CMD_CONFIG_STORE:
+        status = forwardConfigStore();
+        break;
 
-      setValve(pin_names_t::OXIDIZER_VALVE_PIN, values.oxidizerValveButton);
-      setValve(pin_names_t::N2FEEDING_VALVE_PIN, values.n2FeedingButton);
+      default:
+        //CMD_PING and CMD_RESET are only acknowledged here
+        break;
+    }
+  }
+
+  sendAckToSerial(command, status);
 
-      //The ability to reset the sequence afterwards for repeated testing
-      //This updates the LED state
-      setNewRepeatIndicator(testInput.repeat);
+  //Done after the acknowledgement is written
+  if (status == ACK_OK && command.id == CMD_SET_BAUD){
+    setNewBaudRate(baudrate);
+  }
+  if (status == ACK_OK && command.id == CMD_RESET){
+    //The transmit buffer keeps draining in the idle sleep until the reset
+    softwareReset();
+  }
+}
 
+static void tareButtonStep(){
+  //The button has to be released in WAIT first, so the press returning from SHUTDOWN doesn't tare
+  if (!testInput.repeat){
+    repeatReleaseTime = millis();
+    tareArmed = true;
+  }else if (tareArmed && millis() - repeatReleaseTime > tareHoldTime){
+    tareArmed = false;
+    if (forwardStartTare(currentMode) != ACK_OK){
+      setNewBuzzerPattern(BUZZER_TARE_FAILED);
     }
+  }
+}
 
+static void tareStep(){
+  switch (forwardTareSample(values, currentMode)){
+    case TARE_DONE:
+      setNewBuzzerPattern(BUZZER_TARE_DONE);
+      break;
 
-    //MODE switch case
-    switch(currentMode){
-      case INIT:
-        //Shouldn't ever be here. WAIT/TEST is entered before starting FreeRTOS tasks.
-        break;
+    case TARE_FAILED:
+      setNewBuzzerPattern(BUZZER_TARE_FAILED);
+      break;
 
-      case TEST:  
-        //Continue with verification and check if was completed succesfully
-        verificationDone = runVerificationStep(values, testInput);
-        if (verificationDone == true){
-          setNewMode(WAIT);
-        }
-        break;
+    default:
+      //An aborted tare is silent, the sequence was started
+      break;
+  }
+}
 
-      case WAIT:
-        // The WAIT mode includes heating. The HEATING mode was removed. 
-        if (values.ignitionButton == true){
-          ignitionPressTime = millis();
-          
-          setNewMode(SEQUENCE);
-          //setNewBaudRate(serialBaudFast);
-        }
+static void sequenceTask(){
+  // The dump valve is within the main loop as it must always be accessible.
+  // As of V1.31 the dump is always operable
+  if (lastDump != values.cold.dumpValveButton){
+    setValve(pin_names_t::DUMP_VALVE_PIN, !values.cold.dumpValveButton); //Inverted due to valve being normally open
+    lastDump = values.cold.dumpValveButton;
+  }
 
-        // If the system returns to WAIT mode for any reason, the flag is reset to its default value.
-        ignitionValveStateFlag = false; 
+  // Limit the amount of things done in sequence mode to make the burst mode sampling faster
+  if (currentMode != SEQUENCE){
 
-        break;
+    if (testInput.resetSW){
+      //Ability to reset the Arduino through software
+      softwareReset();
+    }
 
-      case SEQUENCE:
-        /* Nested switch - case for the substate. Substate is only active
-         * in the SEQUENCE mode. Substates are responsible for engaging and
-         * disengaging the ignition relay and opening and closing the main oxidizer
-         * valve based on set timing found in the environmental Globals object.
-         */
-        currentTime = millis();
+    setValve(pin_names_t::OXIDIZER_VALVE_PIN, values.cold.oxidizerValveButton);
+    setValve(pin_names_t::N2FEEDING_VALVE_PIN, values.cold.n2FeedingButton);
 
-        switch (currentSubstate){
-          case ALL_OFF:
-              
-            //All actuators off, wait for button to be held for ignitionSafeTime (ms)
-            if (values.ignitionButton == false){
-              //setNewBaudRate(serialBaudNormal);
-              setNewMode(WAIT);
+    //A config block received from the Rock is written to the EEPROM a byte at a time
+    continueConfigWrite();
+  }
+  //Aborts a tare when WAIT is left
+  tareStep();
+  //Integrates the burn while the main valve is open and detects its events
+  forwardBurnSample(values, currentMode, currentSubstate);
+  PROFILE_PHASE_END(PHASE_OUTPUTS);
+
+
+  //MODE switch case
+  switch(currentMode){
+    case INIT:
+      //Shouldn't ever be here. WAIT/TEST is entered before starting FreeRTOS tasks.
+      break;
+
+    case TEST:
+      //The verification sequence is run by verificationTask()
+      break;
+
+    case WAIT:
+      // The WAIT mode includes heating. The HEATING mode was removed. 
+      if (values.cold.ignitionButton == true){
+        ignitionPressTime = millis();
+        tareArmed = false;
+        
+        setNewMode(SEQUENCE);
+        //setNewBaudRate(serialBaudFast);
+      }else{
+        tareButtonStep();
+      }
+
+      // If the system returns to WAIT mode for any reason, the flag is reset to its default value.
+      ignitionValveStateFlag = false; 
+
+      break;
+
+    case SEQUENCE:
+      /* Nested switch - case for the substate. Substate is only active
+       * in the SEQUENCE mode. Substates are responsible for engaging and
+       * disengaging the ignition relay and opening and closing the main oxidizer
+       * valve based on set timing found in the environmental Globals object.
+       */
+      currentTime = millis();
+
+      switch (currentSubstate){
+        case ALL_OFF:
+            
+          //All actuators off, wait for button to be held for ignitionSafeTime (ms)
+          if (values.cold.ignitionButton == false){
+            //setNewBaudRate(serialBaudNormal);
+            setNewMode(WAIT);
+            
+          }else{
+            //We might not want to have a hard pressure limit. Minimum firing 
+            //pressure currently set to 0 bar. Fully removed since ~V1.5
+            if ((currentTime - ignitionPressTime > ignitionSafeTime) && !(values.cold.dumpValveButton || values.cold.n2FeedingButton || values.cold.oxidizerValveButton)){
+              countdownStartTime = currentTime;
+              setNewSubstate(IGNIT_ON);
+
+              //Igniter is turned off and the high speed camera triggered by the timer hardware
+              startPulse(PULSE_IGNITER, 0, ignitionOffTime * 1000UL);
+              forwardBurnCommand(BURN_COMMAND_IGNITER);
+              startPulse(PULSE_CAMERA, cameraTriggerTime * 1000UL, (purgingTime - cameraTriggerTime) * 1000UL);
               
-            }else{
-              //We might not want to have a hard pressure limit. Minimum firing 
-              //pressure currently set to 0 bar. Fully removed since ~V1.5
-              if ((currentTime - ignitionPressTime > ignitionSafeTime) && !(values.dumpValveButton || values.n2FeedingButton || values.oxidizerValveButton)){
-                countdownStartTime = currentTime;
-                setNewSubstate(IGNIT_ON);
-                setIgnition(true);
-                
-              }else if (ignitionValveStateFlag == false){
-                if (values.dumpValveButton == true){
-                  ignitionValveStateFlag = true;
-                  sendMessageToSerial(MSG_DUMP_WARNING);
-                }
-                if (values.n2FeedingButton == true){
-                  ignitionValveStateFlag = true;
-                  sendMessageToSerial(MSG_N2_FEED_WARNING);
-                }
-                if (values.oxidizerValveButton == true){
-                  ignitionValveStateFlag = true;
-                  sendMessageToSerial(MSG_OX_FEED_WARNING);
-                }
+            }else if (ignitionValveStateFlag == false){
+              if (values.cold.dumpValveButton == true){
+                ignitionValveStateFlag = true;
+                sendMessageToSerial(MSG_DUMP_WARNING);
+              }
+              if (values.cold.n2FeedingButton == true){
+                ignitionValveStateFlag = true;
+                sendMessageToSerial(MSG_N2_FEED_WARNING);
+              }
+              if (values.cold.oxidizerValveButton == true){
+                ignitionValveStateFlag = true;
+                sendMessageToSerial(MSG_OX_FEED_WARNING);
               }
             }
+          }
 
-            break;
+          break;
 
-          case IGNIT_ON:
-              //Ignition has been turned on, wait until oxidiser valve needs to be opened
-              
-              if (currentTime - countdownStartTime > valveOnTime){
-                setNewSubstate(VALVE_ON);
-                setValve(pin_names_t::OXIDIZER_VALVE_PIN, true);
-              }
-            break;
+        case IGNIT_ON:
+            //Ignition has been turned on, wait until oxidiser valve needs to be opened
+            
+            if (currentTime - countdownStartTime > valveOnTime){
+              setNewSubstate(VALVE_ON);
+              setValve(pin_names_t::OXIDIZER_VALVE_PIN, true);
+              forwardBurnCommand(BURN_COMMAND_VALVE);
+            }
+          break;
 
-          case VALVE_ON:
-              //Valve has been opened, wait until ignition can be turned off
-              if (currentTime - countdownStartTime > ignitionOffTime){
-                setNewSubstate(IGNIT_OFF);
-                setIgnition(false);
-              }
-            break;
+        case VALVE_ON:
+            //Valve has been opened, wait until the ignition pulse has ended
+            if (!isPulseActive(PULSE_IGNITER)){
+              setNewSubstate(IGNIT_OFF);
+            }
+          break;
 
-          case IGNIT_OFF:
-              //Ignition has been turned off, wait until oxidiser valve needs to be closed
-              if (currentTime - countdownStartTime > valveOffTime){
-                setNewSubstate(VALVE_OFF);
-                setValve(pin_names_t::OXIDIZER_VALVE_PIN, false);
-              }
-            break;
+        case IGNIT_OFF:
+            //Ignition has been turned off, wait until oxidiser valve needs to be closed
+            if (currentTime - countdownStartTime > valveOffTime){
+              setNewSubstate(VALVE_OFF);
+              setValve(pin_names_t::OXIDIZER_VALVE_PIN, false);
+            }
+          break;
 
-          case VALVE_OFF:
-              //Oxidiser valve has been closed, wait until piping clears from oxidiser
-              if (currentTime - countdownStartTime > oxidiserEmptyTime){
-                setNewSubstate(PURGING);
-                setValve(pin_names_t::N2FEEDING_VALVE_PIN, true);
-              }
-            break;
+        case VALVE_OFF:
+            //Oxidiser valve has been closed, wait until piping clears from oxidiser
+            if (currentTime - countdownStartTime > oxidiserEmptyTime){
+              setNewSubstate(PURGING);
+              setValve(pin_names_t::N2FEEDING_VALVE_PIN, true);
+            }
+          break;
 
-          case PURGING:
-              //Trigger the high speed camera cameraTriggerTime ms after ignition
-              if (currentTime - countdownStartTime > cameraTriggerTime){
-                digitalWrite(CAMERA_TRIGGER_PIN, HIGH);
-              }
+        case PURGING:
+            //Purging in progress, wait until purging finishes
+            if (currentTime - countdownStartTime > purgingTime){
+              setNewSubstate(FINISHED);
+              setValve(pin_names_t::N2FEEDING_VALVE_PIN, false);
+            }
+          break;
 
-              //Purging in progress, wait until purging finishes
-              if (currentTime - countdownStartTime > purgingTime){
-                setNewSubstate(FINISHED);
-                setValve(pin_names_t::N2FEEDING_VALVE_PIN, false);
-              }
-            break;
+        case FINISHED:
+          //Sequence is finished
+          //setNewBaudRate(serialBaudNormal);
+          setNewMode(SHUTDOWN);
+          break;
+      }
+      break;
 
-          case FINISHED:
-            //Sequence is finished
-            //setNewBaudRate(serialBaudNormal);
-            setNewMode(SHUTDOWN);
-            break;
-        }
-        break;
 
+    case SAFE:
+      /* This mode is entered if the FaultDetection object detects values
+       * outside safe limits. 
+       */
+      
+      //Set substate to the final one
+      setNewSubstate(FINISHED);
 
-      case SAFE:
-        /* This mode is entered if the FaultDetection object detects values
-         * outside safe limits. 
-         */
-        
-        //Set substate to the final one
-        setNewSubstate(FINISHED);
+      //Turn off ignition and the pending camera trigger
+      setIgnition(false);
+      cancelPulse(PULSE_CAMERA);
 
-        //Turn off ignition
-        setIgnition(false);
+      break;
 
-        break;
+      
+    case SHUTDOWN:
+      //Testfire over
 
-        
-      case SHUTDOWN:
-        //Testfire over
+      // If repeatSequence is pressed, revert to pre firing state
+      if (testInput.repeat == true){
+        setNewSubstate(ALL_OFF);
+        setNewMode(WAIT);
+      }
+      
+      break;
+  }
 
-        //Turn of camera trigger
-        digitalWrite(CAMERA_TRIGGER_PIN, LOW);
+  //Commands of the Rock see the mode set above
+  mode_t newMode;
+  getCurrentMode(&newMode);
+  commandStep(newMode);
 
-        // If repeatSequence is pressed, revert to pre firing state
-        if (testInput.repeat == true){
-          setNewSubstate(ALL_OFF);
-          setNewMode(WAIT);
-        }
-        
-        break;
-    }
+  PROFILE_PHASE_END(PHASE_MODE_SWITCH);
+}
 
-    //Get the states using the voltage measurement from TestInOut.
-    statusValues.valveActive = !testInput.MAIN_VALVE_VOLTAGE_IN;   //Iverted input
-    statusValues.ignitionEngagedActive = testInput.IGN_VOLTAGE_IN;
-    //Update mode and substate stored in statusValues
-    statusValues.mode = currentMode;
-    statusValues.subState = currentSubstate;
-
-    //Send out the data through Serial
-    sendValuesToSerial(&values, statusValues);
-    
-    // Limit the sampling rate outside the SEQUENCE mode
-    if (currentMode != SEQUENCE){
-      delay(1000/limitedSampleRate);
-    }
+static void verificationTask(){
+  if (currentMode != TEST){
+    return;
+  }
+
+  //Continue with verification and check if was completed succesfully
+  verificationDone = runVerificationStep(values.cold, testInput);
+  if (verificationDone == true){
+    setNewMode(WAIT);
+  }
+}
+
+static void commsTask(){
+  //Get the states using the voltage measurement from TestInOut.
+  statusValues.valveActive = !testInput.MAIN_VALVE_VOLTAGE_IN;   //Iverted input
+  statusValues.ignitionEngagedActive = testInput.IGN_VOLTAGE_IN;
+  //Update mode and substate stored in statusValues
+  statusValues.mode = currentMode;
+  statusValues.subState = currentSubstate;
+
+  //Send out the data through Serial
+  sendBootToSerial(currentMode);
+  sendValuesToSerial(values, statusValues);
+  sendPulseEdgesToSerial();
+  sendSampleTimingToSerial();
+  sendExecutiveToSerial();
+  sendConfigToSerial(currentMode);
+  sendStatisticsToSerial();
+  sendBurnToSerial(currentMode);
+  sendBurnEventsToSerial();
+  PROFILE_PHASE_END(PHASE_SERIAL);
+#ifdef PROFILE_BUILD
+  sendProfileToSerial();
+#endif
+}
+
+static void indicatorsTask(){
+  if (currentMode == SEQUENCE){
+    return;
   }
-}
\ No newline at end of file
+
+  //The ability to reset the sequence afterwards for repeated testing
+  //This updates the LED state
+  setNewRepeatIndicator(testInput.repeat);
+}
+
+static void statisticsTask(){
+  //A new sample of senseTask is added as such. Outside SEQUENCE the frames in between read the channels
+  if (values.hot.tick != statisticsTick){
+    statisticsTick = values.hot.tick;
+    forwardStatisticsSample(values, currentMode);
+  }else if (currentMode != SEQUENCE){
+    sampleStatisticsChannels(currentMode);
+  }
+}
+
+/* Schedules of the cyclic executive, see Executive.cpp
+ * In SEQUENCE every task runs in every frame, and the frame is the burst sample period.
+ * Outside SEQUENCE one sample period is split into 1ms frames: sensing and checks in the
+ * first, the valves and the mode switch in the second, the Serial lines in the third and
+ * the indicators in the fourth. The channel statistics run in every frame. The rest of
+ * the period is spent sleeping.
+ * Budgets are in Timer1 ticks (4us). Each one is the longest run of the task measured with
+ * teststand_sim over 300 runs ("Longest task runs" table) plus a margin for the CPU time,
+ * which the host build doesn't charge. The measured runs of the stand are reported in
+ * AUX_FRAME_TASK_TIMES. Measured in SEQUENCE: sense 16 (two hot conversions and one cold
+ * read step), the rest 0. Outside SEQUENCE: sense 42 (46 with the IGN_GND sample of TEST),
+ * comms 80, statistics 16, the rest 0.
+ * The budgets of the tasks of a frame must fit in the frame, or every frame would count
+ * as an overrun.
+ */
+static constexpr schedule_t sequenceSchedule = {
+  ticksPerSample, 1, {
+    {senseTask,        1, 0,  20},
+    {checkTask,        1, 0,  14},
+    {sequenceTask,     1, 0,   4},
+    {verificationTask, 0, 0,   0},
+    {commsTask,        1, 0,   8},
+    {indicatorsTask,   0, 0,   0},
+    {statisticsTask,   1, 0,   4}
+  }
+};
+static_assert(budgetsFit(sequenceSchedule), "Task budgets of sequenceSchedule exceed the frame");
+
+static constexpr schedule_t limitedSchedule = {
+  limitedFrameMicros / timebaseTickMicros, limitedMajorFrame, {
+    {senseTask,        limitedMajorFrame, 0, 120},
+    {checkTask,        limitedMajorFrame, 0,  50},
+    {sequenceTask,     limitedMajorFrame, 1,  50},
+    {verificationTask, limitedMajorFrame, 1,  25},
+    {commsTask,        limitedMajorFrame, 2, 125},
+    {indicatorsTask,   limitedMajorFrame, 3,  25},
+    {statisticsTask,   1,                 0,  30}
+  }
+};
+static_assert(budgetsFit(limitedSchedule), "Task budgets of limitedSchedule exceed the frame");
+
+void countdownStep(){
+  //Sleep until the frame clock releases the next minor frame
+  uint8_t elapsedFrames = waitFrame();
+
+  getCurrentMode(&currentMode);
+  getCurrentSubstate(&currentSubstate);
+  BENCH_LOOP(currentMode);
+  PROFILE_LOOP_START();
+
+  runFrame((currentMode == SEQUENCE) ? &sequenceSchedule : &limitedSchedule, elapsedFrames, currentMode);
+}
+
+void countdownLoop(){
+  while (true){
+    countdownStep();
+  }
+}
@@ -18,10 +18,18 @@
  */
 void initCountdown(void);
 
-/* Function:      FreeRTOS task function for the automated countdown sequence
+/* Function:      One pass of the automated countdown sequence.
  *                Reads the current mode and substate of the system and controls
  *                the various actuators based on timing, sensor readings and 
- *                external control
+ *                external control. Also used directly by the host build.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void countdownStep(void);
+
+/* Function:      FreeRTOS task function for the automated countdown sequence.
+ *                Runs countdownStep() forever.
  *
  * IN:            Nothing
  * OUT:           Nothing
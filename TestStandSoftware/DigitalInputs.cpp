@@ -0,0 +1,52 @@
+/* Filename:      DigitalInputs.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Latches all digital inputs of the test stand into a single
+ *                bitfield once per loop. Replaces the separate port reads of
+ *                the TestInOut and ControlSensing objects.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Gpio.h"
+#include "DigitalInputs.h"
+
+uint16_t digitalInputSnapshot;
+
+void initDigitalInputs(){
+  digitalInputSnapshot = 0;
+}
+
+//Level of a pin in the port values read by latchDigitalInputs()
+static inline bool latchedLevel(const uint8_t* ports, pin_names_t pin){
+  return ports[pinPort(pin)] & pinMask(pin);
+}
+
+void latchDigitalInputs(){
+  //All ports with inputs are read back to back before any bit is packed
+  uint8_t ports[GPIO_PORT_J + 1] = {0};
+  ports[GPIO_PORT_A] = PINA;
+  ports[GPIO_PORT_B] = PINB;
+  ports[GPIO_PORT_C] = PINC;
+  ports[GPIO_PORT_D] = PIND;
+  ports[GPIO_PORT_H] = PINH;
+
+  uint16_t snapshot = 0;
+
+  if (latchedLevel(ports, MAIN_VALVE_TEST_PIN)){snapshot |= IN_MAIN_VALVE_TEST;}
+  if (latchedLevel(ports, IGN_SW_RELAY_TEST_PIN)){snapshot |= IN_IGN_SW_RELAY_TEST;}
+  if (latchedLevel(ports, DUMP_VALVE_BUTTON_PIN)){snapshot |= IN_DUMP_VALVE_BUTTON;}
+  if (latchedLevel(ports, IGNITION_SENSE_PIN)){snapshot |= IN_IGNITION_SENSE;}
+  if (latchedLevel(ports, HEATING_SENSE_PIN)){snapshot |= IN_HEATING_SENSE;}
+  if (latchedLevel(ports, FEEDING_VALVE_BUTTON_PIN)){snapshot |= IN_FEEDING_VALVE_BUTTON;}
+  if (latchedLevel(ports, MAIN_VALVE_BUTTON_PIN)){snapshot |= IN_MAIN_VALVE_BUTTON;}
+  if (latchedLevel(ports, AUTO_TEST_START_PIN)){snapshot |= IN_AUTO_TEST_START;}
+  if (latchedLevel(ports, REPEAT_SEQUENECE_PIN)){snapshot |= IN_REPEAT_SEQUENCE;}
+  if (latchedLevel(ports, SW_RESET_PIN)){snapshot |= IN_SW_RESET;}
+
+  digitalInputSnapshot = snapshot;
+}
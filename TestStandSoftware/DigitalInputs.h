@@ -0,0 +1,49 @@
+/* Filename:      DigitalInputs.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the DigitalInputs <<device>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef DIGITALINPUTS_H
+#define DIGITALINPUTS_H
+
+//Latest snapshot of the digital inputs, only written by latchDigitalInputs()
+extern uint16_t digitalInputSnapshot;
+
+/* Function:      Initialize the DigitalInputs object. The snapshot is cleared,
+ *                the pins are configured by their owner objects.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initDigitalInputs(void);
+
+
+/* Function:      Read the input ports A, B, C, D and H once and store the
+ *                digital inputs into the snapshot. Called once at the start
+ *                of every loop, so every reader sees the same moment in time.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void latchDigitalInputs(void);
+
+
+/* Function:      Read one input from the latest snapshot. Inlined into a
+ *                single AND with a constant mask.
+ *
+ * IN:            digitalInput_t mask of the input
+ * OUT:           Boolean level of the pin when the snapshot was latched
+ */
+inline bool inputHigh(digitalInput_t input){
+  return digitalInputSnapshot & input;
+}
+
+#endif
@@ -0,0 +1,168 @@
+/* Filename:      Executive.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Cyclic executive running the countdown tasks from a frame
+ *                table. The minor frames are released by the Timer1 frame
+ *                clock of the Timebase object, the CPU sleeps in between.
+ *                Replaces the sample period wait of senseLoop() and the fixed
+ *                delay at the end of the loop outside SEQUENCE.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Executive.h"
+#include "Timebase.h"
+#include "Watchdog.h"
+
+/* Schedule explanation:
+ * A task runs in the minor frames where (frame - offset) is a multiple of its period.
+ * The frame index counts the minor frames released by the clock, so it stays locked to
+ * time even when a frame overruns into the next ones. A task whose frame was skipped
+ * by the overrun runs once in the next frame, instead of waiting for the next period.
+ * The run time of each task is measured with the 16-bit timer and compared to its budget.
+ * The longest run of each task is kept per mode, so the budgets can be checked against the
+ * worst case seen on the stand. The longest runs restart on every mode change.
+ * Every task with a period reports its heartbeat to the Watchdog object, which is fed at
+ * the end of the frame once all of them have run.
+ */
+
+static const schedule_t* activeSchedule;
+static uint8_t frameIndex;
+static uint8_t expectedTasks;
+
+static uint16_t frameOverruns;
+static uint16_t taskOverruns[taskCount];
+static uint32_t lastStatsTime;
+
+//Longest runs of the current mode
+static mode_t timesMode;
+static uint16_t maxTaskTicks[taskCount];
+
+//Final stats of the previous mode, sent once
+static executiveStats_t finishedStats;
+static bool finishedPending;
+
+static void countOverrun(uint16_t* count, uint16_t increment){
+  *count = (*count > 0xFFFF - increment) ? 0xFFFF : *count + increment;
+}
+
+static void fillStats(executiveStats_t* stats){
+  stats->mode = timesMode;
+  stats->frameOverruns = frameOverruns;
+  for (uint8_t i = 0; i < taskCount; i++){
+    stats->taskOverruns[i] = taskOverruns[i];
+    stats->maxTaskTicks[i] = maxTaskTicks[i];
+  }
+}
+
+static void clearTaskTimes(mode_t mode){
+  timesMode = mode;
+  for (uint8_t i = 0; i < taskCount; i++){
+    maxTaskTicks[i] = 0;
+  }
+}
+
+void initExecutive(){
+  activeSchedule = NULL;
+  frameIndex = 0;
+  expectedTasks = 0;
+
+  frameOverruns = 0;
+  for (uint8_t i = 0; i < taskCount; i++){
+    taskOverruns[i] = 0;
+  }
+  lastStatsTime = 0;
+
+  clearTaskTimes(INIT);
+  finishedPending = false;
+}
+
+uint8_t waitFrame(){
+  //The frame clock starts with the first schedule
+  if (activeSchedule == NULL){
+    return 1;
+  }
+
+  bool late;
+  uint8_t elapsedFrames = waitForFrame(&late);
+
+  //A frame released before the wait started late, the rest of the releases were skipped
+  if (late){
+    countOverrun(&frameOverruns, elapsedFrames);
+  }else if (elapsedFrames > 1){
+    countOverrun(&frameOverruns, elapsedFrames - 1);
+  }
+
+  return elapsedFrames;
+}
+
+void runFrame(const schedule_t* schedule, uint8_t elapsedFrames, mode_t currentMode){
+  if (currentMode != timesMode){
+    fillStats(&finishedStats);
+    finishedPending = true;
+    clearTaskTimes(currentMode);
+  }
+
+  if (schedule != activeSchedule){
+    activeSchedule = schedule;
+    setFramePeriod(schedule->frameTicks);
+    frameIndex = 0;
+    elapsedFrames = 1;
+
+    expectedTasks = 0;
+    for (uint8_t i = 0; i < taskCount; i++){
+      if (schedule->tasks[i].period != 0){
+        expectedTasks |= 1 << i;
+      }
+    }
+  }else{
+    frameIndex = (frameIndex + elapsedFrames) % schedule->majorFrame;
+  }
+
+  for (uint8_t i = 0; i < taskCount; i++){
+    const executiveTask_t* task = &schedule->tasks[i];
+
+    if (task->period == 0){
+      continue;
+    }
+    if (elapsedFrames < task->period && (frameIndex + task->period - task->offset) % task->period >= elapsedFrames){
+      continue;
+    }
+
+    uint16_t start = timebaseTicks16();
+    taskStarted((task_t) i);
+    task->run();
+    taskFinished((task_t) i);
+    uint16_t ticks = timebaseTicks16() - start;
+
+    if (ticks > task->budgetTicks){
+      countOverrun(&taskOverruns[i], 1);
+    }
+    if (ticks > maxTaskTicks[i]){
+      maxTaskTicks[i] = ticks;
+    }
+  }
+
+  feedWatchdog(expectedTasks);
+}
+
+bool getExecutiveStats(executiveStats_t* stats){
+  if (finishedPending){
+    *stats = finishedStats;
+    finishedPending = false;
+    return true;
+  }
+
+  uint32_t now = millis();
+  if (now - lastStatsTime < executiveFrameInterval){
+    return false;
+  }
+  lastStatsTime = now;
+
+  fillStats(stats);
+  return true;
+}
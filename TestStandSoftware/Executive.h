@@ -0,0 +1,62 @@
+/* Filename:      Executive.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Executive <<cyclic>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef EXECUTIVE_H
+#define EXECUTIVE_H
+
+/* Function:      Initialize the Executive object. The frame clock is started
+ *                by the first runFrame().
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initExecutive(void);
+
+
+/* Function:      Sleep until the next minor frame is released by the frame
+ *                clock and count the frames released while the previous
+ *                frame was still running. Returns at once before the first
+ *                frame.
+ *
+ * IN:            Nothing
+ * OUT:           uint8_t minor frames since the previous frame
+ */
+uint8_t waitFrame(void);
+
+
+/* Function:      Run the tasks of the schedule due in this minor frame, in the
+ *                order of task_t, count the runs over their budget and keep
+ *                the longest run of each task in the mode. A task whose frame
+ *                was skipped by an overrun runs in this frame. When the
+ *                schedule changes, the frame clock takes the new minor frame
+ *                and the major frame starts from its first frame.
+ *
+ * IN:            Pointer to the schedule_t of the current mode,
+ *                uint8_t minor frames since the previous frame from waitFrame(),
+ *                mode_t current mode
+ * OUT:           Nothing
+ */
+void runFrame(const schedule_t* schedule, uint8_t elapsedFrames, mode_t currentMode);
+
+
+/* Function:      Fetch the overrun counts and the longest task runs of the
+ *                mode every executiveFrameInterval ms. When the mode has
+ *                changed, the final stats of the previous mode are fetched
+ *                first.
+ *
+ * IN:            executiveStats_t pointer where the stats will be stored
+ * OUT:           Boolean telling if the stats were fetched
+ */
+bool getExecutiveStats(executiveStats_t* stats);
+
+#endif
@@ -15,74 +15,286 @@
 #include "FaultDetection.h"
 #include "Mode.h"
 #include "Buzzer.h"
+#include "Prefilter.h"
+#include "Trend.h"
+#include "SensorHealth.h"
+#include "SerialComms.h"
+#include "Bench.h"
+#include "Retained.h"
+#include "Config.h"
 
-static int16_t N2OFeedingPassCount;
-static int16_t chamberPassCount;
-static int16_t casingPassCount;
+/* Redline table. Each row is checked against the newest measurements on every
+ * call of checkData(). The thresholds and hysteresis are converted to raw values
+ * from the limits of the Config object in initFaultDetect(), so the check itself
+ * is only integer compares regardless of the number of rows.
+ * The row is tripped after passes + 1 successive samples over the threshold
+ * and released once the value falls below threshold - hysteresis.
+ * Rate and prediction rows use the derivative estimators of the Trend object.
+ * Rows of channels flagged unhealthy by the SensorHealth object are kept released.
+ * The order of the rows must match redlineNames_t. The thresholds and hysteresis
+ * are left zero here and given by the redline limits of the config.
+ */
+static redline_t redlines[] = {
+  //RL_CHAMBER_PRESSURE
+  {REDLINE_LEVEL, CH_CHAMBER_PRESSURE, MODE_MASK_ALL,
+   0, 0, successivePasses, REDLINE_VOTE, 0},
+
+  //RL_CHAMBER_PREDICTED: Chamber pressure is going to cross the threshold within the horizon
+  {REDLINE_PREDICTED, CH_CHAMBER_PRESSURE, modeBit(SEQUENCE),
+   0, 0, trendPasses, REDLINE_VOTE, msToTrendHorizon(chamberPredictionHorizon)},
+
+  //RL_LOAD_OVERLOAD: Thrust corresponding to the chamber pressure threshold
+  {REDLINE_LEVEL, CH_LOAD_CELL, modeBit(SEQUENCE),
+   0, 0, successivePasses, REDLINE_VOTE, 0},
+
+  //RL_N2O_FEEDING_PRESSURE: SAFE mode entry disabled for first hot flow  in version V_1.45 on (10.05.2024)
+  {REDLINE_LEVEL, CH_N2O_FEEDING_PRESSURE, MODE_MASK_NONE,
+   0, 0, successivePasses, REDLINE_SAFE, 0},
+
+  //RL_NOZZLE_TEMPERATURE: SAFE mode entry disabled for first hot flow  in version V_1.45 on (10.05.2024)
+  {REDLINE_LEVEL, CH_NOZZLE_TEMPERATURE, MODE_MASK_NONE,
+   0, 0, successivePasses, REDLINE_SAFE, 0},
+
+  //RL_N2O_FEEDING_WARNING
+  {REDLINE_LEVEL, CH_N2O_FEEDING_PRESSURE, MODE_MASK_ALL,
+   0, 0, 0, REDLINE_WARNING, 0},
+
+  //RL_CHAMBER_RISE_RATE: Chamber pressure spike
+  {REDLINE_RISE_RATE, CH_CHAMBER_PRESSURE, modeBit(SEQUENCE),
+   0, 0, trendPasses, REDLINE_WARNING, 0},
+
+  //RL_N2O_FEEDING_FALL_RATE: N2O feeding pressure collapse
+  {REDLINE_FALL_RATE, CH_N2O_FEEDING_PRESSURE, modeBit(SEQUENCE),
+   0, 0, trendPasses, REDLINE_WARNING, 0}
+};
+
+static const uint8_t redlineCount = sizeof(redlines) / sizeof(redlines[0]);
+static_assert(redlineCount == REDLINE_COUNT, "Redline table doesn't match redlineNames_t");
+
+/* Vote rules. The chamber pressure redline alone triggers SAFE in every mode,
+ * it is the hard limit that no other sensor can hold back.
+ * During SEQUENCE an earlier trip needs two independent sensors to agree: the
+ * extrapolated chamber pressure and the load cell. If either one is flagged
+ * unhealthy, the other one decides alone, so a dead sensor can't hide an overpressure.
+ */
+static constexpr voteRule_t voteRules[] = {
+  {redlineBit(RL_CHAMBER_PRESSURE), 1, MODE_MASK_ALL, REDLINE_SAFE},
+  {redlineBit(RL_CHAMBER_PREDICTED) | redlineBit(RL_LOAD_OVERLOAD), 2, modeBit(SEQUENCE), REDLINE_SAFE}
+};
+
+static const uint8_t voteRuleCount = sizeof(voteRules) / sizeof(voteRules[0]);
+static_assert(MSG_FAULT_RULE + redlineCount + voteRuleCount - 1 <= maxMessageIndex, "Fault rule messages don't fit the message index");
+
+static int16_t passCount[redlineCount];
+static bool tripped[redlineCount];
+static uint16_t trippedMask;
+static uint16_t unhealthyMask;
+static uint16_t reportedUnhealthy;
+static uint8_t reportedCrossChecks;
+static int8_t lastFiredRule;
 static mode_t fetchedMode;
+static substate_t fetchedSubstate;
 static bool fetchedWarning;
 static bool activateSafe;
 static bool activateWarning;
+static int8_t safeRule;
+
+//Prefiltered copy of the measurements. The cold block is only copied when it has changed
+static values_t checkedValues;
+
+//Convert a limit of the config to the raw units of a redline
+static int16_t limitToRaw(const redline_t* redline, float limit, bool difference){
+  const config_t* config = getConfig();
+
+  if (redline->channel == CH_NOZZLE_TEMPERATURE || redline->channel == CH_PIPING_TEMPERATURE){
+    return temperatureToRaw(limit);
+  }
+
+  calibrationLine_t line = getCalibration(redline->channel);
+
+  if (redline->type == REDLINE_RISE_RATE || redline->type == REDLINE_FALL_RATE){
+    return lineRateToRaw(line, config->calibrationADC, limit);
+  }
+  if (difference){
+    return lineDeltaToADC(line, config->calibrationADC, limit);
+  }
+  return lineToADC(line, config->calibrationADC, limit);
+}
+
+static void convertLimits(){
+  const config_t* config = getConfig();
+
+  for (uint8_t i = 0; i < redlineCount; i++){
+    redlines[i].threshold = limitToRaw(&redlines[i], config->redlines[i].threshold, false);
+    redlines[i].hysteresis = limitToRaw(&redlines[i], config->redlines[i].hysteresis, true);
+  }
+}
 
 void initFaultDetect(){
-  N2OFeedingPassCount = 0;
-  chamberPassCount = 0;
-  casingPassCount = 0;
+  convertLimits();
+
+  for (uint8_t i = 0; i < redlineCount; i++){
+    passCount[i] = 0;
+    tripped[i] = false;
+  }
+  trippedMask = 0;
+  unhealthyMask = 0;
+  reportedUnhealthy = 0;
+  reportedCrossChecks = 0;
+  //The rule that triggered SAFE before a reset is still reported
+  retainedState_t retainedState;
+  getRetained(&retainedState);
+  lastFiredRule = retainedState.lastFaultRule;
+  fetchedWarning = false;
+  activateSafe = false;
+  activateWarning = false;
+  safeRule = -1;
+  checkedValues = values_t();
+}
+
+void updateFaultLimits(){
+  convertLimits();
+  updateHealthLimits();
+}
+
+//Is the redline exceeded when its threshold is lowered by the given margin
+static bool redlineExceeded(const redline_t* redline, int16_t value, int16_t margin){
+  int16_t threshold = redline->threshold - margin;
+
+  switch (redline->type){
+    case REDLINE_LEVEL:     return value > threshold;
+    case REDLINE_RISE_RATE: return slopeAbove(redline->channel, threshold);
+    case REDLINE_FALL_RATE: return slopeBelow(redline->channel, -threshold);
+    case REDLINE_PREDICTED: return predictAbove(redline->channel, value, threshold, redline->horizon);
+  }
+  return false;
+}
+
+//Number of set bits
+static uint8_t countBits(uint16_t bits){
+  uint8_t count = 0;
+  while (bits){
+    bits &= bits - 1;
+    count++;
+  }
+  return count;
+}
+
+//Apply the action of a tripped redline or fired vote rule
+static void applyAction(redlineAction_t action, int8_t rule){
+  if (action == REDLINE_SAFE){
+    if (!activateSafe){safeRule = rule;}
+    activateSafe = true;
+  }else if (action == REDLINE_WARNING){
+    activateWarning = true;
+  }
+}
+
+//Send a message of every channel that became unhealthy and every cross check that started failing
+static void reportHealth(uint16_t unhealthyChannels, uint8_t crossCheckFaults){
+  uint16_t newUnhealthy = unhealthyChannels & ~reportedUnhealthy;
+  for (uint8_t i = 0; newUnhealthy != 0; i++, newUnhealthy >>= 1){
+    if (newUnhealthy & 1){
+      saveMessage(MSG_SENSOR_UNHEALTHY + i);
+    }
+  }
+  reportedUnhealthy = unhealthyChannels;
+
+  uint8_t newCrossChecks = crossCheckFaults & ~reportedCrossChecks;
+  if (newCrossChecks & (1 << CROSS_LINE_FEED)){saveMessage(MSG_LINE_FEED_MISMATCH);}
+  if (newCrossChecks & (1 << CROSS_CHAMBER_LOAD)){saveMessage(MSG_CHAMBER_LOAD_MISMATCH);}
+  reportedCrossChecks = crossCheckFaults;
 }
 
 //Do we want to explicitly record information of passed values?
 //It can also be analysed from data after.
-void checkData(values_t values){
+void checkData(const values_t& values){
+  BENCH_ENTER(BENCH_CHECK_DATA);
   
   activateSafe = false;
   activateWarning = false;
+  safeRule = -1;
   getMode(&fetchedMode);
+  getSubstate(&fetchedSubstate);
   getWarning(&fetchedWarning);
   
+  uint8_t currentModeBit = modeBit(fetchedMode);
+
+  //Remove single sample spikes from the redline inputs. Only the checked copy of the values is filtered
+  prefilterValues(values, &checkedValues);
+
+  //Update the derivative estimators before checking the rate redlines
+  updateTrend(checkedValues);
+
+  //Update the sensor health flags and cross checks
+  updateSensorHealth(checkedValues, fetchedSubstate);
+  uint16_t unhealthyChannels = getUnhealthyChannels();
+  uint8_t crossCheckFaults = getCrossCheckFaults();
+
   //REDLINE TRIGGERS
-  
-  //N2O feeding pressure SAFE mode entry disabled for first hot flow  in version V_1.45 on (10.05.2024)
-  
-  float realN2OPressure = calibrationADC * refADC * (values.N2OFeedingPressure / maxADC);
-  realN2OPressure = pressureCalibration_K[FEEDING_PRESSURE_OXIDIZER] * realN2OPressure + pressureCalibration_B[FEEDING_PRESSURE_OXIDIZER];
-  /*
-  if (values.N2OFeedingPressure > N2OFeedingPressureThreshold){
-    N2OFeedingPassCount++;
-    if (N2OFeedingPassCount > successivePasses){
-      activateSafe = true;
+  trippedMask = 0;
+  unhealthyMask = 0;
+
+  for (uint8_t i = 0; i < redlineCount; i++){
+    const redline_t* redline = &redlines[i];
+    bool healthy = (unhealthyChannels & (1 << redline->channel)) == 0;
+
+    if (!healthy){
+      unhealthyMask |= (1 << i);
     }
-  }else{N2OFeedingPassCount = 0;}
-  */
 
-  
+    //Redlines not active in this mode or of unhealthy channels are kept released
+    if ((redline->modeMask & currentModeBit) == 0 || !healthy){
+      passCount[i] = 0;
+      tripped[i] = false;
+      continue;
+    }
 
-  float realCombustionPressure = calibrationADC * refADC * (values.combustionPressure / maxADC);
-  realCombustionPressure = pressureCalibration_K[CHAMBER_PRESSURE] * realCombustionPressure + pressureCalibration_B[CHAMBER_PRESSURE];
+    int16_t value = channelValue(checkedValues, redline->channel);
 
-  if (realCombustionPressure > chamberPressureThreshold){
-    chamberPassCount++;
-    if (chamberPassCount > successivePasses){
-      activateSafe = true;
+    if (tripped[i]){
+      if (!redlineExceeded(redline, value, redline->hysteresis)){
+        tripped[i] = false;
+        passCount[i] = 0;
+      }
+    }else if (redlineExceeded(redline, value, 0)){
+      passCount[i]++;
+      if (passCount[i] > redline->passes){
+        tripped[i] = true;
+      }
+    }else{passCount[i] = 0;}
+
+    if (tripped[i]){
+      trippedMask |= (1 << i);
+      applyAction(redline->action, i);
     }
-  }else{chamberPassCount = 0;}
+  }
 
-  //Nozzle temperature SAFE mode entry disabled for first hot flow  in version V_1.45 on (10.05.2024)
-  /*
-  
-  float realNozzleTemperature = values.nozzleTemperature * 0.25
+  //VOTE RULES
+  for (uint8_t i = 0; i < voteRuleCount; i++){
+    const voteRule_t* rule = &voteRules[i];
 
-  if (realNozzleTemperature > casingTemperatureThreshold){
-    casingPassCount++;
-    if (casingPassCount > successivePasses){
-      activateSafe = true;
+    if ((rule->modeMask & currentModeBit) == 0){
+      continue;
     }
-  }else{casingPassCount = 0;}
-  */
 
-  //WARNING TRIGGERS
-  if (realN2OPressure > N2OFeedingPressureWarning){
-      activateWarning = true;
+    //Unhealthy voters are left out and the required votes are lowered accordingly
+    uint16_t healthyVoters = rule->voters & ~unhealthyMask;
+    uint8_t votesNeeded = countBits(healthyVoters);
+    if (votesNeeded > rule->votes){
+      votesNeeded = rule->votes;
+    }
+
+    if (votesNeeded > 0 && countBits(trippedMask & healthyVoters) >= votesNeeded){
+      applyAction(rule->action, redlineCount + i);
+    }
+  }
+
+  //CROSS CHECKS
+  if (crossCheckFaults != 0){
+    activateWarning = true;
   }
+  reportHealth(unhealthyChannels, crossCheckFaults);
 
   //Affecting the modes
   if ((fetchedMode != SAFE) && (activateSafe == true)){
@@ -91,8 +303,10 @@ void checkData(values_t values){
     //What other things to trigger when entering safe mode?
     //Buzzer?
     
-    //Serial.print("Threshold Triggered!\n");
-
+    //Report which rule triggered the SAFE mode
+    lastFiredRule = safeRule;
+    retainFaultRule(lastFiredRule);
+    saveMessage(MSG_FAULT_RULE + safeRule);
   }
 
   /* Checks if the determined warning status is different from the current status.
@@ -101,18 +315,17 @@ void checkData(values_t values){
    */ 
   if (fetchedWarning != activateWarning){
     setWarning(activateWarning);
-    setBuzzer(activateWarning);
-    /*
     if (activateWarning == true){
       startBuzzerPattern(BUZZER_WARNING);
     }
-    else{
+    else if (getBuzzerPattern() == BUZZER_WARNING){
       startBuzzerPattern(BUZZER_OFF);
     }
-    */
   }
 
-  
-
+  BENCH_EXIT(BENCH_CHECK_DATA);
+}
 
+int8_t getLastFaultRule(){
+  return lastFiredRule;
 }
@@ -20,13 +20,31 @@
  */
 void initFaultDetect(void);
 
-/* Function:      Compares all the newest measurements against safety limits.
- *                If there are violations, change the mode and send a report
- *                using a serial message.
+/* Function:      Convert the redline limits and the limits of the SensorHealth
+ *                object again from the config, after a tare has moved the zero
+ *                of the calibration lines. The fault states are kept.
  *
- * IN:            values_t data struct containing all the newest measurements.
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void updateFaultLimits(void);
+
+/* Function:      Compares all the newest measurements against the redline table
+ *                in FaultDetection.cpp. If there are violations, change the mode
+ *                and/or activate the warning.
+ *
+ * IN:            Reference to a values_t struct containing all the newest measurements.
  * OUT:           Nothing
  */
-void checkData(values_t values);
+void checkData(const values_t& values);
+
+
+/* Function:      Get the rule that last triggered the SAFE mode
+ *
+ * IN:            Nothing
+ * OUT:           redlineNames_t of the redline, REDLINE_COUNT + index of the
+ *                vote rule, or -1 if SAFE has not been triggered
+ */
+int8_t getLastFaultRule(void);
 
 #endif
\ No newline at end of file
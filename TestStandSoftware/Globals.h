@@ -10,7 +10,7 @@
  */
 
 #include <stdint.h>
-#include <Arduino.h>
+#include "Hal.h"
 
 //Prevent multiple definitions with the if statement
 #ifndef GLOBALS_H
@@ -43,53 +43,23 @@ typedef enum {
   SW_RESET_PIN = 35                   //Port C2
 } pin_names_t;
 
-//Pins for port manipulation - For Speeeeeeeed
-typedef enum {
-  AUTO_TEST_START_PIN_PORTA = PORTA1,           //Port A1
-  THERMOCOUPLE_CS_PIN0_PORTA = PORTA2,          //Port A2
-  THERMOCOUPLE_CS_PIN1_PORTA = PORTA4,          //Port A4
-  IGN_SW_RELAY_TEST_PIN_PORTA = PORTA5,         //Port A5
-  THERMOCOUPLE_CS_PIN2_PORTA = PORTA6,          //Port A6
-  IGN_GND_RELAY_TEST_DRIVE_PIN_PORTA = PORTA7   //Port A7
-}portA_t;
-
-typedef enum {
-  DUMP_VALVE_BUTTON_PIN_PORTB = PORTB4,         //Port B4
-  IGNITER_CONTROL_PIN_PORTB = PORTB6           //Port B6
-}portB_t;
-
-typedef enum {  
-  THERMOCOUPLE_CS_PIN3_PORTC = PORTC7,          //Port C7
-  MAIN_VALVE_TEST_PIN_PORTC = PORTC6,           //Port C6
-  REPEAT_SEQUENECE_PIN_PORTC = PORTC4,          //Port C4
-  SW_RESET_PIN_PORTC = PORTC2                   //Port C2
-}portC_t;
-
-
-typedef enum {
-  BUZZER_CONTROL_PIN_PORTD = PORTD2,            //Port D2
-  MAIN_VALVE_BUTTON_PIN_PORTD = PORTD1,         //Port D1
-  FEEDING_VALVE_BUTTON_PIN_PORTD = PORTD0       //Port D0
-}portD_t;
-
-
-typedef enum {
-  CAMERA_TRIGGER_PIN_PORTE = PORTE3,            //Port E3
-  OXIDIZER_VALVE_PIN_PORTE = PORTE4,            //Port E4
-  DUMP_VALVE_PIN_PORTE = PORTE5,                //Port E5
-}portE_t;
-
+//The ports and bits of the pins are resolved at compile time by Gpio.h
 
+//Bits of the digital input snapshot latched once per loop by the DigitalInputs object.
+//The bits hold the raw pin levels, pullup inputs are inverted by the reader.
+//The inputs read every loop in SEQUENCE are kept in the low byte.
 typedef enum {
-  N2FEEDING_VALVE_PIN_PORTG = PORTG5,           //Port G5
-}portG_t;
-
-typedef enum {
-  TEST_MODE_LED_PIN_PORTH = PORTH3,             //Port H3   //In V1 the indicator LEDs use the servo connector
-  REPEAT_SEQUENCE_LED_PIN_PORTH = PORTH4,       //Port H4   //In V1 the indicator LEDs use the servo connector
-  IGNITION_SENSE_PIN_PORTH = PORTH5,            //Port H5
-  HEATING_SENSE_PIN_PORTH = PORTH6,             //Port H6
-}portH_t;
+  IN_MAIN_VALVE_TEST        = 1 << 0,   //Port C6
+  IN_IGN_SW_RELAY_TEST      = 1 << 1,   //Port A5
+  IN_DUMP_VALVE_BUTTON      = 1 << 2,   //Port B4
+  IN_IGNITION_SENSE         = 1 << 3,   //Port H5
+  IN_HEATING_SENSE          = 1 << 4,   //Port H6
+  IN_FEEDING_VALVE_BUTTON   = 1 << 5,   //Port D0
+  IN_MAIN_VALVE_BUTTON      = 1 << 6,   //Port D1
+  IN_AUTO_TEST_START        = 1 << 8,   //Port A1, pullup
+  IN_REPEAT_SEQUENCE        = 1 << 9,   //Port C4, pullup
+  IN_SW_RESET               = 1 << 10   //Port C2, pullup
+}digitalInput_t;
 
 //Pin Enumerators for Analog Pins
 typedef enum {
@@ -181,13 +151,15 @@ const int16_t testAnalogCount = 1;
 
 //Structure for storing the timings of buzzer message patterns
 struct buzzerTiming_t{
-  /* NOT CURRENTLY USED
+  /* Played by the Buzzer object
    * First index is number of cylces (0=indefinite)
    * Rest are timing in milliseconds of beign ON and OFF repeating.
    */
   int16_t warning[3] = {0, 750, 250};
-  int16_t reset[2] = {1, 1000};
+  int16_t reset[2] = {1, 500};
   int16_t test[7] = {1, 200, 200, 200, 200, 200, 200};
+  int16_t tareDone[3] = {2, 100, 100};
+  int16_t tareFailed[2] = {1, 1500};
 };
 
 //Enumeration of buzzer patterns
@@ -195,7 +167,9 @@ typedef enum{
   BUZZER_OFF,
   BUZZER_WARNING,
   BUZZER_RESET,
-  BUZZER_TEST
+  BUZZER_TEST,
+  BUZZER_TARE_DONE,
+  BUZZER_TARE_FAILED
 }buzzerPattern_t;
 
 //Not used anymore since FreeRTOS isn't used
@@ -254,6 +228,83 @@ const int16_t cameraTriggerTime = valveOffTime + 2000;
 //How long from sequence start until the end of purging (ms)
 const int16_t purgingTime = oxidiserEmptyTime + 4*1000;  //Placeholder value
 
+//How long the camera trigger pulse is held high after a reset (ms)
+const int16_t cameraResetPulseTime = 500;
+
+//Outputs driven by the hardware timed one-shot pulses of the Pulse object
+typedef enum {
+  PULSE_IGNITER,      //Timer1 OC1B, IGNITER_CONTROL_PIN
+  PULSE_CAMERA        //Timer3 OC3A, CAMERA_TRIGGER_PIN
+} pulseChannel_t;
+
+const int16_t pulseChannelCount = 2;
+
+//Resolution of the pulse timers (us). Timers 1 and 3 run with a prescaler of 64
+const int16_t pulseTickMicros = 4;
+
+//Bits of pulseEdges_t.flags
+const uint8_t PULSE_ROSE = 1;       //riseMicros is valid
+const uint8_t PULSE_FELL = 2;       //fallMicros is valid
+const uint8_t PULSE_CANCELLED = 4;  //Pulse was stopped before the programmed end, fallMicros is the time of the cancel
+
+//Edge times of the latest pulse of a channel, in the micros() timebase
+struct pulseEdges_t {
+  pulseChannel_t channel;
+  uint8_t flags;
+  uint32_t riseMicros;
+  uint32_t fallMicros;
+};
+
+/* Auxiliary frames are sent in between the data lines. The first byte is the frame ID.
+ * Their length must never be 3, 12 or 20 bytes, which are reserved for the data lines,
+ * and at most 19 bytes, since the Rock reader cuts frames at 20 bytes.
+ */
+typedef enum {
+  AUX_FRAME_PULSE = 1,          //channel, flags, rise us (4 bytes), fall us (4 bytes)
+  AUX_FRAME_PROFILE = 2,        //phase, count, min, max, mean (2 bytes each, 4us ticks), histogram (profileHistogramBins bytes)
+  AUX_FRAME_TIMING = 3,         //mode, samples (4 bytes), misses (2 bytes), max lateness us (2 bytes), histogram (timingHistogramBins bytes)
+  AUX_FRAME_EXECUTIVE = 4,      //mode, frame overruns (2 bytes), budget overruns of each task_t (2 bytes each)
+  AUX_FRAME_BOOT = 5,           //MCUSR reset flags, warm start, restored mode, warm restarts (2 bytes), stall phase, watchdog stalls (2 bytes). Once after a reset
+  AUX_FRAME_CONFIG = 6,         //chunk index, configSource_t, configChunkBytes bytes of the config_t block in the AVR layout
+  AUX_FRAME_ACK = 7,            //command sequence, commandId_t, ackStatus_t, bad uplink frames (2 bytes). Answers every command
+  AUX_FRAME_STATISTICS = 8,     //sensorChannel_t, mode, samples, min, max, mean, standard deviation (2 bytes each). Each channel after every slow sample
+  AUX_FRAME_BURN = 9,           //burnFlags_t, total impulse (4 bytes), peak and average thrust, peak chamber pressure, rise time, burn duration (2 bytes each)
+  AUX_FRAME_BURN_EVENT = 10,    //burnEventType_t, sensorChannel_t, us since the igniter command (4 bytes), us since the valve command (4 bytes)
+  AUX_FRAME_TASK_TIMES = 11     //mode, longest run of each task_t in the mode (2 bytes each, 4us ticks)
+} auxFrameId_t;
+
+const uint8_t pulseFrameLength = 11;
+
+//Phases of the countdown tasks timed by the Profiler object. Only compiled in with -DPROFILE_BUILD
+typedef enum {
+  PHASE_TEST_INPUT,       //getTestInput()
+  PHASE_LATEST_VALUES,    //forwardGetLatestValues()
+  PHASE_CHECK,            //sendToCheck()
+  PHASE_OUTPUTS,          //Dump valve, and outside SEQUENCE the software reset and manual valves
+  PHASE_MODE_SWITCH,      //Mode and substate switch case
+  PHASE_SERIAL            //Data lines and the pulse, timing and executive frames
+} loopPhase_t;
+
+const uint8_t loopPhaseCount = PHASE_SERIAL + 1;
+
+//Histogram bin i holds the phase durations under 16us << i, the last one the rest
+const uint8_t profileHistogramBins = 8;
+
+//How often one phase is sent in an AUX_FRAME_PROFILE frame (ms). The statistics of the phase restart after it is sent
+const uint16_t profileFrameInterval = 200;
+
+const uint8_t profileFrameLength = 10 + profileHistogramBins;
+
+//Statistics of a loop phase, durations in Timer1 ticks (4us)
+struct profileStats_t {
+  loopPhase_t phase;
+  uint16_t count;
+  uint16_t minTicks;
+  uint16_t maxTicks;
+  uint16_t meanTicks;
+  uint8_t histogram[profileHistogramBins];   //Share of the samples in each bin, 255 = all
+};
+
 //How many valves the system has
 const int16_t valveCount = 3; 
 
@@ -278,28 +329,34 @@ const int16_t loadCellCount = 1;
 //How many total measurements per loop. Equal to the total count of sensors.
 const int16_t sensorCount = pressureCount5V + pressureCount20mA + tempCount + infraCount;
 
-//Structure for storing measurements with a timestamp
-struct values_t {
-  uint64_t timestamp;           //Time since Arduino startup in us
-  //uint64_t lastTimestamp;       //Time when last sensor values were read
-  uint32_t msTimestamp;         //Time since Arduino startup in ms
-  uint64_t checkTimestamp;      //Used to detect overflow of 32bit microsecond timer
-  uint64_t timeOverflowOffset;  //How many microseconds have been lost to 32bit overflow
-
-  bool slowUpdated = false;     //If the slow frequency values were updated this loop
-  bool mediumUpdated = false;     //If the medium frequency values were updated this loop 
-  
-  int N2FeedingPressure;        //N2 Feeding line pressure 
-  int linePressure;      //Line pressure 
-  int combustionPressure;      //Combustion chamber pressure 
-  int N2OFeedingPressure;      //Oxidizer Feeding pressure 
-  int loadCell;       //Back of the engine
-  int bottleTemperature;   //Bottle temperature - Switched to TMP36 output, uses different pin
-  int notConnectedTemperature;   //Injector temperature - Usually outputs NaN, not used in live_grapher_V3.py
-  int nozzleTemperature;   //Nozzle temperature
-  int pipingTemperature;   //Piping temperature 
-  int IR;             //Plume Temperature
-  
+/* The measurements are split by how often they change. The hot block is written
+ * on every loop, also in the SEQUENCE burst mode. The cold block only changes when
+ * mediumUpdated or slowUpdated is set, so the burst mode loop doesn't touch it.
+ * The sensor values are raw ADC counts or raw MAX31855 readings, sized to 16 bits.
+ */
+
+//Fast rate channels, sampled on every loop
+struct hotValues_t {
+  uint32_t tick;                    //Sample time in Timebase ticks (4us), wraps every 4.77 hours
+  uint16_t combustionPressure;      //Combustion chamber pressure
+  uint16_t loadCell;                //Back of the engine
+};
+
+//Medium and slow rate channels and the control buttons
+struct coldValues_t {
+  bool slowUpdated;                 //If the slow frequency values were updated this loop
+  bool mediumUpdated;               //If the medium frequency values were updated this loop
+
+  uint16_t N2FeedingPressure;       //N2 Feeding line pressure
+  uint16_t linePressure;            //Line pressure
+  uint16_t N2OFeedingPressure;      //Oxidizer Feeding pressure
+  uint16_t bottleTemperature;       //Bottle temperature - Switched to TMP36 output, uses different pin
+  int16_t notConnectedTemperature;  //Injector temperature - Usually outputs NaN, not used in live_grapher_V3.py
+  int16_t nozzleTemperature;        //Nozzle temperature
+  int16_t pipingTemperature;        //Piping temperature
+  uint16_t IR;                      //Plume Temperature
+  uint8_t temperatureFaults;        //MAX31855 fault bit of each thermocouple, bit = tempSensorNames_t
+
   bool dumpValveButton;             //Is dump valve button pressed (normally open)
   bool heatingBlanketButton;        //Is heating button pressed
   bool ignitionButton;              //Is ignition button pressed
@@ -307,6 +364,16 @@ struct values_t {
   bool oxidizerValveButton;         //Is the oxidizer valve button pressed (normally closed)
 };
 
+//Structure for storing measurements with a timestamp
+struct values_t {
+  hotValues_t hot;
+  coldValues_t cold;
+};
+
+//How many copies getLatest() tries before copying the latest values with interrupts
+//disabled. A copy is retried when setLatest() ran during it
+const uint8_t latestReadAttempts = 3;
+
 //Structure for holding the internal state of the software and control system.
 struct statusValues_t{
   bool valveActive;             //Is the valve opened by the software
@@ -331,7 +398,232 @@ const int16_t limitedSampleRate = 50;
 const int32_t targetSampleRate = 5000;
 const int32_t usPerSample = 1000000 / targetSampleRate;
 
-//At what rate the certain data is gathered (hz)
+//Resolution of the Timer1 timebase (us), see Timebase.cpp
+const uint32_t timebaseTickMicros = 4;
+const uint32_t ticksPerSample = usPerSample / timebaseTickMicros;
+
+//Sample period outside SEQUENCE (us)
+const uint32_t limitedSamplePeriod = 1000000 / limitedSampleRate;
+
+//The samples are released by the frame clock of the cyclic executive, but the interval
+//of two samples can still read one tick long at the 4us resolution. Added to the deadlines
+const uint32_t sampleIntervalTolerance = timebaseTickMicros;
+
+//Lateness histogram of the samples, relative to the deadline d of the mode:
+//0: on time, 1: <d/8, 2: <d/4, 3: <d/2, 4: <d, 5: <2d, 6: <4d, 7: the rest
+const uint8_t timingHistogramBins = 8;
+
+//How often the sample timing of the current mode is sent in an AUX_FRAME_TIMING frame (ms).
+//The final statistics of a mode are also sent once when the mode changes
+const uint16_t timingFrameInterval = 500;
+
+const uint8_t timingFrameLength = 10 + timingHistogramBins;
+
+//Sample timing statistics of senseLoop() since the current mode was entered
+struct sampleTiming_t {
+  mode_t mode;
+  uint32_t samples;
+  uint16_t misses;          //Samples later than the deadline, saturates
+  uint16_t maxLateness;     //us, saturates
+  uint8_t histogram[timingHistogramBins];   //Share of the samples in each bin, 255 = all
+};
+
+//Tasks of the cyclic executive. Tasks due in the same frame run in this order
+typedef enum {
+  TASK_SENSE,           //Digital input snapshot, test inputs and senseLoop()
+  TASK_CHECK,           //FaultDetection
+  TASK_SEQUENCE,        //Dump and manual valves, software reset and the mode switch case
+  TASK_VERIFICATION,    //TEST mode verification sequence
+  TASK_COMMS,           //Data lines and auxiliary frames
+  TASK_INDICATORS,      //Repeat sequence LED
+  TASK_STATISTICS       //Channel statistics, outside SEQUENCE also reads the analog channels between the samples
+} task_t;
+
+const uint8_t taskCount = TASK_STATISTICS + 1;
+
+//A task in a schedule of the cyclic executive
+struct executiveTask_t {
+  void (*run)(void);
+  uint8_t period;           //Minor frames between runs, 0 = not run in this schedule
+  uint8_t offset;           //Minor frame of the period the task runs in
+  uint16_t budgetTicks;     //Execution time budget in Timer1 ticks (4us)
+};
+
+//Frame table of the cyclic executive. The task periods must divide majorFrame
+struct schedule_t {
+  uint16_t frameTicks;      //Minor frame in Timer1 ticks (4us)
+  uint8_t majorFrame;       //Minor frames in a major frame
+  executiveTask_t tasks[taskCount];
+};
+
+//Sum of the budgets of the tasks running in a minor frame of a schedule
+constexpr uint16_t frameBudget(const schedule_t& schedule, uint8_t frame, uint8_t task = 0){
+  return task == taskCount ? 0 :
+         ((schedule.tasks[task].period != 0
+           && (frame + schedule.tasks[task].period - schedule.tasks[task].offset) % schedule.tasks[task].period == 0)
+          ? schedule.tasks[task].budgetTicks : 0) + frameBudget(schedule, frame, task + 1);
+}
+
+//Do the budgets of every minor frame of a schedule fit in the frame
+constexpr bool budgetsFit(const schedule_t& schedule, uint8_t frame = 0){
+  return frame == schedule.majorFrame ||
+         (frameBudget(schedule, frame) <= schedule.frameTicks && budgetsFit(schedule, frame + 1));
+}
+
+//Minor frame of the executive outside SEQUENCE (us). The tasks are spread over the
+//frames of one sample period, so no single frame holds the whole loop
+const uint32_t limitedFrameMicros = 1000;
+const uint8_t limitedMajorFrame = limitedSamplePeriod / limitedFrameMicros;
+
+//Release of the next minor frame is moved ahead if it is closer than this to the timer (ticks)
+const uint16_t frameMinLead = 2;
+
+//How often the executive overrun counts are sent in an AUX_FRAME_EXECUTIVE frame (ms)
+const uint16_t executiveFrameInterval = 1000;
+
+const uint8_t executiveFrameLength = 4 + 2 * taskCount;
+const uint8_t taskTimesFrameLength = 2 + 2 * taskCount;
+
+/* Burn metrics integrated by the Burn object from the opening of the main valve until the
+ * sequence reaches PURGING or is aborted. The thrust is integrated above the tared zero of
+ * the load cell. Readings below the zero are integrated as negative thrust, so the noise of
+ * the load cell around the zero cancels out instead of adding to the impulse. The burn
+ * duration is the time the thrust is above loadCellBurnThrust, the rise time is the time
+ * of the chamber pressure from 10% to 90% of its peak above zero, see burnLevelShift.
+ * If the thrust never reached loadCellBurnThrust or the load cell was unhealthy during the
+ * burn, BURN_NO_THRUST is set and the thrust metrics are sent as 0.
+ */
+//Bits of the flags of a burn summary
+typedef enum{
+  BURN_VALID = 1,             //A burn was integrated
+  BURN_ABORTED = 2,           //The sequence was left before PURGING, the burn may be cut short
+  BURN_RESTORED = 4,          //Kept over a reset by the Retained object
+  BURN_NO_THRUST = 8          //No thrust was measured, the impulse, thrust and duration are 0
+}burnFlags_t;
+
+//The thrust is integrated in 1/burnFraction ADC counts
+const int16_t burnFraction = 16;
+
+//How often the last burn summary is sent again outside SEQUENCE (ms)
+const uint16_t burnFrameInterval = 10000;
+
+const uint8_t burnFrameLength = 16;
+
+//Summary of the last burn, sent in an AUX_FRAME_BURN frame
+struct burnSummary_t {
+  uint8_t flags;                //burnFlags_t bits, 0 if there has been no burn
+  int32_t totalImpulse;         //0.1 Ns
+  int16_t peakThrust;           //N
+  int16_t averageThrust;        //N, total impulse over the burn duration
+  int16_t peakPressure;         //0.01 bar, chamber
+  uint16_t riseTime;            //0.1 ms, saturates
+  uint16_t burnDuration;        //ms, saturates
+};
+
+/* Events of the burn detected by the BurnEvents object on the chamber pressure and the load
+ * cell, after the igniter has been commanded. A channel is burning above its burn level
+ * (chamberBurnPressure, loadCellBurnThrust) and stops burning below the level minus the
+ * hysteresis. The slopes are the derivative estimates of the Trend object, which follow the
+ * noise of a few samples: in the steady state the chamber pressure slope varies by tens of
+ * bar/s. The steady band is wide for that reason, and the tail-off is a level crossing.
+ */
+typedef enum{
+  BURN_EVENT_IGNITION = 0,    //A channel started burning while rising faster than its ignition rate
+  BURN_EVENT_STEADY = 1,      //The chamber pressure slope stayed within the steady rate for burnEventSteadyTime
+  BURN_EVENT_TAIL_OFF = 2,    //The chamber pressure fell below burnEventTailOffPercent of the steady state while falling
+  BURN_EVENT_FLAME_OUT = 3    //Both channels stopped burning
+}burnEventType_t;
+
+//Commands the events are timed from
+typedef enum{
+  BURN_COMMAND_IGNITER = 0,
+  BURN_COMMAND_VALVE = 1
+}burnCommand_t;
+
+//Release hysteresis of the burn levels
+constexpr float burnEventPressureHysteresis = 1;  //Placeholder value (bar)
+constexpr float burnEventThrustHysteresis = 30;   //Placeholder value (N)
+
+//Slopes of the ignition, steady state and tail-off
+constexpr float burnEventIgnitionRate = 20;       //Placeholder value (bar/s)
+constexpr float burnEventThrustRate = 500;        //Placeholder value (N/s)
+constexpr float burnEventSteadyRate = 50;         //Placeholder value (bar/s), both directions
+constexpr float burnEventTailOffRate = 20;        //Placeholder value (bar/s), falling
+
+//How long the slope has to stay within the steady rate, the event is timed at the start (ms).
+//The steady state pressure is the mean of the chamber pressure over this time
+const uint16_t burnEventSteadyTime = 50;
+
+//Chamber pressure of the tail-off, percent of the steady state pressure above 0 bar
+const uint8_t burnEventTailOffPercent = 80;
+
+//Events waiting to be sent, the oldest one is dropped when the queue is full
+const uint8_t burnEventQueueLength = 4;
+
+//Time of an event from a command that was not given during the burn
+const int32_t burnEventNoCommand = INT32_MIN;
+
+const uint8_t burnEventFrameLength = 11;
+
+//Event of the burn, sent in an AUX_FRAME_BURN_EVENT frame. The times are interpolated
+//between the samples around the level crossing or the start of the slope range
+struct burnEvent_t {
+  uint8_t type;                 //burnEventType_t
+  uint8_t channel;              //sensorChannel_t that decided the event
+  int32_t sinceIgniter;         //us from the igniter command, burnEventNoCommand if not given
+  int32_t sinceValve;           //us from the valve command, burnEventNoCommand if not given
+};
+
+//State kept over a reset in the .noinit RAM by the Retained object. Only used
+//after a reset that was not a power-on, and when the checksum matches
+struct retainedState_t {
+  uint8_t layout;               //retainedLayout of the firmware that wrote the state
+  mode_t mode;                  //INIT after a requested software reset
+  substate_t substate;
+  bool verificationPassed;
+  int8_t lastFaultRule;         //See getLastFaultRule()
+  uint16_t warmRestarts;        //Restarts with a valid state since the last cold boot, saturates
+  uint8_t stallPhase;           //Task of the executive when the watchdog expired, noStall if none
+  uint16_t watchdogStalls;      //Watchdog expiries since the last cold boot, saturates
+  burnSummary_t burn;           //Summary of the last burn
+  uint16_t checksum;            //Fletcher-16 of the fields above
+};
+
+//Changed whenever retainedState_t changes, so a new firmware never reads an old layout
+const uint8_t retainedLayout = 3;
+
+//Timeout of the watchdog reset requested by the software, WDTO_x
+const uint8_t softwareResetTimeout = WDTO_15MS;
+
+//Timeout of the task supervision, WDTO_x. Must be longer than the major frame of every schedule.
+//The interrupt forces the actuators safe after one timeout and the reset follows after another
+const uint8_t watchdogTimeout = WDTO_60MS;
+
+//Stall phase: the task_t started last, stallInTask is set if the task had not returned
+const uint8_t stallInTask = 0x80;
+const uint8_t noStall = 0xFF;
+
+const uint8_t bootFrameLength = 9;
+
+//Sent once after a reset in an AUX_FRAME_BOOT frame
+struct bootReport_t {
+  uint8_t resetFlags;           //MCUSR of this boot, PORF, EXTRF, BORF, WDRF bits
+  bool warmStart;
+  mode_t restoredMode;          //Mode the system started in
+  uint16_t warmRestarts;
+  uint8_t stallPhase;           //Stall phase of the watchdog expiry that caused this reset, noStall if none
+  uint16_t watchdogStalls;
+};
+
+//Overruns of the cyclic executive since startup, the counts saturate, and the run times of the mode
+struct executiveStats_t {
+  mode_t mode;
+  uint16_t frameOverruns;               //Minor frames released while the previous frame was still running
+  uint16_t taskOverruns[taskCount];     //Task runs longer than their budget
+  uint16_t maxTaskTicks[taskCount];     //Longest run of each task since the mode was entered (Timer1 ticks)
+};
+
+//At what rate the certain data is gathered (hz). Defaults after a reset, CMD_SET_RATES changes them
 const uint16_t slowSensorRate = 10;
 const uint16_t mediumSensorRate = 100;
 
@@ -345,16 +637,16 @@ const uint16_t mediumSensorRate = 100;
 const int16_t resolutionADC = 10;
 
 //Maximum ADC value
-const int16_t maxADC = pow(2, resolutionADC) - 1;
+const int16_t maxADC = (1 << resolutionADC) - 1;
 
 //Optimal ADC reference voltage
-const float refADC = 5.00;
+constexpr float refADC = 5.00;
 
 //Measured ADC reference voltage
-const float measuredADC = 5.00;
+constexpr float measuredADC = 5.00;
 
 //ADC calibration multiplier
-const float calibrationADC = measuredADC / refADC;
+constexpr float calibrationADC = measuredADC / refADC;
 
 //Mode to start in
 const mode_t startMode = INIT;
@@ -378,55 +670,67 @@ typedef enum{
 const int16_t maxPressure5V_100Bar = 100;
 const int16_t maxPressure5V_25Bar = 25;
 
+//Calibration line of a sensor: value = K * voltage + B
+struct calibrationLine_t {
+  float K;
+  float B;
+};
+
 //Pressure sensor calibration data for pressure sensor 0 (Serial No: 667662) OXIDIZER FEEDING
-const float pressureZero0 = -0.003;                           //Voltage
-const float pressureSpan0 = 5.003;                            //Voltage
-const float pressureLinearity0 = 0.12493;                     //in precentage. Not used for calibration
-const float pressureLine_K0 = maxPressure5V_100Bar / pressureSpan0;  //Slope of the calibrated data
+constexpr float pressureZero0 = -0.003;                           //Voltage
+constexpr float pressureSpan0 = 5.003;                            //Voltage
+constexpr float pressureLinearity0 = 0.12493;                     //in precentage. Not used for calibration
+constexpr float pressureLine_K0 = maxPressure5V_100Bar / pressureSpan0;  //Slope of the calibrated data
 //Zero offset of the calibrated data
-const float maunalPressureOffset0 = 0;                        //How many bars of offset is seen in experimental data
-const float pressureLine_B0 = maxPressure5V_100Bar - pressureLine_K0 * (pressureSpan0 + pressureZero0) - maunalPressureOffset0;
+constexpr float maunalPressureOffset0 = 0;                        //How many bars of offset is seen in experimental data
+constexpr float pressureLine_B0 = maxPressure5V_100Bar - pressureLine_K0 * (pressureSpan0 + pressureZero0) - maunalPressureOffset0;
 
 //Pressure sensor calibration data for pressure sensor 1 (Serial No: 1073014) LINE
-const float pressureZero1 = 0.01;                             //Voltage
-const float pressureSpan1 = 4.997;                            //Voltage
-const float pressureLinearity1 = 0.10154;                     //in percent. Not used for calibration
-const float pressureLine_K1 = maxPressure5V_100Bar / pressureSpan1;  //Slope of the calibrated data
+constexpr float pressureZero1 = 0.01;                             //Voltage
+constexpr float pressureSpan1 = 4.997;                            //Voltage
+constexpr float pressureLinearity1 = 0.10154;                     //in percent. Not used for calibration
+constexpr float pressureLine_K1 = maxPressure5V_100Bar / pressureSpan1;  //Slope of the calibrated data
 //Zero offset of the calibrated data
-const float maunalPressureOffset1 = 0;                        //How many bars of offset is seen in experimental data
-const float pressureLine_B1 = maxPressure5V_100Bar - pressureLine_K1 * (pressureSpan1 + pressureZero1) - maunalPressureOffset1;
+constexpr float maunalPressureOffset1 = 0;                        //How many bars of offset is seen in experimental data
+constexpr float pressureLine_B1 = maxPressure5V_100Bar - pressureLine_K1 * (pressureSpan1 + pressureZero1) - maunalPressureOffset1;
 
 //Pressure sensor calibration data for pressure sensor 2 (Serial No: 1040112) CHAMBER
-const float pressureZero2 = 0.000;                            //Voltage
-const float pressureSpan2 = 4.996;                            //Voltage
-const float pressureLinearity2 = 0.03146;                     //in precentage. Not used for calibration
-const float pressureLine_K2 = maxPressure5V_25Bar / pressureSpan2;  //Slope of the calibrated data
+constexpr float pressureZero2 = 0.000;                            //Voltage
+constexpr float pressureSpan2 = 4.996;                            //Voltage
+constexpr float pressureLinearity2 = 0.03146;                     //in precentage. Not used for calibration
+constexpr float pressureLine_K2 = maxPressure5V_25Bar / pressureSpan2;  //Slope of the calibrated data
 //Zero offset of the calibrated data
-const float maunalPressureOffset2 = 0;                        //How many bars of offset is seen in experimental data
-const float pressureLine_B2 = maxPressure5V_25Bar - pressureLine_K2 * (pressureSpan2 + pressureZero2) - maunalPressureOffset2;
+constexpr float maunalPressureOffset2 = 0;                        //How many bars of offset is seen in experimental data
+constexpr float pressureLine_B2 = maxPressure5V_25Bar - pressureLine_K2 * (pressureSpan2 + pressureZero2) - maunalPressureOffset2;
 
 //Pressure sensor calibration data for pressure sensor 3 (Serial No: 1086286) NITROGEN FEEDING
-const float pressureZero3 = -0.005;                           //Voltage
-const float pressureSpan3 = 5.007;                            //Voltage
-const float pressureLinearity3 = 0.03709;                     //in precentage. Not used for calibration
-const float pressureLine_K3 = maxPressure5V_100Bar / pressureSpan3;  //Slope of the calibrated data
+constexpr float pressureZero3 = -0.005;                           //Voltage
+constexpr float pressureSpan3 = 5.007;                            //Voltage
+constexpr float pressureLinearity3 = 0.03709;                     //in precentage. Not used for calibration
+constexpr float pressureLine_K3 = maxPressure5V_100Bar / pressureSpan3;  //Slope of the calibrated data
 //Zero offset of the calibrated data
-const float maunalPressureOffset3 = 0;                        //How many bars of offset is seen in experimental data
-const float pressureLine_B3 = maxPressure5V_100Bar - pressureLine_K3 * (pressureSpan3 + pressureZero3) - maunalPressureOffset3;
+constexpr float maunalPressureOffset3 = 0;                        //How many bars of offset is seen in experimental data
+constexpr float pressureLine_B3 = maxPressure5V_100Bar - pressureLine_K3 * (pressureSpan3 + pressureZero3) - maunalPressureOffset3;
 
 //---NOT ATTACHED---
 //Pressure sensor calibration data for pressure sensor 4 (Serial No: 1086284) OXIDIZER FEEDING BACKUP
-const float pressureZero4 = -0.005;                           //Voltage
-const float pressureSpan4 = 5.035;                            //Voltage
-const float pressureLinearity4 = 0.14196;                     //in precentage. Not used for calibration
-const float pressureLine_K4 = maxPressure5V_100Bar / pressureSpan4;  //Slope of the calibrated data
+constexpr float pressureZero4 = -0.005;                           //Voltage
+constexpr float pressureSpan4 = 5.035;                            //Voltage
+constexpr float pressureLinearity4 = 0.14196;                     //in precentage. Not used for calibration
+constexpr float pressureLine_K4 = maxPressure5V_100Bar / pressureSpan4;  //Slope of the calibrated data
 //Zero offset of the calibrated data
-const float maunalPressureOffset4 = 0;                        //How many bars of offset is seen in experimental data
-const float pressureLine_B4 = maxPressure5V_100Bar - pressureLine_K4 * (pressureSpan4 + pressureZero4) - maunalPressureOffset4;
-
-//Arrays of 5V pressure sensors calibration data
-const float pressureCalibration_K[pressureCount5V] = {pressureLine_K0, pressureLine_K1, pressureLine_K2, pressureLine_K3};
-const float pressureCalibration_B[pressureCount5V] = {pressureLine_B0, pressureLine_B1, pressureLine_B2, pressureLine_B3};
+constexpr float maunalPressureOffset4 = 0;                        //How many bars of offset is seen in experimental data
+constexpr float pressureLine_B4 = maxPressure5V_100Bar - pressureLine_K4 * (pressureSpan4 + pressureZero4) - maunalPressureOffset4;
+
+//5V pressure sensors calibration data in the order of pressureSensorNames_t.
+//Default of the Config object, used when the EEPROM holds no valid config block.
+//The manual offsets are left at 0, the zero is measured on the device by a tare
+constexpr calibrationLine_t pressureCalibration[pressureCount5V] = {
+  {pressureLine_K0, pressureLine_B0},
+  {pressureLine_K1, pressureLine_B1},
+  {pressureLine_K2, pressureLine_B2},
+  {pressureLine_K3, pressureLine_B3}
+};
 
 //Current (20mA) pressure sensor minimum and maximum values
 const int16_t minPressureCurrent = 4;     //(mA)
@@ -463,12 +767,15 @@ const int16_t minLoad = 0;
 const int16_t maxLoad = 250 * 4.44822;  //Conversion to Newtons
 
 //Load cell calibration data.
-const float loadCellZeroPointVoltage = 0.5; //Placeholder value
-const float loadCellSpan = 4.0; //Placeholder value
+constexpr float loadCellZeroPointVoltage = 0.5; //Placeholder value
+constexpr float loadCellSpan = 4.0; //Placeholder value
 
-const float loadCellLine_K = maxLoad / loadCellSpan; //Slope of the calibrated data
+constexpr float loadCellLine_K = maxLoad / loadCellSpan; //Slope of the calibrated data
 //Zero offset of the calibrated data
-const float loadCellLine_B = maxLoad - loadCellLine_K * (loadCellSpan + loadCellZeroPointVoltage);
+constexpr float loadCellLine_B = maxLoad - loadCellLine_K * (loadCellSpan + loadCellZeroPointVoltage);
+
+//Default of the Config object. A tare replaces the placeholder zero point
+constexpr calibrationLine_t loadCellCalibration = {loadCellLine_K, loadCellLine_B};
 
 //How many measurements are taken per value to reduce noise on the load cell
 const int16_t loadCellAverageCount = 4;
@@ -496,17 +803,31 @@ const int16_t minimumFiringPressure = -1;  //Set to -1 bar to always allow the f
 //Software has no ability to control the heating blanket in the current design.
 const int16_t feedingTemperatureLimit = 35;  //Placeholder value
 
-//Buzzer warning length (ms)
-const int16_t buzzerOnTime = 1 * 500;
+//Longest step of a buzzer pattern time given to the Timer1 compare unit C (ticks).
+//A multiple of 1ms, so the last step of a time is never too short to be caught
+const uint16_t buzzerMaxStep = 50000;
 
 //Baudrate for serial communications
 const uint32_t serialBaudNormal = 1000000;
 
+//Baudrates accepted by CMD_SET_BAUD. The switch waits for the 64 byte transmit buffer to
+//drain, which takes 6ms at the lowest rate. The rate returns to serialBaudNormal on a reset
+const uint32_t serialBaudMin = 115200;
+const uint32_t serialBaudMax = 2000000;
+
+//Framing of the Serial link in both directions. A frame ends with END_MARKER, END_MARKER and
+//ESCAPE_BYTE inside a frame are sent as ESCAPE_BYTE followed by the byte XOR ESCAPE_XOR
+const uint8_t END_MARKER = 0x7F;
+const uint8_t ESCAPE_BYTE = 0x7D;
+const uint8_t ESCAPE_XOR = 0x20;
+
 // Switching baudrate not utilized currently
 //const uint32_t serialBaudFast = 1000000;
 
 //Fault thresholds for initiating an emergency stop
-const int16_t successivePasses = 12; //N successive passes lead to threshold trigger
+//Lowered from 12 since V1.56, single sample spikes are removed by the Prefilter object.
+//Reaction time at targetSampleRate: (prefilter delay + successivePasses + 1) * 200us = 1.4ms
+const int16_t successivePasses = 4; //N successive passes lead to threshold trigger
 
 const int16_t N2OFeedingPressureThreshold = 70;    //Needs confirmation
 const int16_t chamberPressureThreshold = 20;    //Needs confirmation
@@ -516,6 +837,462 @@ const int16_t casingTemperatureThreshold = 800; //Placeholder Value
 //Warning thresholds
 const int16_t N2OFeedingPressureWarning = 65;
 
+//How many bars a tripped pressure redline has to fall below its threshold to be released
+constexpr float pressureRedlineHysteresis = 1.0;
+
+//How many degrees a tripped temperature redline has to fall below its threshold to be released
+constexpr float temperatureRedlineHysteresis = 10.0;
+
+//Channels of the values_t struct that can be checked by the FaultDetection object
+typedef enum{
+  CH_N2_FEEDING_PRESSURE,
+  CH_LINE_PRESSURE,
+  CH_CHAMBER_PRESSURE,
+  CH_N2O_FEEDING_PRESSURE,
+  CH_LOAD_CELL,
+  CH_BOTTLE_TEMPERATURE,
+  CH_NOZZLE_TEMPERATURE,
+  CH_PIPING_TEMPERATURE,
+  CH_IR
+}sensorChannel_t;
+
+//How many channels there are in sensorChannel_t
+const int16_t channelCount = CH_IR + 1;
+
+//Fetch the raw value of a channel from the measurements
+inline int16_t channelValue(const values_t& values, sensorChannel_t channel){
+  switch (channel){
+    case CH_N2_FEEDING_PRESSURE:  return values.cold.N2FeedingPressure;
+    case CH_LINE_PRESSURE:        return values.cold.linePressure;
+    case CH_CHAMBER_PRESSURE:     return values.hot.combustionPressure;
+    case CH_N2O_FEEDING_PRESSURE: return values.cold.N2OFeedingPressure;
+    case CH_LOAD_CELL:            return values.hot.loadCell;
+    case CH_BOTTLE_TEMPERATURE:   return values.cold.bottleTemperature;
+    case CH_NOZZLE_TEMPERATURE:   return values.cold.nozzleTemperature;
+    case CH_PIPING_TEMPERATURE:   return values.cold.pipingTemperature;
+    case CH_IR:                   return values.cold.IR;
+  }
+  return 0;
+}
+
+//Was the channel sampled on the latest loop. See Sensing.cpp for the rates
+inline bool channelUpdated(const values_t& values, sensorChannel_t channel){
+  switch (channel){
+    case CH_CHAMBER_PRESSURE:
+    case CH_LOAD_CELL:            return true;
+    case CH_N2_FEEDING_PRESSURE:
+    case CH_LINE_PRESSURE:
+    case CH_N2O_FEEDING_PRESSURE: return values.cold.mediumUpdated;
+    default:                      return values.cold.slowUpdated;
+  }
+}
+
+//How many of the channels above have a derivative estimator in the Trend object (fast and medium rate channels)
+const int16_t trendChannelCount = CH_LOAD_CELL + 1;
+
+//Time constant of the derivative estimators as a power of two (samples)
+const int16_t trendFilterShift = 3;
+
+//What is compared against the threshold of a redline
+typedef enum{
+  REDLINE_LEVEL,        //Raw value above the threshold
+  REDLINE_RISE_RATE,    //Slope above the threshold
+  REDLINE_FALL_RATE,    //Slope below the negative of the threshold
+  REDLINE_PREDICTED     //Value extrapolated along the slope will be above the threshold within the horizon
+}redlineType_t;
+
+//What happens when a redline is tripped
+typedef enum{
+  REDLINE_WARNING,
+  REDLINE_SAFE,
+  REDLINE_VOTE          //Only counted as a vote in the vote rules
+}redlineAction_t;
+
+//Rows of the redline table in FaultDetection.cpp. Used to refer to the rows in the vote rules
+typedef enum{
+  RL_CHAMBER_PRESSURE,
+  RL_CHAMBER_PREDICTED,
+  RL_LOAD_OVERLOAD,
+  RL_N2O_FEEDING_PRESSURE,
+  RL_NOZZLE_TEMPERATURE,
+  RL_N2O_FEEDING_WARNING,
+  RL_CHAMBER_RISE_RATE,
+  RL_N2O_FEEDING_FALL_RATE,
+  REDLINE_COUNT
+}redlineNames_t;
+
+//Structure for a single row of the redline table in FaultDetection.cpp
+struct redline_t{
+  redlineType_t type;         //What is compared against the threshold
+  sensorChannel_t channel;    //Which measurement is checked
+  uint8_t modeMask;           //In which modes the redline is active, see modeBit()
+  int16_t threshold;          //Raw value (ADC counts or 0.25C thermocouple LSB) or rate (Q8 counts/ms) that has to be exceeded
+  int16_t hysteresis;         //How far below the threshold the value has to fall to release the redline (raw)
+  int16_t passes;             //N successive passes lead to threshold trigger
+  redlineAction_t action;     //What to do when the redline is tripped
+  int16_t horizon;            //How far ahead REDLINE_PREDICTED extrapolates (16us units). Unused by other types
+};
+
+/* Structure for a single vote rule in FaultDetection.cpp.
+ * The rule fires when at least the given number of voting redlines are tripped.
+ * Redlines whose channel is flagged unhealthy by the SensorHealth object don't vote
+ * and the number of required votes is lowered to the number of healthy voters.
+ */
+struct voteRule_t{
+  uint16_t voters;            //Bitmask of the voting redlines, see redlineBit()
+  uint8_t votes;              //How many tripped voters are needed
+  uint8_t modeMask;           //In which modes the rule is active, see modeBit()
+  redlineAction_t action;     //What to do when the rule fires
+};
+
+//Bit of a redline row in the vote rule voter mask
+constexpr uint16_t redlineBit(redlineNames_t redline){
+  return 1 << redline;
+}
+
+//Bit of a mode in the redline mode mask
+constexpr uint8_t modeBit(mode_t mode){
+  return 1 << mode;
+}
+
+//Mode masks used by the redline table
+const uint8_t MODE_MASK_NONE = 0;
+const uint8_t MODE_MASK_ALL = (1 << (SHUTDOWN + 1)) - 1;
+
+/* The redlines are compared against the raw ADC values to keep the per-sample
+ * check to integer compares. These convert the limits given in bars, newtons and
+ * degrees to raw values with the same calibration data as the Rock 4C+. The
+ * Config object converts the limits of the config block once at startup.
+ * Raw = (Value - B) / K / (calibration ADC * refADC) * maxADC
+ */
+
+//Limit a converted value to the range of the ADC
+constexpr int16_t clampADC(float raw){
+  return raw < 0 ? 0 : (raw > maxADC ? maxADC : (int16_t) raw);
+}
+
+//Value of a linearly calibrated sensor to a raw ADC value
+constexpr int16_t lineToADC(calibrationLine_t line, float adcCalibration, float value){
+  return clampADC((value - line.B) / line.K / (adcCalibration * refADC) * maxADC);
+}
+
+//Difference of two values of a linearly calibrated sensor to a difference in raw ADC values
+constexpr int16_t lineDeltaToADC(calibrationLine_t line, float adcCalibration, float delta){
+  return clampADC(delta / line.K / (adcCalibration * refADC) * maxADC);
+}
+
+//Pressure (bar) of a 5V pressure sensor to a raw ADC value, compiled calibration
+constexpr int16_t pressureToADC(int16_t sensorNum, float bars){
+  return lineToADC(pressureCalibration[sensorNum], calibrationADC, bars);
+}
+
+//Pressure difference (bar) of a 5V pressure sensor to a difference in raw ADC values, compiled calibration
+constexpr int16_t pressureDeltaToADC(int16_t sensorNum, float bars){
+  return lineDeltaToADC(pressureCalibration[sensorNum], calibrationADC, bars);
+}
+
+//Measuring range of the MAX31855 (C)
+constexpr float thermocoupleMinTemperature = -270;
+constexpr float thermocoupleMaxTemperature = 1800;
+
+//Thermocouple temperature (C) to the raw MAX31855 value, LSB = 0.25 degrees C
+constexpr int16_t temperatureToRaw(float celsius){
+  return (int16_t) (celsius * 4);
+}
+
+//Voltage to a raw ADC value
+constexpr int16_t voltageToADC(float voltage){
+  return clampADC(voltage / (calibrationADC * refADC) * maxADC);
+}
+
+//Load cell force (N) to a raw ADC value, compiled calibration
+constexpr int16_t loadToADC(float newtons){
+  return lineToADC(loadCellCalibration, calibrationADC, newtons);
+}
+
+/* Mapping of a raw value of one linearly calibrated sensor to the raw value the
+ * other sensor would read at the same value: to = (from * gain >> 8) + offset
+ */
+constexpr int16_t lineMapGain(calibrationLine_t from, calibrationLine_t to){
+  return (int16_t) (from.K / to.K * 256);
+}
+
+constexpr int16_t lineMapOffset(calibrationLine_t from, calibrationLine_t to, float adcCalibration){
+  return (int16_t) ((from.B - to.B) / to.K / (adcCalibration * refADC) * maxADC);
+}
+
+//Limit a converted rate to the range of int16_t
+constexpr int16_t clampRate(float rate){
+  return rate > 32767 ? 32767 : (rate < -32767 ? -32767 : (int16_t) rate);
+}
+
+//Rate of change (units/s) of a linearly calibrated sensor to raw ADC counts per ms in Q8 fixed-point
+constexpr int16_t lineRateToRaw(calibrationLine_t line, float adcCalibration, float perSecond){
+  return clampRate(perSecond / 1000 / line.K / (adcCalibration * refADC) * maxADC * 256);
+}
+
+//Prediction horizon (ms) to units of 16us. Limited to 100ms by the Trend object
+constexpr int16_t msToTrendHorizon(float ms){
+  return (int16_t) (ms * 1000 / 16);
+}
+
+//How many samples the median spike rejection filter of the redline inputs uses (3 or 5)
+//Group delay is (prefilterTaps - 1) / 2 samples, see Prefilter.cpp
+const int16_t prefilterTaps = 5;
+
+//How many counts a redline input may change from the previous filtered sample (0 = no clamp)
+//Order of sensorChannel_t, only the trendChannelCount first channels are filtered.
+//A coarse slew limit, so it is converted with the compiled calibration and not from the config
+const int16_t prefilterClamp[trendChannelCount] = {
+  0,                                            //CH_N2_FEEDING_PRESSURE
+  0,                                            //CH_LINE_PRESSURE
+  pressureDeltaToADC(CHAMBER_PRESSURE, 2),      //CH_CHAMBER_PRESSURE, 2 bar per sample = 10000 bar/s
+  0,                                            //CH_N2O_FEEDING_PRESSURE
+  voltageToADC(0.5)                             //CH_LOAD_CELL, 0.5V per sample
+};
+
+//N successive passes lead to rate of change and prediction trigger
+const int16_t trendPasses = 4;
+
+//How far ahead the chamber pressure is extrapolated to trigger SAFE before the threshold is crossed (ms)
+constexpr float chamberPredictionHorizon = 5;   //Needs confirmation
+
+//Chamber pressure rise rate that activates the warning (bar/s)
+constexpr float chamberPressureRiseRateWarning = 1500;  //Placeholder value
+
+//N2O feeding pressure fall rate that activates the warning (bar/s)
+constexpr float N2OFeedingPressureFallRateWarning = 50;  //Placeholder value
+
+//Load cell force expected when the chamber pressure is at chamberPressureThreshold (N)
+constexpr float loadCellOverloadThreshold = 800;  //Placeholder value
+
+/* Sensor health and cross-validation limits used by the SensorHealth object
+ */
+
+//How many identical successive samples during the burn flag a fast channel as stuck
+const int16_t stuckSampleLimit = 500;
+
+//Load cell output below this means the load cell is disconnected (V)
+constexpr float loadCellDisconnectedVoltage = 0.25;
+
+//Plausible range of the K-type thermocouples (C)
+constexpr float minThermocouple = -270;
+constexpr float maxThermocouple = 1372;
+
+//How much higher the line pressure can read than the oxidizer feeding pressure (bar)
+constexpr float lineFeedPressureTolerance = 5;  //Placeholder value
+
+//Chamber pressure and load cell force that indicate the engine is burning
+constexpr float chamberBurnPressure = 3;        //Placeholder value (bar)
+constexpr float loadCellBurnThrust = 100;       //Placeholder value (N)
+
+//N successive disagreeing samples lead to a cross check fault
+const int16_t crossCheckPasses = 250;
+
+//Bits of the cross check faults
+typedef enum{
+  CROSS_LINE_FEED = 0,        //Line pressure above the oxidizer feeding pressure
+  CROSS_CHAMBER_LOAD = 1      //Chamber pressure and load cell disagree about burning
+}crossCheckNames_t;
+
+/* Configuration kept in the EEPROM by the Config object. The block is read once at
+ * startup, the redline and cross check limits are converted to raw values from it.
+ * Only 4-byte floats and the 2-byte fields at the end, so the layout has no padding
+ * on the AVR or the host and the bytes sent in AUX_FRAME_CONFIG are the same.
+ */
+
+//Threshold and release hysteresis of a row of the redline table, in the units of its
+//channel: bar, N or C for level rows, bar/s for rate rows
+struct redlineLimit_t {
+  float threshold;
+  float hysteresis;
+};
+
+//Channels zeroed by a tare: the pressure sensors in the order of pressureSensorNames_t, then the load cell
+const uint8_t tareChannelCount = pressureCount5V + 1;
+const uint8_t TARE_LOAD_CELL = pressureCount5V;
+
+//Zero offsets of a tare are kept in 1/tareFraction ADC counts
+const int16_t tareFraction = 16;
+
+struct config_t {
+  float calibrationADC;                               //See calibrationADC
+  calibrationLine_t pressure[pressureCount5V];        //Order of pressureSensorNames_t
+  calibrationLine_t load;
+  redlineLimit_t redlines[REDLINE_COUNT];             //Order of redlineNames_t
+  float lineFeedTolerance;                            //See lineFeedPressureTolerance
+  float chamberBurnPressure;                          //See chamberBurnPressure
+  float loadCellBurnThrust;                           //See loadCellBurnThrust
+  int16_t tare[tareChannelCount];                     //Zero offsets (1/tareFraction ADC counts), shift the lines above
+  uint16_t tareCount;                                 //Tares done on the device since the block was sent by the Rock
+  uint16_t version;                                   //configVersion of the firmware that wrote the block
+  uint16_t crc;                                       //CRC-16/CCITT of the fields above
+};
+
+//Default limits of the redline table, in the order of redlineNames_t
+constexpr redlineLimit_t defaultRedlineLimits[REDLINE_COUNT] = {
+  {chamberPressureThreshold, pressureRedlineHysteresis},            //RL_CHAMBER_PRESSURE
+  {chamberPressureThreshold, pressureRedlineHysteresis},            //RL_CHAMBER_PREDICTED
+  {loadCellOverloadThreshold, 0},                                   //RL_LOAD_OVERLOAD
+  {N2OFeedingPressureThreshold, pressureRedlineHysteresis},         //RL_N2O_FEEDING_PRESSURE
+  {casingTemperatureThreshold, temperatureRedlineHysteresis},       //RL_NOZZLE_TEMPERATURE
+  {N2OFeedingPressureWarning, pressureRedlineHysteresis},           //RL_N2O_FEEDING_WARNING
+  {chamberPressureRiseRateWarning, 0},                              //RL_CHAMBER_RISE_RATE
+  {N2OFeedingPressureFallRateWarning, 0}                            //RL_N2O_FEEDING_FALL_RATE
+};
+
+//Channel of the limits of each row of the redline table, for the range check of a config block.
+//Must match the channels and types of the redline table in FaultDetection.cpp
+struct redlineInput_t {
+  sensorChannel_t channel;
+  bool rate;                  //Limits in units/s of a rate row, see lineRateToRaw()
+};
+
+constexpr redlineInput_t redlineInputs[REDLINE_COUNT] = {
+  {CH_CHAMBER_PRESSURE, false},       //RL_CHAMBER_PRESSURE
+  {CH_CHAMBER_PRESSURE, false},       //RL_CHAMBER_PREDICTED
+  {CH_LOAD_CELL, false},              //RL_LOAD_OVERLOAD
+  {CH_N2O_FEEDING_PRESSURE, false},   //RL_N2O_FEEDING_PRESSURE
+  {CH_NOZZLE_TEMPERATURE, false},     //RL_NOZZLE_TEMPERATURE
+  {CH_N2O_FEEDING_PRESSURE, false},   //RL_N2O_FEEDING_WARNING
+  {CH_CHAMBER_PRESSURE, true},        //RL_CHAMBER_RISE_RATE
+  {CH_N2O_FEEDING_PRESSURE, true}     //RL_N2O_FEEDING_FALL_RATE
+};
+
+//Changed whenever config_t changes, so a block of an older layout is never used
+const uint16_t configVersion = 2;
+
+//Where the config in use came from
+typedef enum{
+  CONFIG_STORED,          //Block of the EEPROM
+  CONFIG_DEFAULT_VERSION, //Compiled defaults, the EEPROM is erased or holds another layout
+  CONFIG_DEFAULT_CRC,     //Compiled defaults, the block of the EEPROM is corrupted
+  CONFIG_DEFAULT_RANGE    //Compiled defaults, a value of the block of the EEPROM is out of range
+}configSource_t;
+
+//Bytes of the config block in one AUX_FRAME_CONFIG frame. The last chunk is padded with zeros
+const uint8_t configChunkBytes = 16;
+const uint8_t configChunkCount = (sizeof(config_t) + configChunkBytes - 1) / configChunkBytes;
+const uint8_t configFrameLength = 3 + configChunkBytes;
+
+//How often the whole config block is sent outside SEQUENCE (ms). Also sent right after a reset
+const uint16_t configFrameInterval = 10000;
+
+//One chunk of an AUX_FRAME_CONFIG frame
+struct configChunk_t {
+  uint8_t index;
+  configSource_t source;
+  uint8_t bytes[configChunkBytes];
+};
+
+/* Commands sent by the Rock over the uplink, see Uplink.cpp. A command frame is
+ * [sequence][commandId_t][payload][CRC high][CRC low] with the framing of the downlink.
+ * The CRC-16/CCITT covers the sequence, ID and payload. Multi-byte values are big-endian.
+ * Commands are only received outside SEQUENCE, each one is answered with an AUX_FRAME_ACK.
+ */
+typedef enum{
+  CMD_PING = 1,               //No payload
+  CMD_REQUEST_CONFIG = 2,     //No payload, restarts the AUX_FRAME_CONFIG pass
+  CMD_SET_RATES = 3,          //Medium and slow sensor rates (Hz, 2 bytes each)
+  CMD_START_VERIFICATION = 4, //No payload, only in WAIT
+  CMD_SET_BAUD = 5,           //Baudrate (4 bytes), switched to after the acknowledgement
+  CMD_RESET = 6,              //No payload, software reset after the acknowledgement
+  CMD_CONFIG_CHUNK = 7,       //Chunk index, configChunkBytes bytes of a config_t block in the AVR layout
+  CMD_CONFIG_STORE = 8,       //No payload, writes the block of the received chunks to the EEPROM
+  CMD_TARE = 9                //No payload, only in WAIT. Zeroes the pressure sensors and the load cell
+}commandId_t;
+
+typedef enum{
+  ACK_OK = 0,
+  ACK_UNKNOWN = 1,            //Unknown command ID
+  ACK_REJECTED = 2,           //Not allowed in the current mode, or a value out of range
+  ACK_BAD_LENGTH = 3,         //Wrong payload length for the command
+  ACK_BUSY = 4                //A config block is being written to the EEPROM
+}ackStatus_t;
+
+//Longest payload of a command and the longest command frame without the framing
+const uint8_t commandPayloadMax = 1 + configChunkBytes;
+const uint8_t commandFrameMax = 4 + commandPayloadMax;
+
+//Received bytes parsed in one call of the uplink, bounds its time in the sequence task.
+//A command without escaped bytes fits in one call
+const uint8_t uplinkBytesPerCall = 24;
+
+const uint8_t ackFrameLength = 6;
+
+//A received command
+struct command_t {
+  uint8_t sequence;           //Echoed in the acknowledgement
+  uint8_t id;                 //commandId_t, unknown IDs are acknowledged as such
+  uint8_t length;             //Bytes of payload
+  uint8_t payload[commandPayloadMax];
+};
+
+//Answer to a command in an AUX_FRAME_ACK frame
+struct ack_t {
+  uint8_t sequence;
+  uint8_t id;
+  ackStatus_t status;
+  uint16_t badFrames;         //Uplink frames dropped for a CRC or length error since startup, saturates
+};
+
+/* Tare of the pressure sensors and the load cell by the Tare object, started in WAIT by
+ * CMD_TARE or by holding the repeat sequence button. Every channel is averaged over
+ * tareSamples samples of the normal sampling, the offsets are stored in the config block.
+ */
+//Samples averaged per channel, the sum of the 10-bit readings fits in 16 bits
+const uint8_t tareSamples = 64;
+static_assert(tareSamples * (uint32_t) maxADC <= UINT16_MAX, "Tare sums are 16-bit");
+
+//Largest zero offset accepted. A larger reading means the line is pressurized or the engine loaded
+constexpr float pressureTareLimit = 3;       //bar
+constexpr float loadTareLimit = 100;         //N
+
+//How long the repeat sequence button is held in WAIT to start a tare (ms)
+const uint16_t tareHoldTime = 3000;
+
+typedef enum{
+  TARE_IDLE,
+  TARE_SAMPLING,
+  TARE_DONE,          //Offsets taken into use and being stored
+  TARE_FAILED,        //An offset over its limit, or a config block was being stored
+  TARE_ABORTED        //WAIT was left before the samples were collected
+}tareState_t;
+
+/* Statistics of the analog channels by the Statistics object. Every sample of a channel is
+ * added, and outside SEQUENCE the channels are also read in the minor frames between the
+ * samples, at 1kHz instead of limitedSampleRate. A reporting interval ends with every slow
+ * sample or a mode change, and is sent as one AUX_FRAME_STATISTICS frame per channel.
+ */
+//How many of the sensorChannel_t channels have statistics (the pressures and the load cell)
+const int16_t statisticsChannelCount = CH_LOAD_CELL + 1;
+
+//Samples of an interval in the mean and variance, the sum of squared deviations is 32-bit.
+//The minimum and maximum keep following the channel after this
+const uint16_t statisticsMaxSamples = 4096;
+static_assert(statisticsMaxSamples * (uint32_t) maxADC * maxADC <= UINT32_MAX, "Statistics sums are 32-bit");
+
+//Mean and standard deviation are in 1/statisticsFraction ADC counts
+const uint8_t statisticsFraction = 16;
+
+const uint8_t statisticsFrameLength = 13;
+
+//Statistics of a channel over one reporting interval, values in raw ADC counts
+struct statisticsReport_t {
+  uint8_t channel;            //sensorChannel_t
+  mode_t mode;                //Mode of the interval
+  uint16_t samples;           //Samples in the mean and variance
+  uint16_t min;
+  uint16_t max;
+  uint16_t mean;              //1/statisticsFraction counts
+  uint16_t deviation;         //Standard deviation, 1/statisticsFraction counts
+};
+
+//The first crossing of every 1 << burnLevelShift raw counts of the chamber pressure is timed
+//by the Burn object for the rise time, which is interpolated between the crossings
+const uint8_t burnLevelShift = 5;
+const uint8_t burnLevelCount = (maxADC >> burnLevelShift) + 1;
+
 //Indexes of all the possible messages to send
 typedef enum{
   MSG_TEST_SEQUENCE_START = 1,
@@ -550,9 +1327,16 @@ typedef enum{
   MSG_TEST_ENDING = 30,
   MSG_DUMP_WARNING = 31,
   MSG_N2_FEED_WARNING = 32,
-  MSG_OX_FEED_WARNING = 33
+  MSG_OX_FEED_WARNING = 33,
+  MSG_LINE_FEED_MISMATCH = 34,
+  MSG_CHAMBER_LOAD_MISMATCH = 35,
+  MSG_SENSOR_UNHEALTHY = 36,  //+ sensorChannel_t of the channel (36...44)
+  MSG_FAULT_RULE = 45         //+ redlineNames_t of the redline or REDLINE_COUNT + index of the vote rule (45...54)
   }messageIndices_t;
 
+//The message index is sent in 6 bits of the data lines
+const uint8_t maxMessageIndex = 63;
+
 //Maximum length of the message buffer;
 const uint16_t msgBufferSize = 16;
 
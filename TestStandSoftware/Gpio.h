@@ -0,0 +1,144 @@
+/* Filename:      Gpio.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Compile time access to the pins of pin_names_t. The port and
+ *                bit of a pin are resolved by the compiler from megaPinMap, so
+ *                fastWrite() on ports A-G compiles to a single SBI/CBI
+ *                instruction. Replaces digitalWrite() and digitalRead(), which
+ *                look the port up from flash tables on every call, and the
+ *                hand kept port enums of Globals.h.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef GPIO_H
+#define GPIO_H
+
+typedef enum {
+  GPIO_PORT_A,
+  GPIO_PORT_B,
+  GPIO_PORT_C,
+  GPIO_PORT_D,
+  GPIO_PORT_E,
+  GPIO_PORT_F,
+  GPIO_PORT_G,
+  GPIO_PORT_H,    //Ports from H onwards are memory mapped, outside the SBI/CBI range
+  GPIO_PORT_J
+} gpioPort_t;
+
+#define GPIO_PIN(port, bit) (((port) << 3) | (bit))
+
+//Arduino Mega 2560 pins 0...35, pin number -> (port << 3) | bit
+constexpr uint8_t megaPinMap[] = {
+  GPIO_PIN(GPIO_PORT_E, 0), GPIO_PIN(GPIO_PORT_E, 1), GPIO_PIN(GPIO_PORT_E, 4), GPIO_PIN(GPIO_PORT_E, 5),  // 0...3
+  GPIO_PIN(GPIO_PORT_G, 5), GPIO_PIN(GPIO_PORT_E, 3), GPIO_PIN(GPIO_PORT_H, 3), GPIO_PIN(GPIO_PORT_H, 4),  // 4...7
+  GPIO_PIN(GPIO_PORT_H, 5), GPIO_PIN(GPIO_PORT_H, 6), GPIO_PIN(GPIO_PORT_B, 4), GPIO_PIN(GPIO_PORT_B, 5),  // 8...11
+  GPIO_PIN(GPIO_PORT_B, 6), GPIO_PIN(GPIO_PORT_B, 7), GPIO_PIN(GPIO_PORT_J, 1), GPIO_PIN(GPIO_PORT_J, 0),  //12...15
+  GPIO_PIN(GPIO_PORT_H, 1), GPIO_PIN(GPIO_PORT_H, 0), GPIO_PIN(GPIO_PORT_D, 3), GPIO_PIN(GPIO_PORT_D, 2),  //16...19
+  GPIO_PIN(GPIO_PORT_D, 1), GPIO_PIN(GPIO_PORT_D, 0), GPIO_PIN(GPIO_PORT_A, 0), GPIO_PIN(GPIO_PORT_A, 1),  //20...23
+  GPIO_PIN(GPIO_PORT_A, 2), GPIO_PIN(GPIO_PORT_A, 3), GPIO_PIN(GPIO_PORT_A, 4), GPIO_PIN(GPIO_PORT_A, 5),  //24...27
+  GPIO_PIN(GPIO_PORT_A, 6), GPIO_PIN(GPIO_PORT_A, 7), GPIO_PIN(GPIO_PORT_C, 7), GPIO_PIN(GPIO_PORT_C, 6),  //28...31
+  GPIO_PIN(GPIO_PORT_C, 5), GPIO_PIN(GPIO_PORT_C, 4), GPIO_PIN(GPIO_PORT_C, 3), GPIO_PIN(GPIO_PORT_C, 2)   //32...35
+};
+
+constexpr uint8_t megaMappedPins = sizeof(megaPinMap);
+
+constexpr gpioPort_t pinPort(pin_names_t pin){
+  return (gpioPort_t) (megaPinMap[pin] >> 3);
+}
+
+constexpr uint8_t pinBit(pin_names_t pin){
+  return megaPinMap[pin] & 7;
+}
+
+constexpr uint8_t pinMask(pin_names_t pin){
+  return 1 << pinBit(pin);
+}
+
+
+/* Function:      Output register of a port. With a port known at compile
+ *                time the switch folds into a constant register address.
+ *
+ * IN:            gpioPort_t port
+ * OUT:           Reference to the PORTx register
+ */
+__attribute__((always_inline)) inline volatile uint8_t& portRegister(gpioPort_t port){
+  switch (port){
+    case GPIO_PORT_A: return PORTA;
+    case GPIO_PORT_B: return PORTB;
+    case GPIO_PORT_C: return PORTC;
+    case GPIO_PORT_D: return PORTD;
+    case GPIO_PORT_E: return PORTE;
+    case GPIO_PORT_F: return PORTF;
+    case GPIO_PORT_G: return PORTG;
+    case GPIO_PORT_H: return PORTH;
+    default:          return PORTJ;
+  }
+}
+
+
+/* Function:      Read the input register of a port.
+ *
+ * IN:            gpioPort_t port
+ * OUT:           uint8_t value of the PINx register
+ */
+__attribute__((always_inline)) inline uint8_t readPort(gpioPort_t port){
+  switch (port){
+    case GPIO_PORT_A: return PINA;
+    case GPIO_PORT_B: return PINB;
+    case GPIO_PORT_C: return PINC;
+    case GPIO_PORT_D: return PIND;
+    case GPIO_PORT_E: return PINE;
+    case GPIO_PORT_F: return PINF;
+    case GPIO_PORT_G: return PING;
+    case GPIO_PORT_H: return PINH;
+    default:          return PINJ;
+  }
+}
+
+
+/* Function:      Set an output pin. On ports A-G this is a single SBI or CBI.
+ *                The read-modify-write of the memory mapped ports is done with
+ *                interrupts disabled, so it can't lose a write of an interrupt.
+ *
+ * IN:            pin_names_t pin as the template argument,
+ *                Boolean that the pin will be set to
+ * OUT:           Nothing
+ */
+template <pin_names_t pin>
+__attribute__((always_inline)) inline void fastWrite(bool state){
+  static_assert(pin < megaMappedPins, "Pin is not in megaPinMap");
+
+  volatile uint8_t& port = portRegister(pinPort(pin));
+
+  if (pinPort(pin) >= GPIO_PORT_H){
+    uint8_t oldSREG = SREG;
+    cli();
+    if (state){port |= pinMask(pin);}
+    else      {port &= ~pinMask(pin);}
+    SREG = oldSREG;
+  }else{
+    if (state){port |= pinMask(pin);}
+    else      {port &= ~pinMask(pin);}
+  }
+}
+
+
+/* Function:      Read the level of a pin.
+ *
+ * IN:            pin_names_t pin as the template argument
+ * OUT:           Boolean level of the pin
+ */
+template <pin_names_t pin>
+__attribute__((always_inline)) inline bool fastRead(){
+  static_assert(pin < megaMappedPins, "Pin is not in megaPinMap");
+
+  return readPort(pinPort(pin)) & pinMask(pin);
+}
+
+#endif
@@ -0,0 +1,43 @@
+/* Filename:      Hal.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Hardware abstraction layer of the Test Stand Software.
+ *                Include this instead of <Arduino.h> in every object.
+ *
+ *                AVR backend:   the Arduino core itself. Register access
+ *                               (PORTx, PINx, ADCSRA, timers) compiles to the
+ *                               same direct IO instructions as before.
+ *                Linux backend: selected with -DHOST_BUILD. Emulated registers,
+ *                               a virtual clock for millis() and micros()
+ *                               that skips ahead in the idle sleep,
+ *                               simulated ADC, GPIO, SPI and Serial.
+ *                               The interrupt flags clear on a written one.
+ *                               A watchdog timeout restarts the firmware
+ *                               through the handler of the simulator.
+ *                               EEMEM variables are plain RAM kept over
+ *                               resets.
+ *                               See host/HostArduino.h and host/Makefile.
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#ifdef HOST_BUILD
+#include "host/HostArduino.h"
+#else
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
+//Timer interrupt flag registers, TIFRn. Plain IO registers on the AVR
+typedef volatile uint8_t flagRegister_t;
+
+//Variables left out of the zeroing of RAM at startup, kept over a reset
+#define NOINIT __attribute__((section(".noinit")))
+#endif
+
+#endif
@@ -8,7 +8,7 @@
  *                NOT USED CURRENTLY
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 #include "Heating.h"
 
 //NOT USED IN FIRST VERSION
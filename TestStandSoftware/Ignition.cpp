@@ -7,24 +7,26 @@
  *                for igniting the engine
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 #include <stdint.h>
 
 #include "Globals.h"
+#include "Gpio.h"
+#include "Pulse.h"
 
 void initIgnition(){
   pinMode(IGNITER_CONTROL_PIN, OUTPUT);
-  digitalWrite(IGNITER_CONTROL_PIN, LOW);
+  fastWrite<IGNITER_CONTROL_PIN>(LOW);
 }
 
 void setIgnition(bool state){
-  //digitalWrite(IGNITER_CONTROL_PIN, state);
-  if (state == true){PORTB |=  (1 << IGNITER_CONTROL_PIN_PORTB);}
-  else              {PORTB &= ~(1 << IGNITER_CONTROL_PIN_PORTB);}
+  //Direct control overrides a timed ignition pulse
+  cancelPulse(PULSE_IGNITER);
+
+  fastWrite<IGNITER_CONTROL_PIN>(state);
 
 }
 
 void getIgnition(bool* ignitionState){
-  //*ignitionState = digitalRead(IGNITER_CONTROL_PIN);
-  *ignitionState = PINB & (1 << IGNITER_CONTROL_PIN_PORTB);
+  *ignitionState = fastRead<IGNITER_CONTROL_PIN>();
 }
\ No newline at end of file
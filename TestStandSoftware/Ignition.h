@@ -18,7 +18,8 @@
 void initIgnition(void);
 
 
-/* Function:      Set the ignition control pin to a desired value
+/* Function:      Set the ignition control pin to a desired value. Cancels
+ *                a timed ignition pulse of the Pulse object.
  *
  * IN:            Boolean stating the desires state: true = ON, false = OFF
  * OUT:           Nothing
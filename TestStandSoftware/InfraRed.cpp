@@ -7,7 +7,7 @@
  *                infrared sensor used to measure the plume temperature.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 #include <stdint.h>
 #include "Globals.h"
 
@@ -23,51 +23,96 @@
 #include "LatestValues.h"
 #include "TestAutomation.h"
 #include "Countdown.h"
+#include "Executive.h"
 #include "Valves.h"
 #include "Buzzer.h"
 #include "Heating.h"
 #include "FaultDetection.h"
+#include "Prefilter.h"
+#include "Trend.h"
+#include "SensorHealth.h"
 #include "InfraRed.h"
 #include "ControlSensing.h"
 #include "Ignition.h"
+#include "Pulse.h"
 #include "TestInOut.h"
+#include "DigitalInputs.h"
 #include "Verification.h"
+#include "Profiler.h"
+#include "Timebase.h"
+#include "Retained.h"
+#include "Watchdog.h"
+#include "Config.h"
+#include "Uplink.h"
+#include "Tare.h"
+#include "Statistics.h"
+#include "Burn.h"
+#include "BurnEvents.h"
 
 
 void start(){
+  initObjects();
+
+  //Start the software loop
+  countdownLoop();
+
+  //Start FreeRTOS
+  //vTaskStartScheduler();
+
+}
+
+void initObjects(){
+  //Reset flags and the state of the previous run are checked first
+  initRetained();
+  //Calibration and limits are read before the objects converting them
+  initConfig();
+  initTimebase();
+
+  initDigitalInputs();
   initTestInOut();
 
   initMode();
 
   initFaultDetect();
+  initPrefilter();
+  initTrend();
+  initSensorHealth();
 
   initSerial();
+  initUplink();
 
   initSensors();
-    initIR();
-    initPressure();
-    initLoad();
-    initTemp();
-    initLatestValues();
-    initControlSensing();
+  initIR();
+  initPressure();
+  initLoad();
+  initTemp();
+  initLatestValues();
+  initControlSensing();
+  initTare();
+  initStatistics();
 
   initTestAutomation();
-    initValves();
-    initIgnition();
-    //initHeating(); /SW control not available in first version
-    initVerification();
+  initPulse();
+  initValves();
+  initIgnition();
+  //initHeating(); /SW control not available in first version
+  initVerification();
+  initBurn();
+  initBurnEvents();
+#ifdef PROFILE_BUILD
+  initProfiler();
+#endif
 
 
   initBuzzer();
+  //Indicate the reset of the system
+  startBuzzerPattern(BUZZER_RESET);
 
   //Initiate tasks last
   initSensing();
+  initExecutive();
   initCountdown();
 
-  //Start the software loop
-  countdownLoop();
-
-  //Start FreeRTOS
-  //vTaskStartScheduler();
-
+  //The watchdog runs from here on, the executive feeds it
+  initWatchdog();
 }
\ No newline at end of file
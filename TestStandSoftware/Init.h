@@ -17,4 +17,13 @@
  */
 void start(void);
 
+
+/* Function:      Initialize all other objects without starting the software
+ *                loop. Used by start() and by the host build.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initObjects(void);
+
 #endif
\ No newline at end of file
@@ -10,50 +10,83 @@
 //#include <Arduino_FreeRTOS.h>
 //#include <semphr.h>
 
+#include "Hal.h"
+#include <stdint.h>
+
 #include "Globals.h"
+#include "LatestValues.h"
+
+/* Sequence lock explanation:
+ * The writer makes the sequence odd, copies the values and makes it even again.
+ * A reader copies the values between two reads of the sequence and accepts the copy
+ * if the sequence was even and didn't change. The writer never waits, so setLatest()
+ * can be called from an interrupt. The sequence is 8 bits, so its loads and stores
+ * are single instructions on the AVR. The copy would only be accepted wrongly if
+ * exactly 128 writes happened during one copy.
+ * The reader is the software loop: if the copy keeps getting torn, the last copy
+ * is done with interrupts disabled, which bounds the cost of getLatest().
+ */
 
 static values_t latestValues;
+static volatile uint8_t latestSequence;
+
+//Keeps the compiler from moving the copy of latestValues past the sequence accesses
+#define SEQUENCE_BARRIER() __asm__ __volatile__ ("" ::: "memory")
 
 //static SemaphoreHandle_t latestValueMutex;
 
 void initLatestValues(){
-  latestValues.N2FeedingPressure = 0;      //N2 Feeding pressure 
-  latestValues.linePressure = 0;      //Oxidizer line pressure 
-  latestValues.combustionPressure = 0;      //Combustion chamber pressure 
-  latestValues.N2OFeedingPressure = 0;      //Oxidizer Feeding pressure 
-  latestValues.loadCell = 0;       //Back of the engine
-  latestValues.bottleTemperature = 0;   //Bottle temperature - Switched to TMP36 output, uses different pin
-  latestValues.notConnectedTemperature = 0;   //Injector temperature - Usually outputs NaN, not used in live_grapher_V3.py
-  latestValues.nozzleTemperature = 0;   //Nozzle temperature
-  latestValues.pipingTemperature = 0;   //Piping temperature
-  latestValues.IR = 0;             //Plume Temperature
-
-  latestValues.timestamp = 0;
-  latestValues.msTimestamp = 0;
-  latestValues.checkTimestamp = 0;
-  latestValues.timeOverflowOffset = 0;
-
-  latestValues.slowUpdated = false;
-
-  latestValues.dumpValveButton = true;        //Dump Valve button status. Initialized true, since new nominal state is dump valve open (inverted afterwards due to normally open valve)
-  latestValues.heatingBlanketButton = false;  //Heating button status
-  latestValues.ignitionButton = false;        //Ignition button status
-  latestValues.n2FeedingButton = false;       //N2 Feeding valve status
-  latestValues.oxidizerValveButton = false;   //Main oxidizer valve status
+  latestValues.cold.N2FeedingPressure = 0;      //N2 Feeding pressure 
+  latestValues.cold.linePressure = 0;      //Oxidizer line pressure 
+  latestValues.hot.combustionPressure = 0;      //Combustion chamber pressure 
+  latestValues.cold.N2OFeedingPressure = 0;      //Oxidizer Feeding pressure 
+  latestValues.hot.loadCell = 0;       //Back of the engine
+  latestValues.cold.bottleTemperature = 0;   //Bottle temperature - Switched to TMP36 output, uses different pin
+  latestValues.cold.notConnectedTemperature = 0;   //Injector temperature - Usually outputs NaN, not used in live_grapher_V3.py
+  latestValues.cold.nozzleTemperature = 0;   //Nozzle temperature
+  latestValues.cold.pipingTemperature = 0;   //Piping temperature
+  latestValues.cold.IR = 0;             //Plume Temperature
+  latestValues.cold.temperatureFaults = 0;   //Thermocouple fault bits
+
+  latestValues.hot.tick = 0;
+
+  latestValues.cold.slowUpdated = false;
+  latestValues.cold.mediumUpdated = false;
+
+  latestValues.cold.dumpValveButton = true;        //Dump Valve button status. Initialized true, since new nominal state is dump valve open (inverted afterwards due to normally open valve)
+  latestValues.cold.heatingBlanketButton = false;  //Heating button status
+  latestValues.cold.ignitionButton = false;        //Ignition button status
+  latestValues.cold.n2FeedingButton = false;       //N2 Feeding valve status
+  latestValues.cold.oxidizerValveButton = false;   //Main oxidizer valve status
+
+  latestSequence = 0;
 
   //latestValueMutex = xSemaphoreCreateMutex();
 }
 
-void setLatest(values_t values){
-  //if (xSemaphoreTake(latestValueMutex, 10) == pdTRUE){
-    latestValues = values;
-    //xSemaphoreGive(latestValueMutex);
-  //}
+void setLatest(const values_t& values){
+  latestSequence++;
+  SEQUENCE_BARRIER();
+  latestValues = values;
+  SEQUENCE_BARRIER();
+  latestSequence++;
 }
 
 void getLatest(values_t* values){
-  //if (xSemaphoreTake(latestValueMutex, 10) == pdTRUE){
+  for (uint8_t attempt = 0; attempt < latestReadAttempts; attempt++){
+    uint8_t sequence = latestSequence;
+    SEQUENCE_BARRIER();
     *values = latestValues;
-    //xSemaphoreGive(latestValueMutex);
-  //}
-}
\ No newline at end of file
+    SEQUENCE_BARRIER();
+
+    if ((sequence & 1) == 0 && latestSequence == sequence){
+      return;
+    }
+  }
+
+  //setLatest() can't run in the middle of this copy
+  uint8_t oldSREG = SREG;
+  cli();
+  *values = latestValues;
+  SREG = oldSREG;
+}
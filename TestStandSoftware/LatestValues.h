@@ -7,11 +7,13 @@
  *                Contains function definitions.
  */
 
+#include "Globals.h"
+
 #ifndef LATESTVALUES_H
 #define LATESTVALUES_H
 
-/* Function:      Initialize the latest values values_t struct with zeros.
- *                Create the protection semaphore.
+/* Function:      Initialize the latest values values_t struct with zeros
+ *                and reset the sequence counter protecting it.
  *
  * IN:            Nothing
  * OUT:           Nothing
@@ -20,14 +22,17 @@ void initLatestValues(void);
 
 
 /* Function:      Store the latest measurements in the protected object.
+ *                Never blocks, so it can be called from an interrupt.
  *
- * IN:            values_t struct containing the values to be stored.
+ * IN:            Reference to a values_t struct containing the values to be stored.
  * OUT:           Nothing
  */
-void setLatest(values_t values);
+void setLatest(const values_t& values);
 
 
 /* Function:      Get the stored values from the protected object using a pointer.
+ *                The copy is never torn by a concurrent setLatest(). Meant for
+ *                the software loop, see LatestValues.cpp for the retry bound.
  *
  * IN:            Pointer to a values_t struct where the values will be stored.
  * OUT:           Nothing
@@ -7,7 +7,7 @@
  *                thrust of the engine.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 #include <stdint.h>
 
 #include "LoadCell.h"
@@ -7,13 +7,16 @@
  *                object. These values can then be fetched from here by other objects.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 //#include <Arduino_FreeRTOS.h>
 //#include <semphr.h>
 #include <stdint.h>
 
 #include "Globals.h"
+#include "Gpio.h"
 #include "TestInOut.h"
+#include "DigitalInputs.h"
+#include "Retained.h"
 
 static mode_t currentMode;
 static substate_t currentSubstate;
@@ -21,6 +24,7 @@ static bool currentWarning;
 
 void setMode(mode_t newMode){
     currentMode = newMode;
+    retainMode(currentMode, currentSubstate);
 }
 
 void getMode(mode_t *mode){
@@ -29,6 +33,7 @@ void getMode(mode_t *mode){
 
 void setSubstate(substate_t newSubstate){
     currentSubstate = newSubstate;
+    retainMode(currentMode, currentSubstate);
 }
 
 void getSubstate(substate_t *substate){
@@ -44,15 +49,11 @@ void getWarning(bool *warning){
 }
 
 void setRepeatIndicator(bool state){
-  //digitalWrite(REPEAT_SEQUENCE_LED_PIN, state);
-  if (state == true){PORTH |=  (1 << REPEAT_SEQUENCE_LED_PIN_PORTH);}
-  else              {PORTH &= ~(1 << REPEAT_SEQUENCE_LED_PIN_PORTH);}
+  fastWrite<REPEAT_SEQUENCE_LED_PIN>(state);
 }
 
 void setTestModeIndicator(bool state){
-  //digitalWrite(TEST_MODE_LED_PIN, state);
-  if (state == true){PORTH |=  (1 << TEST_MODE_LED_PIN_PORTH);}
-  else              {PORTH &= ~(1 << TEST_MODE_LED_PIN_PORTH);}
+  fastWrite<TEST_MODE_LED_PIN>(state);
 }
 
 
@@ -60,19 +61,37 @@ void setTestModeIndicator(bool state){
 void initMode(){
   currentMode = startMode;
   currentSubstate = startSubstate;
+  currentWarning = false;
 
   pinMode(TEST_MODE_LED_PIN, OUTPUT);
-  digitalWrite(TEST_MODE_LED_PIN, LOW);
+  fastWrite<TEST_MODE_LED_PIN>(LOW);
 
   pinMode(REPEAT_SEQUENCE_LED_PIN, OUTPUT);
-  digitalWrite(REPEAT_SEQUENCE_LED_PIN, LOW);
+  fastWrite<REPEAT_SEQUENCE_LED_PIN>(LOW);
 
   //Check if system is started in TEST mode or normal WAIT mode
   testInput_t startTestInput;
   //Read all of the inputs
+  latchDigitalInputs();
   readTestInput(&startTestInput, true);
 
-  if (startTestInput.startTest == HIGH){
+  retainedState_t retainedState;
+  getRetained(&retainedState);
+
+  if (isWarmStart() && retainedState.mode != INIT){
+    //Continue in the mode of the previous run. A firing can't be continued, the reset turned the outputs off
+    if (retainedState.mode == SEQUENCE){
+      setMode(SAFE);
+      setSubstate(ALL_OFF);
+    }
+    else{
+      setMode(retainedState.mode);
+      setSubstate(retainedState.substate);
+    }
+    setTestModeIndicator(currentMode == TEST);
+  }
+  //The verification is not repeated after a reset once it has passed
+  else if (startTestInput.startTest == HIGH && !retainedState.verificationPassed){
     setMode(TEST);
     setTestModeIndicator(true);
   }
@@ -0,0 +1,119 @@
+/* Filename:      Prefilter.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Rejects single sample spikes (e.g. EMI from the igniter relay)
+ *                from the redline inputs before they reach the FaultDetection object.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Prefilter.h"
+
+/* Filter explanation:
+ * 1. Outlier clamp: a new sample may differ from the previous clamped sample by
+ *    at most prefilterClamp[channel] counts (0 = no clamp). Limits how far a
+ *    spike longer than the median window can pull the output.
+ * 2. Median of the last prefilterTaps clamped samples, calculated with a fixed
+ *    compare-exchange sorting network. The number of operations doesn't depend
+ *    on the data, so the cost per sample is constant.
+ *
+ * Group delay of the median is (prefilterTaps - 1) / 2 samples of the channel:
+ *   3 taps: 1 sample  -> 200us for the fast channels at targetSampleRate, 10ms for medium
+ *   5 taps: 2 samples -> 400us for the fast channels at targetSampleRate, 20ms for medium
+ * A spike of up to (prefilterTaps - 1) / 2 successive samples is removed completely.
+ * The clamp adds no delay to changes smaller than the clamp per sample.
+ */
+
+static_assert(prefilterTaps == 3 || prefilterTaps == 5, "Prefilter supports 3 or 5 taps");
+
+static int16_t window[trendChannelCount][prefilterTaps];
+static int16_t lastInput[trendChannelCount];
+static uint8_t windowIndex[trendChannelCount];
+static bool primed[trendChannelCount];
+
+void initPrefilter(){
+  for (uint8_t i = 0; i < trendChannelCount; i++){
+    windowIndex[i] = 0;
+    lastInput[i] = 0;
+    primed[i] = false;
+  }
+}
+
+//Put the smaller value in a and the larger in b
+static inline void compareExchange(int16_t* a, int16_t* b){
+  int16_t low = *a < *b ? *a : *b;
+  int16_t high = *a < *b ? *b : *a;
+  *a = low;
+  *b = high;
+}
+
+static int16_t median(int16_t* samples){
+  int16_t p[prefilterTaps];
+  for (uint8_t i = 0; i < prefilterTaps; i++){
+    p[i] = samples[i];
+  }
+
+  if (prefilterTaps == 3){
+    compareExchange(&p[0], &p[1]);
+    compareExchange(&p[1], &p[2]);
+    compareExchange(&p[0], &p[1]);
+    return p[1];
+  }
+
+  //Median of 5 in 7 compare-exchanges
+  compareExchange(&p[0], &p[1]);
+  compareExchange(&p[3], &p[4]);
+  compareExchange(&p[0], &p[3]);
+  compareExchange(&p[1], &p[4]);
+  compareExchange(&p[1], &p[2]);
+  compareExchange(&p[2], &p[3]);
+  compareExchange(&p[1], &p[2]);
+  return p[2];
+}
+
+static int16_t filterChannel(uint8_t channel, int16_t value){
+  if (!primed[channel]){
+    for (uint8_t i = 0; i < prefilterTaps; i++){
+      window[channel][i] = value;
+    }
+    primed[channel] = true;
+    lastInput[channel] = value;
+    return value;
+  }
+
+  int16_t clamp = prefilterClamp[channel];
+  if (clamp > 0){
+    if (value > lastInput[channel] + clamp){value = lastInput[channel] + clamp;}
+    else if (value < lastInput[channel] - clamp){value = lastInput[channel] - clamp;}
+  }
+  lastInput[channel] = value;
+
+  window[channel][windowIndex[channel]] = value;
+  windowIndex[channel]++;
+  if (windowIndex[channel] == prefilterTaps){
+    windowIndex[channel] = 0;
+  }
+
+  return median(window[channel]);
+}
+
+void prefilterValues(const values_t& values, values_t* filtered){
+  //Fast channels are sampled every loop
+  filtered->hot.tick = values.hot.tick;
+  filtered->hot.combustionPressure = filterChannel(CH_CHAMBER_PRESSURE, values.hot.combustionPressure);
+  filtered->hot.loadCell = filterChannel(CH_LOAD_CELL, values.hot.loadCell);
+
+  //The cold block only changes together with the medium rate channels
+  if (values.cold.mediumUpdated == true){
+    filtered->cold = values.cold;
+    filtered->cold.N2FeedingPressure = filterChannel(CH_N2_FEEDING_PRESSURE, values.cold.N2FeedingPressure);
+    filtered->cold.linePressure = filterChannel(CH_LINE_PRESSURE, values.cold.linePressure);
+    filtered->cold.N2OFeedingPressure = filterChannel(CH_N2O_FEEDING_PRESSURE, values.cold.N2OFeedingPressure);
+  }else{
+    filtered->cold.mediumUpdated = false;
+    filtered->cold.slowUpdated = false;
+  }
+}
@@ -0,0 +1,38 @@
+/* Filename:      Prefilter.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Prefilter <<passive>> object. 
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef PREFILTER_H
+#define PREFILTER_H
+
+/* Function:      Initialize the Prefilter object. The filter windows are
+ *                filled with the first sample of each channel.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initPrefilter(void);
+
+
+/* Function:      Update the copy of the measurements checked by the FaultDetection
+ *                object with the spike rejected values of the fast and medium rate
+ *                channels sampled this loop. The raw values are still sent to the
+ *                Rock. The cold block is only copied when the medium rate channels
+ *                were sampled, otherwise only its update flags are cleared.
+ *
+ * IN:            Reference to a values_t struct with the newest measurements,
+ *                Pointer to the values_t struct of the filtered copy
+ * OUT:           Nothing
+ */
+void prefilterValues(const values_t& values, values_t* filtered);
+
+#endif
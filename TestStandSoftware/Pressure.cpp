@@ -7,7 +7,7 @@
  *                pressure sensors used to measure the various pressures.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 #include <stdint.h>
 
 #include "Globals.h"
@@ -28,15 +28,15 @@ int readPressure5V(uint16_t sensorNum){
    * refADV = expected ADC voltage of 5.00V
    * pressureVoltage = measured voltage on the pin, within 0...1023
    * maxADC = 1023, since we are using 10-bit analog to digital converter
-   * pressureCalibration_K[sensorNum] = mapping from voltage to bar for this sensor. Includes calibration values
-   * pressureCalibration_B[sensorNum] = mapping from voltage to bar for this sensor. Includes calibration values
+   * pressureCalibration[sensorNum].K = mapping from voltage to bar for this sensor. Includes calibration values
+   * pressureCalibration[sensorNum].B = mapping from voltage to bar for this sensor. Includes calibration values
    * Bars = K * Voltage + B
    */
   
   /*
   float pressureVoltage = analogRead(pressurePins[sensorNum]);
   pressureVoltage = calibrationADC * refADC * (pressureVoltage / maxADC);
-  return pressureCalibration_K[sensorNum] * pressureVoltage + pressureCalibration_B[sensorNum];
+  return pressureCalibration[sensorNum].K * pressureVoltage + pressureCalibration[sensorNum].B;
   */
 }
 
@@ -0,0 +1,117 @@
+/* Filename:      Profiler.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Times the phases of countdownStep() with the Timer1 timebase
+ *                and keeps the minimum, maximum, mean and a histogram of each
+ *                phase for the AUX_FRAME_PROFILE diagnostics frame.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Profiler.h"
+#include "Timebase.h"
+
+#ifdef PROFILE_BUILD
+
+/* Timing explanation:
+ * Timer1 runs free at 4us per tick (see Timebase.cpp). A phase is the difference of
+ * two 16-bit readings, so phases up to 262ms are measured correctly. A mark costs
+ * one timer read and a few additions, about 3us at 16MHz.
+ *
+ * Histogram bins: 0: <16us, 1: <32us, 2: <64us, 3: <128us, 4: <256us, 5: <512us,
+ * 6: <1024us, 7: the rest. The counts saturate instead of wrapping.
+ */
+
+static uint16_t minTicks[loopPhaseCount];
+static uint16_t maxTicks[loopPhaseCount];
+static uint32_t sumTicks[loopPhaseCount];
+static uint16_t phaseCount[loopPhaseCount];
+static uint16_t histogram[loopPhaseCount][profileHistogramBins];
+
+static uint16_t lastMark;
+static uint8_t nextPhase;
+static uint32_t lastFrameTime;
+
+static void clearPhase(uint8_t phase){
+  minTicks[phase] = 0xFFFF;
+  maxTicks[phase] = 0;
+  sumTicks[phase] = 0;
+  phaseCount[phase] = 0;
+  for (uint8_t i = 0; i < profileHistogramBins; i++){
+    histogram[phase][i] = 0;
+  }
+}
+
+void initProfiler(){
+  for (uint8_t i = 0; i < loopPhaseCount; i++){
+    clearPhase(i);
+  }
+  nextPhase = 0;
+  lastFrameTime = 0;
+  lastMark = timebaseTicks16();
+}
+
+void profileLoopStart(){
+  lastMark = timebaseTicks16();
+}
+
+void profilePhaseEnd(loopPhase_t phase){
+  uint16_t now = timebaseTicks16();
+  uint16_t ticks = now - lastMark;
+  lastMark = now;
+
+  if (phaseCount[phase] == 0xFFFF){
+    return;
+  }
+
+  if (ticks < minTicks[phase]){minTicks[phase] = ticks;}
+  if (ticks > maxTicks[phase]){maxTicks[phase] = ticks;}
+  sumTicks[phase] += ticks;
+  phaseCount[phase]++;
+
+  //Bin by the highest set bit of the duration in 16us units
+  uint8_t bin = 0;
+  uint16_t units = ticks >> 2;
+  while (units != 0 && bin < profileHistogramBins - 1){
+    units >>= 1;
+    bin++;
+  }
+  if (histogram[phase][bin] != 0xFFFF){
+    histogram[phase][bin]++;
+  }
+}
+
+bool getProfile(profileStats_t* stats){
+  uint32_t now = millis();
+  if (now - lastFrameTime < profileFrameInterval){
+    return false;
+  }
+  lastFrameTime = now;
+
+  uint8_t phase = nextPhase;
+  nextPhase = (nextPhase + 1) % loopPhaseCount;
+
+  uint16_t count = phaseCount[phase];
+  stats->phase = (loopPhase_t) phase;
+  stats->count = count;
+  stats->minTicks = count ? minTicks[phase] : 0;
+  stats->maxTicks = maxTicks[phase];
+  stats->meanTicks = count ? sumTicks[phase] / count : 0;
+
+  uint32_t binTotal = 0;
+  for (uint8_t i = 0; i < profileHistogramBins; i++){
+    binTotal += histogram[phase][i];
+  }
+  for (uint8_t i = 0; i < profileHistogramBins; i++){
+    stats->histogram[i] = binTotal ? (histogram[phase][i] * 255UL + binTotal / 2) / binTotal : 0;
+  }
+
+  clearPhase(phase);
+  return true;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/* Filename:      Profiler.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Profiler <<passive>> object.
+ *                Contains function definitions and the timing macros.
+ *
+ *                The profiler is only compiled in with -DPROFILE_BUILD.
+ *                In flight builds the macros are empty and the object
+ *                has no code or state.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef PROFILE_BUILD
+#define PROFILE_LOOP_START()      profileLoopStart()
+#define PROFILE_PHASE_END(phase)  profilePhaseEnd(phase)
+#else
+#define PROFILE_LOOP_START()      ((void) 0)
+#define PROFILE_PHASE_END(phase)  ((void) 0)
+#endif
+
+#ifdef PROFILE_BUILD
+
+/* Function:      Initialize the Profiler object and clear the statistics.
+ *                Uses Timer1, so initTimebase() must be called first.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initProfiler(void);
+
+
+/* Function:      Mark the start of countdownStep(). Time before this, e.g. the
+ *                delay outside SEQUENCE, is not counted to any phase.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void profileLoopStart(void);
+
+
+/* Function:      Mark the end of a phase. The time since the previous mark is
+ *                added to the statistics of the phase.
+ *
+ * IN:            loopPhase_t of the phase that ended
+ * OUT:           Nothing
+ */
+void profilePhaseEnd(loopPhase_t phase);
+
+
+/* Function:      Fetch the statistics of the next phase, one phase every
+ *                profileFrameInterval ms in turns. The statistics of the
+ *                fetched phase are cleared.
+ *
+ * IN:            Pointer to a profileStats_t struct for the statistics
+ * OUT:           true if the statistics were fetched
+ */
+bool getProfile(profileStats_t* stats);
+
+#endif
+
+#endif
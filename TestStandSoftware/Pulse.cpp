@@ -0,0 +1,280 @@
+/* Filename:      Pulse.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Hardware timed one-shot pulses for the igniter relay and the
+ *                high speed camera trigger. The edges are made by the output
+ *                compare units of Timer1 (OC1B, pin 12) and Timer3 (OC3A, pin 5).
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Gpio.h"
+#include "Pulse.h"
+
+/* Pulse explanation:
+ * Timer1 and Timer3 run free in normal mode with a prescaler of 64, one tick = 4us.
+ * Timer1 is shared with the Timebase object, which uses its overflow interrupt
+ * and the compare unit A for the frame clock of the cyclic executive. The compare
+ * unit C plays the patterns of the Buzzer object.
+ * The 16-bit timers wrap every 262ms, so longer delays and widths are split into
+ * intermediate compare matches of at most pulseMaxStep ticks. During those the
+ * compare output is disconnected and the pin follows its PORT bit, which always
+ * mirrors the expected level. Only the final compare match of a phase has the
+ * "set on match" or "clear on match" output mode, so the edge happens exactly
+ * at start + delay and start + delay + width ticks regardless of interrupt latency.
+ *
+ * When the compare output is connected the pin shows the OCnx latch, not PORT.
+ * The latch is kept low whenever the channel is idle: the falling edge clears it
+ * and cancelPulse() and an immediate rising edge update it with a forced compare.
+ *
+ * Arduino's analogWrite() must not be used on the other compare pins of these
+ * timers (pins 2, 3, 11 and 13), since the PWM setup of the timers is replaced here.
+ */
+
+#if F_CPU != 16000000L
+#error "Pulse timing assumes a 16MHz clock"
+#endif
+
+//Longest compare step, leaves half of the timer range as margin
+const uint32_t pulseMaxStep = 0x8000;
+
+//Shortest compare step (ticks). Must be longer than the worst case interrupt latency
+const uint32_t pulseMinStep = 16;
+
+typedef enum {
+  PULSE_IDLE,
+  PULSE_DELAY,
+  PULSE_HIGH
+} pulseState_t;
+
+//Registers of the timer channel driving each output
+struct pulseHardware_t {
+  volatile uint16_t* counter;         //TCNTn
+  volatile uint16_t* compare;         //OCRnx
+  volatile uint8_t* control;          //TCCRnA
+  uint8_t comSet;                     //COMnx1 | COMnx0, set output on match. Also the mask of the COM bits
+  uint8_t comClear;                   //COMnx1, clear output on match
+  volatile uint8_t* interruptMask;    //TIMSKn
+  flagRegister_t* interruptFlags;     //TIFRn, the OCFnx bit has the same position as OCIEnx
+  uint8_t interruptBit;               //OCIEnx
+  volatile uint8_t* port;
+  uint8_t pin;
+};
+
+static const pulseHardware_t hardware[pulseChannelCount] = {
+  {&TCNT1, &OCR1B, &TCCR1A, (1 << COM1B1) | (1 << COM1B0), (1 << COM1B1), &TIMSK1, &TIFR1, OCIE1B, &PORTB, pinBit(IGNITER_CONTROL_PIN)},
+  {&TCNT3, &OCR3A, &TCCR3A, (1 << COM3A1) | (1 << COM3A0), (1 << COM3A1), &TIMSK3, &TIFR3, OCIE3A, &PORTE, pinBit(CAMERA_TRIGGER_PIN)}
+};
+
+static volatile pulseState_t state[pulseChannelCount];
+static volatile uint32_t remainingTicks[pulseChannelCount];   //Ticks of the current phase not yet given to the compare unit
+static volatile uint32_t widthTicks[pulseChannelCount];
+static volatile uint32_t scheduledTicks[pulseChannelCount];   //Ticks from the start of the pulse to the programmed compare match
+
+//Edge times in ticks from startMicros
+static uint32_t startMicros[pulseChannelCount];
+static volatile uint32_t riseTicks[pulseChannelCount];
+static volatile uint32_t fallTicks[pulseChannelCount];
+static volatile uint8_t edgeFlags[pulseChannelCount];
+static volatile bool newEdges[pulseChannelCount];
+
+void initPulse(){
+  pinMode(IGNITER_CONTROL_PIN, OUTPUT);
+  pinMode(CAMERA_TRIGGER_PIN, OUTPUT);
+
+  //Timer1 is started by initTimebase(). Timer3: normal mode, outputs disconnected, prescaler 64
+  TCCR3A = 0;
+  TCCR3C = 0;
+  TCCR3B = (1 << CS31) | (1 << CS30);
+
+  for (uint8_t i = 0; i < pulseChannelCount; i++){
+    *hardware[i].interruptMask &= ~(1 << hardware[i].interruptBit);
+    *hardware[i].port &= ~(1 << hardware[i].pin);
+    state[i] = PULSE_IDLE;
+    remainingTicks[i] = 0;
+    edgeFlags[i] = 0;
+    newEdges[i] = false;
+  }
+}
+
+//Update the OCnx latch by the given COM bits with a forced compare. Leaves the output connected
+static void forceCompare(uint8_t channel, uint8_t outputMode){
+  const pulseHardware_t* hw = &hardware[channel];
+  *hw->control = (*hw->control & ~hw->comSet) | outputMode;
+
+  if (channel == PULSE_IGNITER){
+    TCCR1C = (1 << FOC1B);
+  }else{
+    TCCR3C = (1 << FOC3A);
+  }
+}
+
+//Give the next part of the current phase to the compare unit. Interrupts must be disabled
+static void scheduleCompare(uint8_t channel){
+  const pulseHardware_t* hw = &hardware[channel];
+  uint32_t step = remainingTicks[channel];
+  uint8_t outputMode = 0; //Disconnected, pin follows PORT
+
+  if (step > pulseMaxStep){
+    step = pulseMaxStep;
+
+    //Leave enough ticks for the final compare of the phase
+    if (remainingTicks[channel] - step < pulseMinStep){
+      step -= pulseMinStep;
+    }
+  }else if (state[channel] == PULSE_DELAY){
+    outputMode = hw->comSet;
+  }else{
+    outputMode = hw->comClear;
+  }
+
+  remainingTicks[channel] -= step;
+  scheduledTicks[channel] += step;
+
+  *hw->compare = *hw->compare + (uint16_t) step;
+  *hw->control = (*hw->control & ~hw->comSet) | outputMode;
+}
+
+//Compare match of a channel. Interrupts must be disabled
+static void handleCompare(uint8_t channel){
+  const pulseHardware_t* hw = &hardware[channel];
+
+  if (remainingTicks[channel] > 0){
+    scheduleCompare(channel);
+    return;
+  }
+
+  if (state[channel] == PULSE_DELAY){
+    //Hardware made the rising edge
+    *hw->port |= (1 << hw->pin);
+    riseTicks[channel] = scheduledTicks[channel];
+    edgeFlags[channel] |= PULSE_ROSE;
+    newEdges[channel] = true;
+
+    state[channel] = PULSE_HIGH;
+    remainingTicks[channel] = widthTicks[channel];
+    scheduleCompare(channel);
+
+  }else{
+    //Hardware made the falling edge
+    *hw->port &= ~(1 << hw->pin);
+    *hw->control &= ~hw->comSet;
+    *hw->interruptMask &= ~(1 << hw->interruptBit);
+    fallTicks[channel] = scheduledTicks[channel];
+    edgeFlags[channel] |= PULSE_FELL;
+    newEdges[channel] = true;
+
+    state[channel] = PULSE_IDLE;
+  }
+}
+
+ISR(TIMER1_COMPB_vect){
+  handleCompare(PULSE_IGNITER);
+}
+
+ISR(TIMER3_COMPA_vect){
+  handleCompare(PULSE_CAMERA);
+}
+
+void startPulse(pulseChannel_t channel, uint32_t delayMicros, uint32_t widthMicros){
+  const pulseHardware_t* hw = &hardware[channel];
+
+  uint32_t delay = delayMicros / pulseTickMicros;
+  uint32_t width = widthMicros / pulseTickMicros;
+
+  //The first compare must not be missed
+  if (delay != 0 && delay < pulseMinStep){delay = pulseMinStep;}
+  if (width < pulseMinStep){width = pulseMinStep;}
+
+  cancelPulse(channel);
+
+  uint8_t oldSREG = SREG;
+  cli();
+
+  startMicros[channel] = micros();
+  *hw->compare = *hw->counter;
+  scheduledTicks[channel] = 0;
+  widthTicks[channel] = width;
+  edgeFlags[channel] = 0;
+
+  if (delay == 0){
+    forceCompare(channel, hw->comSet);
+    *hw->port |= (1 << hw->pin);
+    riseTicks[channel] = 0;
+    edgeFlags[channel] = PULSE_ROSE;
+    newEdges[channel] = true;
+
+    state[channel] = PULSE_HIGH;
+    remainingTicks[channel] = width;
+  }else{
+    state[channel] = PULSE_DELAY;
+    remainingTicks[channel] = delay;
+  }
+
+  scheduleCompare(channel);
+
+  //Clear an old compare flag before enabling the interrupt
+  *hw->interruptFlags = (1 << hw->interruptBit);
+  *hw->interruptMask |= (1 << hw->interruptBit);
+
+  SREG = oldSREG;
+}
+
+void cancelPulse(pulseChannel_t channel){
+  const pulseHardware_t* hw = &hardware[channel];
+
+  uint8_t oldSREG = SREG;
+  cli();
+
+  //A compare match the interrupt has not handled yet may already have made an edge
+  if (state[channel] != PULSE_IDLE && (*hw->interruptFlags & (1 << hw->interruptBit))){
+    *hw->interruptFlags = (1 << hw->interruptBit);
+    handleCompare(channel);
+  }
+
+  if (state[channel] != PULSE_IDLE){
+    *hw->interruptMask &= ~(1 << hw->interruptBit);
+    if (state[channel] == PULSE_HIGH){
+      forceCompare(channel, hw->comClear);
+    }
+    *hw->port &= ~(1 << hw->pin);
+    *hw->control &= ~hw->comSet;
+
+    //The programmed compare is still ahead of the counter
+    fallTicks[channel] = scheduledTicks[channel] - (uint16_t) (*hw->compare - *hw->counter);
+    if (state[channel] == PULSE_HIGH){
+      edgeFlags[channel] |= PULSE_FELL;
+    }
+    edgeFlags[channel] |= PULSE_CANCELLED;
+    newEdges[channel] = true;
+
+    state[channel] = PULSE_IDLE;
+  }
+
+  SREG = oldSREG;
+}
+
+bool isPulseActive(pulseChannel_t channel){
+  return state[channel] != PULSE_IDLE;
+}
+
+bool getPulseEdges(pulseChannel_t channel, pulseEdges_t* edges){
+  uint8_t oldSREG = SREG;
+  cli();
+
+  bool updated = newEdges[channel];
+  if (updated){
+    edges->channel = channel;
+    edges->flags = edgeFlags[channel];
+    edges->riseMicros = startMicros[channel] + riseTicks[channel] * pulseTickMicros;
+    edges->fallMicros = startMicros[channel] + fallTicks[channel] * pulseTickMicros;
+    newEdges[channel] = false;
+  }
+
+  SREG = oldSREG;
+  return updated;
+}
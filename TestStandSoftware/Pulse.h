@@ -0,0 +1,66 @@
+/* Filename:      Pulse.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Pulse <<device>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef PULSE_H
+#define PULSE_H
+
+/* Function:      Initialize Timer3 as a free running 4us timebase for the
+ *                camera trigger pulses. The igniter pulses use Timer1, started
+ *                by initTimebase(). Both outputs are left low.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initPulse(void);
+
+
+/* Function:      Start a one-shot pulse on an output. Both edges are made by
+ *                the timer compare hardware, so their timing does not depend
+ *                on the software loop. A pulse already running on the output
+ *                is cancelled first.
+ *
+ * IN:            pulseChannel_t with the output to pulse,
+ *                uint32_t delay from this call to the rising edge (us), 0 = now,
+ *                uint32_t width of the pulse (us)
+ * OUT:           Nothing
+ */
+void startPulse(pulseChannel_t channel, uint32_t delayMicros, uint32_t widthMicros);
+
+
+/* Function:      Stop the pulse of an output and drive the output low.
+ *                Does nothing if no pulse is running.
+ *
+ * IN:            pulseChannel_t with the output
+ * OUT:           Nothing
+ */
+void cancelPulse(pulseChannel_t channel);
+
+
+/* Function:      Check if a pulse is waiting for its rising edge or is high.
+ *
+ * IN:            pulseChannel_t with the output
+ * OUT:           true if the pulse has not ended yet
+ */
+bool isPulseActive(pulseChannel_t channel);
+
+
+/* Function:      Fetch the edge times of the latest pulse of an output if
+ *                they have changed since the last call.
+ *
+ * IN:            pulseChannel_t with the output,
+ *                pulseEdges_t pointer where the edge times will be stored
+ * OUT:           true if new edges were stored
+ */
+bool getPulseEdges(pulseChannel_t channel, pulseEdges_t* edges);
+
+#endif
@@ -0,0 +1,151 @@
+/* Filename:      Retained.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Keeps the mode, the verification result and the restart
+ *                counters over a reset in the .noinit section of RAM, so a
+ *                reset during a test campaign does not start the system from
+ *                scratch. Also does the watchdog reset of the software.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#include "Globals.h"
+#include "Retained.h"
+
+/* Retained state explanation:
+ * The .noinit section is not zeroed by the startup code, so the state survives a watchdog,
+ * external or brown-out reset. After a power-on the RAM holds garbage, which the PORF flag
+ * and the checksum reject. The bootloader may already have cleared MCUSR, then the flags
+ * read zero and the checksum alone decides. Every write updates the checksum, a reset in
+ * the middle of a write leaves a state that is rejected as after a power-on.
+ */
+
+static retainedState_t retained NOINIT;
+
+static uint8_t resetFlags;
+static bool warmStart;
+static uint8_t bootStallPhase;
+static bool bootReported;
+
+static uint16_t retainedChecksum(){
+  const uint8_t* bytes = (const uint8_t*) &retained;
+  uint8_t sum1 = 0;
+  uint8_t sum2 = 0;
+
+  for (uint8_t i = 0; i < offsetof(retainedState_t, checksum); i++){
+    sum1 = (sum1 + bytes[i]) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }
+
+  return (uint16_t) sum2 << 8 | sum1;
+}
+
+//Write the checksum of the current fields with interrupts disabled
+static void sealRetained(){
+  uint8_t oldSREG = SREG;
+  cli();
+  retained.checksum = retainedChecksum();
+  SREG = oldSREG;
+}
+
+void initRetained(){
+  resetFlags = MCUSR;
+  MCUSR = 0;
+  //A watchdog reset leaves the watchdog on with the shortest timeout
+  wdt_disable();
+
+  warmStart = !(resetFlags & (1 << PORF))
+              && retained.layout == retainedLayout
+              && retained.checksum == retainedChecksum();
+
+  if (warmStart){
+    if (retained.warmRestarts != 0xFFFF){
+      retained.warmRestarts++;
+    }
+  }else{
+    retained.layout = retainedLayout;
+    retained.mode = INIT;
+    retained.substate = ALL_OFF;
+    retained.verificationPassed = false;
+    retained.lastFaultRule = -1;
+    retained.warmRestarts = 0;
+    retained.stallPhase = noStall;
+    retained.watchdogStalls = 0;
+    retained.burn.flags = 0;
+  }
+  //The stall is reported once, the next reset starts without one
+  bootStallPhase = retained.stallPhase;
+  retained.stallPhase = noStall;
+  sealRetained();
+
+  bootReported = false;
+}
+
+bool isWarmStart(){
+  return warmStart;
+}
+
+void getRetained(retainedState_t* state){
+  *state = retained;
+}
+
+void retainMode(mode_t mode, substate_t substate){
+  retained.mode = mode;
+  retained.substate = substate;
+  sealRetained();
+}
+
+void retainVerification(bool passed){
+  retained.verificationPassed = passed;
+  sealRetained();
+}
+
+void retainFaultRule(int8_t rule){
+  retained.lastFaultRule = rule;
+  sealRetained();
+}
+
+void retainBurn(const burnSummary_t& summary){
+  retained.burn = summary;
+  sealRetained();
+}
+
+void retainStall(uint8_t phase){
+  retained.stallPhase = phase;
+  if (retained.watchdogStalls != 0xFFFF){
+    retained.watchdogStalls++;
+  }
+  sealRetained();
+}
+
+bool getBootReport(bootReport_t* report, mode_t currentMode){
+  if (bootReported){
+    return false;
+  }
+  bootReported = true;
+
+  report->resetFlags = resetFlags;
+  report->warmStart = warmStart;
+  report->restoredMode = currentMode;
+  report->warmRestarts = retained.warmRestarts;
+  report->stallPhase = bootStallPhase;
+  report->watchdogStalls = retained.watchdogStalls;
+
+  return true;
+}
+
+void softwareReset(){
+  retainMode(INIT, ALL_OFF);
+
+  wdt_enable(softwareResetTimeout);
+  //Sleep until the watchdog resets the system
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while (true){
+    sleep_enable();
+    sleep_cpu();
+  }
+}
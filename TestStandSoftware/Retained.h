@@ -0,0 +1,105 @@
+/* Filename:      Retained.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Retained <<passive>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef RETAINED_H
+#define RETAINED_H
+
+/* Function:      Initialize the Retained object. Reads and clears the reset
+ *                flags, stops the watchdog left on by a watchdog reset and
+ *                checks the state kept over the reset. Must be the first
+ *                initialization.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initRetained(void);
+
+
+/* Function:      Tell if the state of the previous run was kept over the reset.
+ *
+ * IN:            Nothing
+ * OUT:           Boolean, true on a warm start
+ */
+bool isWarmStart(void);
+
+
+/* Function:      Get a copy of the kept state. After a cold boot it holds the
+ *                defaults: INIT, ALL_OFF, no verification, no fault rule and no burn.
+ *
+ * IN:            retainedState_t pointer where the state will be stored
+ * OUT:           Nothing
+ */
+void getRetained(retainedState_t* state);
+
+
+/* Function:      Keep the current mode and substate over a reset.
+ *
+ * IN:            mode_t current mode,
+ *                substate_t current substate
+ * OUT:           Nothing
+ */
+void retainMode(mode_t mode, substate_t substate);
+
+
+/* Function:      Keep the result of the verification sequence over a reset.
+ *
+ * IN:            Boolean telling if the verification passed
+ * OUT:           Nothing
+ */
+void retainVerification(bool passed);
+
+
+/* Function:      Keep the latest fault rule that triggered SAFE over a reset.
+ *
+ * IN:            int8_t rule, see getLastFaultRule()
+ * OUT:           Nothing
+ */
+void retainFaultRule(int8_t rule);
+
+
+/* Function:      Keep the summary of the last burn over a reset.
+ *
+ * IN:            Reference to the burnSummary_t
+ * OUT:           Nothing
+ */
+void retainBurn(const burnSummary_t& summary);
+
+
+/* Function:      Keep the phase of the executive where the watchdog expired over
+ *                the coming reset. Called from the watchdog interrupt.
+ *
+ * IN:            uint8_t stall phase, task_t | stallInTask
+ * OUT:           Nothing
+ */
+void retainStall(uint8_t phase);
+
+
+/* Function:      Fetch the boot report once after a reset.
+ *
+ * IN:            bootReport_t pointer where the report will be stored,
+ *                mode_t current mode
+ * OUT:           Boolean telling if the report was fetched
+ */
+bool getBootReport(bootReport_t* report, mode_t currentMode);
+
+
+/* Function:      Reset the system with the watchdog. The kept mode is cleared,
+ *                so the system starts as after a cold boot, but the counters
+ *                and the verification result are kept.
+ *
+ * IN:            Nothing
+ * OUT:           Does not return
+ */
+void softwareReset(void) __attribute__((noreturn));
+
+#endif
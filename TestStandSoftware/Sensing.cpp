@@ -9,7 +9,7 @@
  *                Contains the FreeRTOS task called senseLoop.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 
 #include "Sensors.h"
 #include "Sensing.h"
@@ -19,94 +19,250 @@
 #include "InfraRed.h"
 #include "Globals.h"
 #include "ControlSensing.h"
+#include "TestInOut.h"
+#include "Bench.h"
+#include "Timebase.h"
 
 //When were the slower sensors measured last time
 static uint32_t lastSlowTime = 0;
 static uint32_t lastMediumTime = 0;
- 
-uint32_t newTime;
 
-bool updateSlow;
-bool updateMedium;
+//Periods of the slower sensors (ms), from the rates set by the Rock
+static uint16_t mediumPeriod;
+static uint16_t slowPeriod;
+
+/* Cold channel explanation:
+ * Outside SEQUENCE the cold channels are read in the same call as the hot ones. In SEQUENCE
+ * reading all of them takes longer than the burst sample period, so the read is split into
+ * steps and one step is done after the hot channels of each sample. The updated flags are
+ * set at the last step, so the consumers see a complete set, read within COLD_STEP_COUNT
+ * sample periods. The slow channels are read first when a slow update is due.
+ */
+typedef enum{
+  COLD_NOZZLE_TC,             //Slow channels, only when a slow update is due
+  COLD_PIPING_TC,
+  COLD_ANALOG_TEMPERATURES,   //TMP36, IR and the thermocouple fault bits
+  COLD_LINE_N2,               //Medium channels
+  COLD_N2O_CONTROLS,          //Completes the read
+  COLD_STEP_COUNT
+}coldStep_t;
+
+//Next step of the read in progress, COLD_STEP_COUNT when there is none
+static uint8_t coldStep;
+static bool coldSlow;
+
+//Sample timing of the current mode
+static mode_t timingMode;
+static uint32_t timingSamples;
+static uint32_t timingMisses;
+static uint32_t maxLateness;
+static uint32_t timingHistogram[timingHistogramBins];
+
+//Final timing of the previous mode, sent once
+static sampleTiming_t finishedTiming;
+static bool finishedPending;
+static uint32_t lastTimingTime;
+
+static void clearTiming(mode_t mode){
+  timingMode = mode;
+  timingSamples = 0;
+  timingMisses = 0;
+  maxLateness = 0;
+  for (uint8_t i = 0; i < timingHistogramBins; i++){
+    timingHistogram[i] = 0;
+  }
+}
+
+static void fillTiming(sampleTiming_t* timing){
+  timing->mode = timingMode;
+  timing->samples = timingSamples;
+  timing->misses = timingMisses > 0xFFFF ? 0xFFFF : timingMisses;
+  timing->maxLateness = maxLateness > 0xFFFF ? 0xFFFF : maxLateness;
+
+  for (uint8_t i = 0; i < timingHistogramBins; i++){
+    timing->histogram[i] = timingSamples ? (timingHistogram[i] * 255ULL + timingSamples / 2) / timingSamples : 0;
+  }
+}
+
+//Add the time since the previous sample to the timing statistics of the mode
+static void accountSample(uint32_t sampleTimeDiff, mode_t currentMode){
+  if (currentMode != timingMode){
+    //The first interval of a mode belongs to the mode change and is not counted
+    if (timingSamples > 0){
+      fillTiming(&finishedTiming);
+      finishedPending = true;
+    }
+    clearTiming(currentMode);
+    return;
+  }
+
+  uint32_t deadline = ((currentMode == SEQUENCE) ? usPerSample : limitedSamplePeriod) + sampleIntervalTolerance;
+  uint8_t bin = 0;
+
+  if (sampleTimeDiff > deadline){
+    uint32_t lateness = sampleTimeDiff - deadline;
+    timingMisses++;
+    if (lateness > maxLateness){
+      maxLateness = lateness;
+    }
+
+    //Bin 1 is under d/8, every next bin doubles the limit
+    bin = 1;
+    uint32_t limit = deadline >> 3;
+    while (bin < timingHistogramBins - 1 && lateness >= limit){
+      limit <<= 1;
+      bin++;
+    }
+  }
+
+  timingSamples++;
+  timingHistogram[bin]++;
+}
 
 
 void initSensing(){
-  //Nothing to initalize here
+  lastSlowTime = 0;
+  lastMediumTime = 0;
+  coldStep = COLD_STEP_COUNT;
+  setSensorRates(mediumSensorRate, slowSensorRate);
+
+  clearTiming(INIT);
+  finishedPending = false;
+  lastTimingTime = 0;
 }
 
-void senseLoop(values_t* values, mode_t currentMode){
+bool setSensorRates(uint16_t mediumRate, uint16_t slowRate){
+  if (slowRate == 0 || slowRate > mediumRate || mediumRate > 1000){
+    return false;
+  }
 
-  //Save timestamp
-  uint64_t newTimestamp = micros();
+  mediumPeriod = 1000 / mediumRate;
+  slowPeriod = 1000 / slowRate;
+  return true;
+}
 
-  //Account for 32-bit counter overflow
-  if (newTimestamp < values->checkTimestamp){
-    values->timeOverflowOffset = values->timeOverflowOffset + 4294967295;
+bool getSampleTiming(sampleTiming_t* timing){
+  if (finishedPending){
+    *timing = finishedTiming;
+    finishedPending = false;
+    return true;
   }
 
-  values->checkTimestamp = newTimestamp;
-  newTimestamp += values->timeOverflowOffset;  //Arduino time in us
-
-  //Calculate time since last values
-  uint32_t sampleTimeDiff = newTimestamp - values->timestamp;
-
-  //Serial.print(usPerSample);
-  //Serial.print(" ");
-  //Serial.println(sampleTimeDiff);
-  
-  //If not enough time has passed, wait and update timestamp
-  if (sampleTimeDiff < usPerSample){
-    delayMicroseconds(usPerSample - sampleTimeDiff);
-    newTimestamp += (usPerSample - sampleTimeDiff);
-    //Serial.print("delayed: ");
-    //Serial.println(usPerSample - sampleTimeDiff);
+  uint32_t now = millis();
+  if (now - lastTimingTime < timingFrameInterval){
+    return false;
   }
+  lastTimingTime = now;
 
-  //Serial.print((uint32_t) (newTimestamp - values->lastTimestamp));
-  //Serial.print(" ");
-  //Serial.print(sampleTimeDiff);
-  //Serial.print(" ");
-  //Serial.println(micros());
-  
-  //Update old and new timestamps
-  values->timestamp = newTimestamp;
+  fillTiming(timing);
+  return true;
+}
 
-  // These values are saved in every MODE and SUBSTATE
-  values->combustionPressure = readPressure5V(CHAMBER_PRESSURE);          //Chamber pressure 
-  values->loadCell = readLoad();  //Load cell for thrust
+void readAnalogChannels(values_t* sample){
+  sample->hot.tick = timebaseTicks();
+  sample->cold.mediumUpdated = true;
+  sample->cold.slowUpdated = false;
 
-  newTime = millis();
-  updateMedium = newTime - lastMediumTime > 1000/mediumSensorRate;
+  sample->hot.combustionPressure = readPressure5V(CHAMBER_PRESSURE);
+  sample->hot.loadCell = readLoad();
+  sample->cold.linePressure = readPressure5V(LINE_PRESSURE);
+  sample->cold.N2FeedingPressure = readPressure5V(FEEDING_PRESSURE_N2);
+  sample->cold.N2OFeedingPressure = readPressure5V(FEEDING_PRESSURE_OXIDIZER);
+}
 
-  // Non essential values are sent at a reduced rate during the firing
-  if (currentMode != SEQUENCE || updateMedium){
-    values->mediumUpdated = true;
-    lastMediumTime = newTime;
+//Start a read of the medium channels, and of the slow ones if they are due
+static void startColdRead(uint32_t now){
+  lastMediumTime = now;
+  coldSlow = now - lastSlowTime > slowPeriod;
+  if (coldSlow){
+    lastSlowTime = now;
+  }
+  coldStep = coldSlow ? COLD_NOZZLE_TC : COLD_LINE_N2;
+}
 
-    values->linePressure = readPressure5V(LINE_PRESSURE);                        //Line pressure 
-    values->N2FeedingPressure = readPressure5V(FEEDING_PRESSURE_N2);             //N2 Feeding pressure 
-    values->N2OFeedingPressure = readPressure5V(FEEDING_PRESSURE_OXIDIZER);      //Oxidizer Feeding Pressure 
+//Do the next step of the read in progress
+static void readColdStep(coldValues_t* cold){
+  switch (coldStep){
+    case COLD_NOZZLE_TC:
+      cold->nozzleTemperature = readTemp(NOZZLE_TC);             //Nozzle temperature
+      break;
 
-    updateSlow = newTime - lastSlowTime > 1000/slowSensorRate;
+    case COLD_PIPING_TC:
+      cold->pipingTemperature = readTemp(PIPING_TC);             //Piping temperature
+      break;
 
-    if (updateSlow == true) {
-      values->slowUpdated = true;
-      lastSlowTime = newTime;
+    case COLD_ANALOG_TEMPERATURES:
+      cold->bottleTemperature = readTMP36();                     //Bottle/Heating blanket temperature
+      cold->notConnectedTemperature = 0;//readTemp(NOT_CONNECTED_1);   //Not connected
+      cold->temperatureFaults = readTempFaults();               //Thermocouple fault bits
 
-      values->bottleTemperature = readTMP36();                     //Bottle/Heating blanket temperature
-      values->notConnectedTemperature = 0;//readTemp(NOT_CONNECTED_1);   //Not connected
-      values->nozzleTemperature = readTemp(NOZZLE_TC);             //Nozzle temperature
-      values->pipingTemperature = readTemp(PIPING_TC);            //Piping temperature
+      cold->IR = readIR();   //Plume temperature
+      break;
 
-      values->IR = readIR();   //Plume temperature
-    }
+    case COLD_LINE_N2:
+      cold->linePressure = readPressure5V(LINE_PRESSURE);                        //Line pressure 
+      cold->N2FeedingPressure = readPressure5V(FEEDING_PRESSURE_N2);             //N2 Feeding pressure 
+      break;
+
+    case COLD_N2O_CONTROLS:
+      cold->N2OFeedingPressure = readPressure5V(FEEDING_PRESSURE_OXIDIZER);      //Oxidizer Feeding Pressure 
+
+      //Read control signals
+      cold->dumpValveButton = readDumpValveButton();           //Dump Valve button status (inverted afterwards due to normally open valve)
+      cold->heatingBlanketButton = readHeatingButton();        //Heating button status
+      cold->ignitionButton = readIgnitionButton();             //Ignition button status
+      cold->n2FeedingButton = readN2FeedingValveButton();      //N2 Feeding button status
+      cold->oxidizerValveButton = readOxidizerValveButton();   //Main oxidizer button status
+
+      cold->mediumUpdated = true;
+      cold->slowUpdated = coldSlow;
+      break;
+  }
+  coldStep++;
+}
+
+void senseLoop(values_t* values, mode_t currentMode){
+
+  //Save the sample time. The 32-bit tick wraps, only the difference is used
+  uint32_t newTick = timebaseTicks();
 
-    //Read control signals
-    values->dumpValveButton = readDumpValveButton();           //Dump Valve button status (inverted afterwards due to normally open valve)
-    values->heatingBlanketButton = readHeatingButton();        //Heating button status
-    values->ignitionButton = readIgnitionButton();             //Ignition button status
-    values->n2FeedingButton = readN2FeedingValveButton();      //N2 Feeding button status
-    values->oxidizerValveButton = readOxidizerValveButton();   //Main oxidizer button status
-    
+  //The sample period is kept by the frame clock of the cyclic executive, see Executive.cpp
+  accountSample((newTick - values->hot.tick) * timebaseTickMicros, currentMode);
+  values->hot.tick = newTick;
+
+  BENCH_ENTER(BENCH_SENSE_LOOP);
+
+  // These values are saved in every MODE and SUBSTATE
+  values->hot.combustionPressure = readPressure5V(CHAMBER_PRESSURE);          //Chamber pressure 
+  values->hot.loadCell = readLoad();  //Load cell for thrust
+
+  //IGN_GND relay test input, sampled with every sample in TEST so the verification
+  //never judges a sample taken before the relay switched, whatever the slow rate is
+  if (currentMode == TEST){
+    sampleIgnitionGround();
+  }
+
+  //The cold values are only written when they are sampled
+  coldValues_t* cold = &values->cold;
+  cold->mediumUpdated = false;
+  cold->slowUpdated = false;
+
+  uint32_t now = millis();
+
+  // Non essential values are sent at a reduced rate during the firing
+  if (currentMode != SEQUENCE){
+    startColdRead(now);
+    while (coldStep < COLD_STEP_COUNT){
+      readColdStep(cold);
+    }
+  }else{
+    if (coldStep == COLD_STEP_COUNT && now - lastMediumTime > mediumPeriod){
+      startColdRead(now);
     }
+    if (coldStep < COLD_STEP_COUNT){
+      readColdStep(cold);
+    }
+  }
+
+  BENCH_EXIT(BENCH_SENSE_LOOP);
 }
@@ -20,7 +20,8 @@ void initSensing(void);
 
 
 /* Function:      Function for handling the measurements of the different sensors
- *                and saving the timestamp
+ *                and saving the timestamp. In SEQUENCE a read of the cold
+ *                channels is spread over several calls, one step per call.
  *
  * IN:            values_t pointer where the new measurements are saved
  *                substate_t telling which substate the system is in
@@ -28,4 +29,36 @@ void initSensing(void);
  */
 void senseLoop(values_t* values, mode_t currentMode);
 
+
+/* Function:      Set the rates of the medium and slow sensors. The medium rate
+ *                only applies in SEQUENCE, outside it the medium sensors are
+ *                read with every sample.
+ *
+ * IN:            uint16_t medium rate (Hz), 1...1000,
+ *                uint16_t slow rate (Hz), 1...medium rate
+ * OUT:           Boolean telling if the rates were valid and taken into use
+ */
+bool setSensorRates(uint16_t mediumRate, uint16_t slowRate);
+
+
+/* Function:      Fetch the sample timing statistics of the current mode every
+ *                timingFrameInterval ms. When the mode has changed, the final
+ *                statistics of the previous mode are fetched first. The
+ *                statistics restart on every mode change.
+ *
+ * IN:            Pointer to a sampleTiming_t struct for the statistics
+ * OUT:           true if the statistics were fetched
+ */
+bool getSampleTiming(sampleTiming_t* timing);
+
+
+/* Function:      Read the pressure sensors and the load cell between the
+ *                samples of senseLoop(), for the statistics of the channels.
+ *                Marked as a medium sample without the slow sensors.
+ *
+ * IN:            values_t pointer where the readings are saved
+ * OUT:           Nothing
+ */
+void readAnalogChannels(values_t* sample);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,163 @@
+/* Filename:      SensorHealth.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Keeps a health flag for each measured channel and cross-checks
+ *                physically related channels against each other. Used by the
+ *                FaultDetection object so a single faulty sensor can neither
+ *                trigger nor hide a SAFE transition.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+#include "SensorHealth.h"
+#include "Config.h"
+
+//Structure for the health limits of a single channel
+struct healthLimits_t{
+  int16_t low;            //Raw values below are out of range
+  int16_t high;           //Raw values above are out of range
+  bool checkStuck;        //Is the channel flagged if it doesn't change during the burn
+};
+
+/* Health limits of each channel, in the order of sensorChannel_t.
+ * The pressure sensors read close to zero at ambient pressure and saturate
+ * above their range, so they are not range checked. A saturated chamber
+ * pressure sensor still has to be able to vote for SAFE, so a reading at
+ * maxADC is never counted as stuck. A sensor stuck at zero can't vote for
+ * SAFE and is still flagged, which leaves the vote to the other sensor.
+ */
+static constexpr healthLimits_t healthLimits[channelCount] = {
+  {0, maxADC, false},                                                           //CH_N2_FEEDING_PRESSURE
+  {0, maxADC, false},                                                           //CH_LINE_PRESSURE
+  {0, maxADC, true},                                                            //CH_CHAMBER_PRESSURE
+  {0, maxADC, false},                                                           //CH_N2O_FEEDING_PRESSURE
+  {voltageToADC(loadCellDisconnectedVoltage), maxADC, true},                    //CH_LOAD_CELL
+  {0, maxADC, false},                                                           //CH_BOTTLE_TEMPERATURE
+  {temperatureToRaw(minThermocouple), temperatureToRaw(maxThermocouple), false}, //CH_NOZZLE_TEMPERATURE
+  {temperatureToRaw(minThermocouple), temperatureToRaw(maxThermocouple), false}, //CH_PIPING_TEMPERATURE
+  {0, maxADC, false}                                                            //CH_IR
+};
+
+//Mapping of the oxidizer feeding pressure to the line pressure sensor, see lineMapGain().
+//Converted from the calibration and limits of the config in initSensorHealth()
+static int16_t feedToLineGain;
+static int16_t feedToLineOffset;
+
+static int16_t chamberBurnLevel;
+static int16_t loadBurnLevel;
+
+static uint16_t unhealthyChannels;
+static uint8_t crossCheckFaults;
+
+static int16_t lastValue[channelCount];
+static int16_t stuckCount[channelCount];
+static int16_t lineFeedCount;
+static int16_t chamberLoadCount;
+
+void updateHealthLimits(){
+  const config_t* config = getConfig();
+  calibrationLine_t feedCalibration = getCalibration(CH_N2O_FEEDING_PRESSURE);
+  calibrationLine_t lineCalibration = getCalibration(CH_LINE_PRESSURE);
+
+  feedToLineGain = lineMapGain(feedCalibration, lineCalibration);
+  feedToLineOffset = lineMapOffset(feedCalibration, lineCalibration, config->calibrationADC)
+                     + lineDeltaToADC(lineCalibration, config->calibrationADC, config->lineFeedTolerance);
+
+  chamberBurnLevel = lineToADC(getCalibration(CH_CHAMBER_PRESSURE), config->calibrationADC, config->chamberBurnPressure);
+  loadBurnLevel = lineToADC(getCalibration(CH_LOAD_CELL), config->calibrationADC, config->loadCellBurnThrust);
+}
+
+void initSensorHealth(){
+  updateHealthLimits();
+
+  unhealthyChannels = 0;
+  crossCheckFaults = 0;
+  lineFeedCount = 0;
+  chamberLoadCount = 0;
+
+  for (uint8_t i = 0; i < channelCount; i++){
+    lastValue[i] = 0;
+    stuckCount[i] = 0;
+  }
+}
+
+//Count successive disagreeing samples and set or clear the cross check fault bit
+static void crossCheckResult(crossCheckNames_t check, int16_t* count, bool disagree){
+  if (disagree){
+    if (*count <= crossCheckPasses){
+      (*count)++;
+    }else{
+      crossCheckFaults |= (1 << check);
+    }
+  }else{
+    *count = 0;
+    crossCheckFaults &= ~(1 << check);
+  }
+}
+
+void updateSensorHealth(const values_t& values, substate_t substate){
+  //Stuck channels are only detected while the engine is burning and the values have to change
+  bool burning = (substate == VALVE_ON || substate == IGNIT_OFF);
+
+  for (uint8_t i = 0; i < channelCount; i++){
+    sensorChannel_t channel = (sensorChannel_t) i;
+
+    if (!channelUpdated(values, channel)){
+      continue;
+    }
+
+    int16_t value = channelValue(values, channel);
+    bool healthy = (value >= healthLimits[i].low) && (value <= healthLimits[i].high);
+
+    if (healthLimits[i].checkStuck){
+      if (burning && value == lastValue[i] && value < maxADC){
+        if (stuckCount[i] < stuckSampleLimit){
+          stuckCount[i]++;
+        }else{
+          healthy = false;
+        }
+      }else{
+        stuckCount[i] = 0;
+      }
+      lastValue[i] = value;
+    }
+
+    if (healthy){
+      unhealthyChannels &= ~(1 << i);
+    }else{
+      unhealthyChannels |= (1 << i);
+    }
+  }
+
+  //Thermocouple fault bits override the reported temperature
+  if (values.cold.slowUpdated){
+    if (values.cold.temperatureFaults & (1 << NOZZLE_TC)){unhealthyChannels |= (1 << CH_NOZZLE_TEMPERATURE);}
+    if (values.cold.temperatureFaults & (1 << PIPING_TC)){unhealthyChannels |= (1 << CH_PIPING_TEMPERATURE);}
+  }
+
+  //Line pressure is downstream of the oxidizer feeding pressure and can't be higher
+  if (values.cold.mediumUpdated){
+    int16_t maxLinePressure = (((int32_t) values.cold.N2OFeedingPressure * feedToLineGain) >> 8) + feedToLineOffset;
+    crossCheckResult(CROSS_LINE_FEED, &lineFeedCount, (int16_t) values.cold.linePressure > maxLinePressure);
+  }
+
+  //During the burn chamber pressure and thrust have to agree on whether the engine is burning
+  if (burning){
+    bool chamberBurning = (int16_t) values.hot.combustionPressure > chamberBurnLevel;
+    bool loadBurning = (int16_t) values.hot.loadCell > loadBurnLevel;
+    crossCheckResult(CROSS_CHAMBER_LOAD, &chamberLoadCount, chamberBurning != loadBurning);
+  }else{
+    crossCheckResult(CROSS_CHAMBER_LOAD, &chamberLoadCount, false);
+  }
+}
+
+uint16_t getUnhealthyChannels(){
+  return unhealthyChannels;
+}
+
+uint8_t getCrossCheckFaults(){
+  return crossCheckFaults;
+}
@@ -0,0 +1,60 @@
+/* Filename:      SensorHealth.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the SensorHealth <<passive>> object. 
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef SENSORHEALTH_H
+#define SENSORHEALTH_H
+
+/* Function:      Initialize the SensorHealth object. All channels start healthy.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initSensorHealth(void);
+
+
+/* Function:      Convert the cross check limits from the config in use.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void updateHealthLimits(void);
+
+
+/* Function:      Update the health flags of the channels sampled this loop
+ *                and cross-check physically related channels against each other.
+ *                Bounded time: one pass over the channels and a fixed number of checks.
+ *
+ * IN:            Reference to a values_t struct with the newest measurements,
+ *                current substate of the system
+ * OUT:           Nothing
+ */
+void updateSensorHealth(const values_t& values, substate_t substate);
+
+
+/* Function:      Get the channels currently flagged unhealthy
+ *                (out of range, stuck or thermocouple fault)
+ *
+ * IN:            Nothing
+ * OUT:           Bitmask of unhealthy channels, bit = sensorChannel_t
+ */
+uint16_t getUnhealthyChannels(void);
+
+
+/* Function:      Get the cross checks currently failing
+ *
+ * IN:            Nothing
+ * OUT:           Bitmask of failing cross checks, bit = crossCheckNames_t
+ */
+uint8_t getCrossCheckFaults(void);
+
+#endif
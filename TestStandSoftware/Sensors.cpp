@@ -8,7 +8,7 @@
  */
 
 #include "Globals.h"
-#include <Arduino.h>
+#include "Hal.h"
 //#include "LatestValues.h"
 //#include "FaultDetection.h"
 #include "Sensing.h"
@@ -29,6 +29,18 @@ void getValuesFromSensors(values_t* values, mode_t currentMode){
   senseLoop(values, currentMode);
 }
 
+bool getTimingFromSensors(sampleTiming_t* timing){
+  return getSampleTiming(timing);
+}
+
+bool setRatesOfSensors(uint16_t mediumRate, uint16_t slowRate){
+  return setSensorRates(mediumRate, slowRate);
+}
+
+void getAnalogFromSensors(values_t* sample){
+  readAnalogChannels(sample);
+}
+
 /*
 void sendToCheck(values_t values){
   checkData(values);
@@ -32,6 +32,36 @@ void initSensors(void);
 void getValuesFromSensors(values_t* values, mode_t currentMode);
 
 
+/* Function:      Intermediate interface for getting the sample timing
+ *                statistics of the Sensing object.
+ *                Uses the getSampleTiming() interface.
+ *
+ * IN:            Pointer to a sampleTiming_t struct for the statistics
+ * OUT:           true if the statistics were fetched
+ */
+bool getTimingFromSensors(sampleTiming_t* timing);
+
+
+/* Function:      Intermediate interface for setting the rates of the slower
+ *                sensors in the Sensing object.
+ *                Uses the setSensorRates() interface.
+ *
+ * IN:            uint16_t medium rate (Hz), uint16_t slow rate (Hz)
+ * OUT:           true if the rates were taken into use
+ */
+bool setRatesOfSensors(uint16_t mediumRate, uint16_t slowRate);
+
+
+/* Function:      Intermediate interface for reading the analog channels
+ *                between the samples in the Sensing object.
+ *                Uses the readAnalogChannels() interface.
+ *
+ * IN:            values_t pointer where the readings will be stored
+ * OUT:           Nothing
+ */
+void getAnalogFromSensors(values_t* sample);
+
+
 /* Function:      Intermediate interface for calling the senseLoop function
  *                in the sensing object. Uses the senseLoop() interface.
  *
@@ -7,10 +7,12 @@
  *                the Arduino Serial interface to a Rock 4C+ microcomputer.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 #include <cppQueue.h>
 
 #include "Globals.h"
+#include "Bench.h"
+#include "Timebase.h"
 
 cppQueue msgBuffer(sizeof(uint16_t), msgBufferSize, FIFO, true);
 uint16_t msgIndex = 0;
@@ -19,24 +21,26 @@ uint16_t msgIndex = 0;
 unsigned char byteBuffer[20];
 unsigned char bufferLength;
 
-//These are used to start, end and mask the message
+//These are used to start, end and mask the message. See END_MARKER of Globals.h
 //const uint8_t START_MARKER = 0x7E;
-const uint8_t END_MARKER = 0x7F;
-const uint8_t ESCAPE_BYTE = 0x7D;
-const uint8_t ESCAPE_XOR = 0x20;
 
 uint32_t lastMicros = 0;
 
 void initSerial(){
   Serial.begin(serialBaudNormal);
   //Serial.begin(115200);
-  while (!Serial){}
+
+  msgBuffer.flush();
+  msgIndex = 0;
+  lastMicros = 0;
 
   //Indicate reset of the system
   //Serial.print("\n r\n");
 }
 
 void sendByteArray(uint8_t *data, uint8_t length) {
+  BENCH_ENTER(BENCH_SEND_BYTE_ARRAY);
+
   //Serial.write(START_MARKER);
   for (uint8_t i = 0; i < length; i++) {
     //if (data[i] == START_MARKER || data[i] == END_MARKER || data[i] == ESCAPE_BYTE) {
@@ -48,74 +52,83 @@ void sendByteArray(uint8_t *data, uint8_t length) {
     }
   }
   Serial.write(END_MARKER);
+
+  BENCH_EXIT(BENCH_SEND_BYTE_ARRAY);
+}
+
+bool serialHasRoom(uint8_t length){
+  return Serial.availableForWrite() >= length;
 }
 
-void writeValues(values_t* values, statusValues_t statusValues){
+void writeValues(const values_t& values, const statusValues_t& statusValues){
+  BENCH_ENTER(BENCH_WRITE_VALUES);
+
   msgIndex = 0;
   bufferLength = 3;
     
   // Only the most essential values are sent in the burst mode
-  if (statusValues.mode == SEQUENCE && values->slowUpdated == false && values->mediumUpdated == false){
+  if (statusValues.mode == SEQUENCE && values.cold.slowUpdated == false && values.cold.mediumUpdated == false){
       // First 32bit data - sent always
-      uint32_t combinedValue1 = values->combustionPressure;
-      combinedValue1 = combinedValue1 << (10) | values->loadCell;
+      uint32_t combinedValue1 = values.hot.combustionPressure;
+      combinedValue1 = combinedValue1 << (10) | values.hot.loadCell;
       combinedValue1 = combinedValue1 << (1) | statusValues.ignitionEngagedActive;
       combinedValue1 = combinedValue1 << (1) | statusValues.valveActive;
       //combinedValue1 = combinedValue1 << 2;
       
       //Add combinedValue1 to byteBuffer
-      byteBuffer[0] = combinedValue1 >> 16 & 255;
-      byteBuffer[1] = combinedValue1 >> 8 & 255;
+      byteBuffer[0] = (combinedValue1 >> 16) & 255;
+      byteBuffer[1] = (combinedValue1 >> 8) & 255;
       byteBuffer[2] = combinedValue1 & 255;
 
       //Add combinedValue1 to byteBuffer
-      //byteBuffer[0] = combinedValue1 >> 24 & 255;
-      //byteBuffer[1] = combinedValue1 >> 16 & 255;
-      //byteBuffer[2] = combinedValue1 >> 8 & 255;
+      //byteBuffer[0] = (combinedValue1 >> 24) & 255;
+      //byteBuffer[1] = (combinedValue1 >> 16) & 255;
+      //byteBuffer[2] = (combinedValue1 >> 8) & 255;
       //byteBuffer[3] = combinedValue1 & 255; 
 
   }else{
 
     bufferLength = 12;
 
-    uint32_t sentTimeValue = (uint32_t) (values->timestamp >> 3); // Bitshift by 3 to get 8*72 minutes of runtime without 32bit overflow
+    // Time in 8us units to get 8*72 minutes of runtime without 32bit overflow. Only the longer lines need the extended time
+    uint32_t sentTimeValue = (uint32_t) (extendTicks(values.hot.tick) * timebaseTickMicros >> 3);
 
-    byteBuffer[0] = sentTimeValue >> 24 & 255;
-    byteBuffer[1] = sentTimeValue >> 16 & 255;
-    byteBuffer[2] = sentTimeValue >> 8 & 255;
+    byteBuffer[0] = (sentTimeValue >> 24) & 255;
+    byteBuffer[1] = (sentTimeValue >> 16) & 255;
+    byteBuffer[2] = (sentTimeValue >> 8) & 255;
     byteBuffer[3] = sentTimeValue & 255;
 
     // First 32bit data - sent always
-    uint32_t combinedValue1 = values->N2FeedingPressure;
-    combinedValue1 = combinedValue1 << (10) | values->linePressure;
-    combinedValue1 = combinedValue1 << (10) | values->combustionPressure;
-    combinedValue1 = combinedValue1 << (1) |  values->dumpValveButton;
-    combinedValue1 = combinedValue1 << (1) | values->heatingBlanketButton;
+    uint32_t combinedValue1 = values.cold.N2FeedingPressure;
+    combinedValue1 = combinedValue1 << (10) | values.cold.linePressure;
+    combinedValue1 = combinedValue1 << (10) | values.hot.combustionPressure;
+    combinedValue1 = combinedValue1 << (1) |  values.cold.dumpValveButton;
+    combinedValue1 = combinedValue1 << (1) | values.cold.heatingBlanketButton;
 
     //Add combinedValue1 to byteBuffer
-    byteBuffer[4] = combinedValue1 >> 24 & 255;
-    byteBuffer[5] = combinedValue1 >> 16 & 255;
-    byteBuffer[6] = combinedValue1 >> 8 & 255;
+    byteBuffer[4] = (combinedValue1 >> 24) & 255;
+    byteBuffer[5] = (combinedValue1 >> 16) & 255;
+    byteBuffer[6] = (combinedValue1 >> 8) & 255;
     byteBuffer[7] = combinedValue1 & 255; 
 
     //Second 32bit data - sent always
-    uint32_t combinedValue2 = values->N2OFeedingPressure;
-    combinedValue2 = combinedValue2 << (10) | values->loadCell;
-    combinedValue2 = combinedValue2 << (1) | values->ignitionButton;
-    combinedValue2 = combinedValue2 << (1) | values->n2FeedingButton;
-    combinedValue2 = combinedValue2 << (1) | values->oxidizerValveButton;
+    uint32_t combinedValue2 = values.cold.N2OFeedingPressure;
+    combinedValue2 = combinedValue2 << (10) | values.hot.loadCell;
+    combinedValue2 = combinedValue2 << (1) | values.cold.ignitionButton;
+    combinedValue2 = combinedValue2 << (1) | values.cold.n2FeedingButton;
+    combinedValue2 = combinedValue2 << (1) | values.cold.oxidizerValveButton;
     combinedValue2 = combinedValue2 << (1) | statusValues.ignitionEngagedActive;
     combinedValue2 = combinedValue2 << (1) | statusValues.valveActive;
     combinedValue2 = combinedValue2 << (3) | statusValues.mode;
     combinedValue2 = combinedValue2 << (3) | statusValues.subState;
 
     //Add combinedValue2 to byteBuffer
-    byteBuffer[8] = combinedValue2 >> 24 & 255;
-    byteBuffer[9] = combinedValue2 >> 16 & 255;
-    byteBuffer[10] = combinedValue2 >> 8 & 255;
+    byteBuffer[8] = (combinedValue2 >> 24) & 255;
+    byteBuffer[9] = (combinedValue2 >> 16) & 255;
+    byteBuffer[10] = (combinedValue2 >> 8) & 255;
     byteBuffer[11] = combinedValue2 & 255;
 
-    if (values->slowUpdated == true){
+    if (values.cold.slowUpdated == true){
       
       if (!msgBuffer.isEmpty()){
         msgBuffer.pop(&msgIndex);
@@ -124,61 +137,236 @@ void writeValues(values_t* values, statusValues_t statusValues){
       bufferLength = 20;
 
       //Third 32bit data - sent at most every 100ms
-      uint32_t combinedValue3 = values->nozzleTemperature;
-      combinedValue3 = combinedValue3 << (14) | values->pipingTemperature;
-      combinedValue3 = combinedValue3 << (3) | msgIndex & 7; //first part of the message bits
+      uint32_t combinedValue3 = values.cold.nozzleTemperature;
+      combinedValue3 = combinedValue3 << (14) | values.cold.pipingTemperature;
+      combinedValue3 = combinedValue3 << (3) | (msgIndex & 7); //first part of the message bits
 
       //Add combinedValue3 to byteBuffer
-      byteBuffer[12] = combinedValue3 >> 24 & 255;
-      byteBuffer[13] = combinedValue3 >> 16 & 255;
-      byteBuffer[14] = combinedValue3 >> 8 & 255;
+      byteBuffer[12] = (combinedValue3 >> 24) & 255;
+      byteBuffer[13] = (combinedValue3 >> 16) & 255;
+      byteBuffer[14] = (combinedValue3 >> 8) & 255;
       byteBuffer[15] = combinedValue3 & 255;
 
       //Fourth 32bit data - sent at most every 100ms
-      uint32_t combinedValue4 = values->bottleTemperature;
-      combinedValue4 = combinedValue4 << (3) | (msgIndex >> 3) & 7; //second part of the message bits
-      combinedValue4 = combinedValue4 << (10) | values->IR; //For unkown reasons this didn't work with having IR as the first value
+      uint32_t combinedValue4 = values.cold.bottleTemperature;
+      combinedValue4 = combinedValue4 << (3) | ((msgIndex >> 3) & 7); //second part of the message bits
+      combinedValue4 = combinedValue4 << (10) | values.cold.IR; //For unkown reasons this didn't work with having IR as the first value
     
       //Add combinedValue3 to byteBuffer
-      byteBuffer[16] = combinedValue4 >> 24 & 255;
-      byteBuffer[17] = combinedValue4 >> 16 & 255;
-      byteBuffer[18] = combinedValue4 >> 8 & 255;
+      byteBuffer[16] = (combinedValue4 >> 24) & 255;
+      byteBuffer[17] = (combinedValue4 >> 16) & 255;
+      byteBuffer[18] = (combinedValue4 >> 8) & 255;
       byteBuffer[19] = combinedValue4 & 255;
 
-      values->slowUpdated = false;
     }
-    
-    values->mediumUpdated = false;
   }
   //uint32_t newMicros = micros();
   //Serial.println(newMicros - lastMicros);
   //lastMicros = newMicros;
 
   sendByteArray(byteBuffer, bufferLength);
+
+  BENCH_EXIT(BENCH_WRITE_VALUES);
 }
 
-void saveMessage(uint16_t messageIndex){
-  msgBuffer.push(&messageIndex);
+void writeAuxFrame(uint8_t frameId, uint8_t* payload, uint8_t length){
+  uint8_t auxBuffer[19];
+  uint8_t frameLength = length + 1;
+
+  //Lengths of the data lines can't be used, the Rock would parse the frame as data
+  if (frameLength > 19 || frameLength == 3 || frameLength == 12){
+    return;
+  }
+
+  auxBuffer[0] = frameId;
+  for (uint8_t i = 0; i < length; i++){
+    auxBuffer[i + 1] = payload[i];
+  }
+
+  sendByteArray(auxBuffer, frameLength);
 }
 
-void switchBaudrate(uint16_t newBaudrate){
-  //Send a message notifying the receiver of the switch
-  
-  //while (Serial.availableForWrite() < 63){
-  //  Serial.flush();
-  //}
-  /*
-  uint8_t emptyArray[0];
+void writePulseEdges(pulseEdges_t* edges){
+  uint8_t payload[pulseFrameLength - 1];
+
+  payload[0] = edges->channel;
+  payload[1] = edges->flags;
+
+  payload[2] = (edges->riseMicros >> 24) & 255;
+  payload[3] = (edges->riseMicros >> 16) & 255;
+  payload[4] = (edges->riseMicros >> 8) & 255;
+  payload[5] = edges->riseMicros & 255;
+
+  payload[6] = (edges->fallMicros >> 24) & 255;
+  payload[7] = (edges->fallMicros >> 16) & 255;
+  payload[8] = (edges->fallMicros >> 8) & 255;
+  payload[9] = edges->fallMicros & 255;
+
+  writeAuxFrame(AUX_FRAME_PULSE, payload, pulseFrameLength - 1);
+}
 
-  sendByteArray(emptyArray, 0);
-  delay(20);
+void writeProfile(profileStats_t* stats){
+  uint8_t payload[profileFrameLength - 1];
 
-  Serial.end();
+  payload[0] = stats->phase;
+  payload[1] = (stats->count >> 8) & 255;
+  payload[2] = stats->count & 255;
+  payload[3] = (stats->minTicks >> 8) & 255;
+  payload[4] = stats->minTicks & 255;
+  payload[5] = (stats->maxTicks >> 8) & 255;
+  payload[6] = stats->maxTicks & 255;
+  payload[7] = (stats->meanTicks >> 8) & 255;
+  payload[8] = stats->meanTicks & 255;
+
+  for (uint8_t i = 0; i < profileHistogramBins; i++){
+    payload[9 + i] = stats->histogram[i];
+  }
+
+  writeAuxFrame(AUX_FRAME_PROFILE, payload, profileFrameLength - 1);
+}
+
+void writeSampleTiming(sampleTiming_t* timing){
+  uint8_t payload[timingFrameLength - 1];
+
+  payload[0] = timing->mode;
+  payload[1] = (timing->samples >> 24) & 255;
+  payload[2] = (timing->samples >> 16) & 255;
+  payload[3] = (timing->samples >> 8) & 255;
+  payload[4] = timing->samples & 255;
+  payload[5] = (timing->misses >> 8) & 255;
+  payload[6] = timing->misses & 255;
+  payload[7] = (timing->maxLateness >> 8) & 255;
+  payload[8] = timing->maxLateness & 255;
+
+  for (uint8_t i = 0; i < timingHistogramBins; i++){
+    payload[9 + i] = timing->histogram[i];
+  }
+
+  writeAuxFrame(AUX_FRAME_TIMING, payload, timingFrameLength - 1);
+}
+
+void writeExecutive(executiveStats_t* stats){
+  uint8_t payload[executiveFrameLength - 1];
+
+  payload[0] = stats->mode;
+  payload[1] = (stats->frameOverruns >> 8) & 255;
+  payload[2] = stats->frameOverruns & 255;
+
+  for (uint8_t i = 0; i < taskCount; i++){
+    payload[3 + 2*i] = (stats->taskOverruns[i] >> 8) & 255;
+    payload[4 + 2*i] = stats->taskOverruns[i] & 255;
+  }
+
+  writeAuxFrame(AUX_FRAME_EXECUTIVE, payload, executiveFrameLength - 1);
+
+  uint8_t times[taskTimesFrameLength - 1];
+
+  times[0] = stats->mode;
+  for (uint8_t i = 0; i < taskCount; i++){
+    times[1 + 2*i] = (stats->maxTaskTicks[i] >> 8) & 255;
+    times[2 + 2*i] = stats->maxTaskTicks[i] & 255;
+  }
+
+  writeAuxFrame(AUX_FRAME_TASK_TIMES, times, taskTimesFrameLength - 1);
+}
+
+void writeBoot(bootReport_t* report){
+  uint8_t payload[bootFrameLength - 1];
+
+  payload[0] = report->resetFlags;
+  payload[1] = report->warmStart;
+  payload[2] = report->restoredMode;
+  payload[3] = (report->warmRestarts >> 8) & 255;
+  payload[4] = report->warmRestarts & 255;
+  payload[5] = report->stallPhase;
+  payload[6] = (report->watchdogStalls >> 8) & 255;
+  payload[7] = report->watchdogStalls & 255;
+
+  writeAuxFrame(AUX_FRAME_BOOT, payload, bootFrameLength - 1);
+}
+
+void writeConfigChunk(configChunk_t* chunk){
+  uint8_t payload[configFrameLength - 1];
+
+  payload[0] = chunk->index;
+  payload[1] = chunk->source;
+
+  for (uint8_t i = 0; i < configChunkBytes; i++){
+    payload[2 + i] = chunk->bytes[i];
+  }
+
+  writeAuxFrame(AUX_FRAME_CONFIG, payload, configFrameLength - 1);
+}
+
+void writeAck(ack_t* ack){
+  uint8_t payload[ackFrameLength - 1];
+
+  payload[0] = ack->sequence;
+  payload[1] = ack->id;
+  payload[2] = ack->status;
+  payload[3] = (ack->badFrames >> 8) & 255;
+  payload[4] = ack->badFrames & 255;
+
+  writeAuxFrame(AUX_FRAME_ACK, payload, ackFrameLength - 1);
+}
+
+void writeStatistics(statisticsReport_t* report){
+  uint8_t payload[statisticsFrameLength - 1];
+  uint16_t fields[5] = {report->samples, report->min, report->max, report->mean, report->deviation};
+
+  payload[0] = report->channel;
+  payload[1] = report->mode;
+
+  for (uint8_t i = 0; i < 5; i++){
+    payload[2 + 2*i] = (fields[i] >> 8) & 255;
+    payload[3 + 2*i] = fields[i] & 255;
+  }
+
+  writeAuxFrame(AUX_FRAME_STATISTICS, payload, statisticsFrameLength - 1);
+}
+
+void writeBurn(burnSummary_t* summary){
+  uint8_t payload[burnFrameLength - 1];
+  uint16_t fields[5] = {(uint16_t) summary->peakThrust, (uint16_t) summary->averageThrust,
+                        (uint16_t) summary->peakPressure, summary->riseTime, summary->burnDuration};
+
+  payload[0] = summary->flags;
+  payload[1] = (summary->totalImpulse >> 24) & 255;
+  payload[2] = (summary->totalImpulse >> 16) & 255;
+  payload[3] = (summary->totalImpulse >> 8) & 255;
+  payload[4] = summary->totalImpulse & 255;
+
+  for (uint8_t i = 0; i < 5; i++){
+    payload[5 + 2*i] = (fields[i] >> 8) & 255;
+    payload[6 + 2*i] = fields[i] & 255;
+  }
+
+  writeAuxFrame(AUX_FRAME_BURN, payload, burnFrameLength - 1);
+}
+
+void writeBurnEvent(burnEvent_t* event){
+  uint8_t payload[burnEventFrameLength - 1];
+  uint32_t times[2] = {(uint32_t) event->sinceIgniter, (uint32_t) event->sinceValve};
+
+  payload[0] = event->type;
+  payload[1] = event->channel;
+
+  for (uint8_t i = 0; i < 2; i++){
+    payload[2 + 4*i] = (times[i] >> 24) & 255;
+    payload[3 + 4*i] = (times[i] >> 16) & 255;
+    payload[4 + 4*i] = (times[i] >> 8) & 255;
+    payload[5 + 4*i] = times[i] & 255;
+  }
+
+  writeAuxFrame(AUX_FRAME_BURN_EVENT, payload, burnEventFrameLength - 1);
+}
+
+void saveMessage(uint16_t messageIndex){
+  msgBuffer.push(&messageIndex);
+}
+
+void switchBaudrate(uint32_t newBaudrate){
+  //The receiver of the frames switches after the acknowledgement sent at the old rate
   Serial.flush();
   Serial.begin(newBaudrate);
-
-  Serial.write(START_MARKER);
-  Serial.write(0x11);
-  Serial.write(END_MARKER);
-  */
-}
\ No newline at end of file
+}
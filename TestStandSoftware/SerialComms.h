@@ -24,11 +24,109 @@ void initSerial(void);
 /* Function:      Sends the latest measurements and the status values of the 
  *                system using the Arduino Serial interface.
  *
- * IN:            Pointer to a values_t struct with the latest sensor measurements,
- *                statusValues_t struct with information about the status of the SW
+ * IN:            Reference to a values_t struct with the latest sensor measurements,
+ *                Reference to a statusValues_t struct with information about the status of the SW
  * OUT:           Nothing
  */
-void writeValues(values_t* values, statusValues_t statusValues);
+void writeValues(const values_t& values, const statusValues_t& statusValues);
+
+
+/* Function:      Sends an auxiliary frame between the data lines. The frame
+ *                starts with the frame ID, see auxFrameId_t in Globals.h.
+ *                Frames of a data line length or over 19 bytes are dropped.
+ *
+ * IN:            uint8_t frame ID,
+ *                Pointer to the payload bytes,
+ *                Length of the payload
+ * OUT:           Nothing
+ */
+void writeAuxFrame(uint8_t frameId, uint8_t* payload, uint8_t length);
+
+
+/* Function:      Sends the edge times of an igniter or camera pulse
+ *                as an AUX_FRAME_PULSE frame.
+ *
+ * IN:            Pointer to a pulseEdges_t struct with the edge times
+ * OUT:           Nothing
+ */
+void writePulseEdges(pulseEdges_t* edges);
+
+
+/* Function:      Sends the statistics of a loop phase as an AUX_FRAME_PROFILE frame.
+ *
+ * IN:            Pointer to a profileStats_t struct with the statistics
+ * OUT:           Nothing
+ */
+void writeProfile(profileStats_t* stats);
+
+
+/* Function:      Sends the sample timing statistics of a mode as an
+ *                AUX_FRAME_TIMING frame.
+ *
+ * IN:            Pointer to a sampleTiming_t struct with the statistics
+ * OUT:           Nothing
+ */
+void writeSampleTiming(sampleTiming_t* timing);
+
+
+/* Function:      Sends the overrun counts of the cyclic executive as an
+ *                AUX_FRAME_EXECUTIVE frame and the longest task runs of the
+ *                mode as an AUX_FRAME_TASK_TIMES frame.
+ *
+ * IN:            Pointer to an executiveStats_t struct with the stats
+ * OUT:           Nothing
+ */
+void writeExecutive(executiveStats_t* stats);
+
+
+/* Function:      Sends the boot report as an AUX_FRAME_BOOT frame.
+ *
+ * IN:            Pointer to a bootReport_t struct with the report
+ * OUT:           Nothing
+ */
+void writeBoot(bootReport_t* report);
+
+
+/* Function:      Sends one chunk of the config block as an AUX_FRAME_CONFIG frame.
+ *
+ * IN:            Pointer to a configChunk_t struct with the chunk
+ * OUT:           Nothing
+ */
+void writeConfigChunk(configChunk_t* chunk);
+
+
+/* Function:      Write the acknowledgement of a command from the Rock
+ *                as an AUX_FRAME_ACK frame.
+ *
+ * IN:            Pointer to the ack_t
+ * OUT:           Nothing
+ */
+void writeAck(ack_t* ack);
+
+
+/* Function:      Send the statistics of a channel over a reporting interval
+ *                in an AUX_FRAME_STATISTICS frame.
+ *
+ * IN:            Pointer to the statisticsReport_t struct
+ * OUT:           Nothing
+ */
+void writeStatistics(statisticsReport_t* report);
+
+
+/* Function:      Send the summary of a burn in an AUX_FRAME_BURN frame.
+ *
+ * IN:            Pointer to the burnSummary_t struct
+ * OUT:           Nothing
+ */
+void writeBurn(burnSummary_t* summary);
+
+
+/* Function:      Send an event of the burn in an AUX_FRAME_BURN_EVENT frame.
+ *
+ * IN:            Pointer to the burnEvent_t struct
+ * OUT:           Nothing
+ */
+void writeBurnEvent(burnEvent_t* event);
 
 
 /* WriteMessage and WriteIntMessage are removed for now to test the 
@@ -76,11 +174,22 @@ void saveMessage(uint16_t message);
 void sendByteArray(uint8_t *data, uint8_t length);
 
 
-/* Function:      For switching the BAUD rate on the fly.
+/* Function:      Tell if frames of the given length fit in the transmit buffer
+ *                of the UART, so writing them doesn't wait for the line.
+ *                Escaped bytes are rare and not counted.
+ *
+ * IN:            uint8_t total length of the frames
+ * OUT:           Boolean
+ */
+bool serialHasRoom(uint8_t length);
+
+
+/* Function:      For switching the BAUD rate on the fly. Waits until the
+ *                bytes already written have been sent at the old rate.
  * 
  * IN:            The desired baudrate
  * OUT:           Nothing
  */
-void switchBaudrate(uint16_t newBaud);
+void switchBaudrate(uint32_t newBaud);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+/* Filename:      Statistics.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Streaming minimum, maximum, mean and variance of the pressure
+ *                and load cell channels over each reporting interval. Shows
+ *                what the channels did between the samples sent in the data
+ *                lines, for the bandwidth of one frame per channel.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Statistics.h"
+
+/* Accumulation explanation:
+ * The samples are accumulated as deviations from the first sample of the interval (shift):
+ * sum = sum of d, sumSquares = sum of d^2, where d = sample - shift.
+ * The deviations of 10-bit readings are at most maxADC, so both sums are exact integers
+ * and the variance sumSquares/n - (sum/n)^2 has no cancellation left. Like the update of
+ * Welford this is numerically stable, but without a division per sample: a sample costs
+ * two compares, a 16x16-bit multiply and two additions. The divisions and the square root
+ * are done once per channel and interval, when the statistics are sent.
+ */
+struct accumulator_t {
+  uint16_t samples;
+  uint16_t shift;
+  uint16_t min;
+  uint16_t max;
+  int32_t sum;
+  uint32_t sumSquares;
+};
+
+static accumulator_t running[statisticsChannelCount];
+static mode_t runningMode;
+
+//Last finished interval, sent a channel at a time
+static accumulator_t finished[statisticsChannelCount];
+static mode_t finishedMode;
+static uint8_t nextChannel;     //statisticsChannelCount when every channel has been sent
+
+static void clearAccumulator(accumulator_t* accumulator){
+  accumulator->samples = 0;
+  accumulator->sum = 0;
+  accumulator->sumSquares = 0;
+}
+
+static void addValue(accumulator_t* accumulator, uint16_t value){
+  if (accumulator->samples == 0){
+    accumulator->shift = value;
+    accumulator->min = value;
+    accumulator->max = value;
+  }else if (value < accumulator->min){
+    accumulator->min = value;
+  }else if (value > accumulator->max){
+    accumulator->max = value;
+  }
+
+  if (accumulator->samples < statisticsMaxSamples){
+    int16_t deviation = value - accumulator->shift;
+    accumulator->samples++;
+    accumulator->sum += deviation;
+    accumulator->sumSquares += (int32_t) deviation * deviation;
+  }
+}
+
+//A finished interval not sent completely yet is replaced, an interval without samples is dropped
+static void finishInterval(){
+  bool sampled = false;
+
+  for (uint8_t i = 0; i < statisticsChannelCount; i++){
+    sampled |= running[i].samples > 0;
+  }
+  if (!sampled){
+    return;
+  }
+
+  for (uint8_t i = 0; i < statisticsChannelCount; i++){
+    finished[i] = running[i];
+    clearAccumulator(&running[i]);
+  }
+  finishedMode = runningMode;
+  nextChannel = 0;
+}
+
+//Integer square root, rounded down
+static uint16_t squareRoot(uint32_t value){
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > value){
+    bit >>= 2;
+  }
+  while (bit != 0){
+    if (value >= root + bit){
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }else{
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+
+void initStatistics(){
+  for (uint8_t i = 0; i < statisticsChannelCount; i++){
+    clearAccumulator(&running[i]);
+  }
+  runningMode = INIT;
+  nextChannel = statisticsChannelCount;
+}
+
+void addStatisticsSample(const values_t& values, mode_t currentMode){
+  if (currentMode != runningMode){
+    finishInterval();
+    runningMode = currentMode;
+  }
+
+  for (uint8_t i = 0; i < statisticsChannelCount; i++){
+    if (channelUpdated(values, (sensorChannel_t) i)){
+      addValue(&running[i], channelValue(values, (sensorChannel_t) i));
+    }
+  }
+
+  if (values.cold.slowUpdated){
+    finishInterval();
+  }
+}
+
+bool getStatisticsReport(statisticsReport_t* report){
+  while (nextChannel < statisticsChannelCount){
+    const accumulator_t* accumulator = &finished[nextChannel];
+    report->channel = nextChannel++;
+
+    if (accumulator->samples == 0){
+      continue;
+    }
+
+    uint16_t samples = accumulator->samples;
+    report->mode = finishedMode;
+    report->samples = samples;
+    report->min = accumulator->min;
+    report->max = accumulator->max;
+
+    //Mean of the deviations and the mean of their squares in 1/statisticsFraction counts.
+    //The remainder keeps the fraction of the squares without overflowing 32 bits
+    int32_t meanDeviation = accumulator->sum * statisticsFraction / samples;
+    uint32_t meanSquare = accumulator->sumSquares / samples * (statisticsFraction * statisticsFraction)
+                        + accumulator->sumSquares % samples * (statisticsFraction * statisticsFraction) / samples;
+    uint32_t squaredMean = meanDeviation * meanDeviation;
+
+    report->mean = accumulator->shift * statisticsFraction + meanDeviation;
+    report->deviation = squareRoot(meanSquare > squaredMean ? meanSquare - squaredMean : 0);
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,46 @@
+/* Filename:      Statistics.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Statistics <<passive>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+/* Function:      Initialize the Statistics object
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initStatistics(void);
+
+
+/* Function:      Add a sample to the statistics of the current interval. Only
+ *                the channels that were sampled are added. The interval ends
+ *                after a slow sample or when the mode changes. Constant time,
+ *                integer only.
+ *
+ * IN:            Reference to a values_t struct with the sample,
+ *                mode_t current mode
+ * OUT:           Nothing
+ */
+void addStatisticsSample(const values_t& values, mode_t currentMode);
+
+
+/* Function:      Get the statistics of the next channel of the last finished
+ *                interval, one channel per call. Channels without samples are
+ *                skipped.
+ *
+ * IN:            Pointer to a statisticsReport_t struct for the statistics
+ * OUT:           true if the statistics were fetched
+ */
+bool getStatisticsReport(statisticsReport_t* report);
+
+#endif
@@ -0,0 +1,109 @@
+/* Filename:      Tare.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Zeroes the pressure sensors and the load cell on the device.
+ *                Averages the readings of the normal sampling in WAIT and
+ *                stores the zero offsets in the config block, replacing the
+ *                hand entered offsets of the calibration.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Tare.h"
+#include "Config.h"
+
+/* Tare explanation:
+ * The offset of a channel is the averaged reading minus the reading its calibration line
+ * gives for zero, in 1/tareFraction ADC counts. The offsets are folded into the calibration
+ * lines by the Config object, see getCalibration(), so nothing is added to the sampling.
+ * An offset over pressureTareLimit or loadTareLimit fails the whole tare: the line is
+ * pressurized or the engine loaded, and a zero taken there would raise the redlines.
+ */
+
+static tareState_t state;
+static uint8_t samples;
+static uint16_t sums[tareChannelCount];
+
+//Reading of the untared line for a zero value, in 1/tareFraction ADC counts
+static float zeroReading(calibrationLine_t line, float adcCalibration){
+  return -line.B / line.K / (adcCalibration * refADC) * maxADC * tareFraction;
+}
+
+//Offsets of the collected samples, false if one is over its limit
+static bool computeOffsets(int16_t* offsets){
+  const config_t* config = getConfig();
+
+  for (uint8_t i = 0; i < tareChannelCount; i++){
+    calibrationLine_t line = (i == TARE_LOAD_CELL) ? config->load : config->pressure[i];
+    float limit = (i == TARE_LOAD_CELL) ? loadTareLimit : pressureTareLimit;
+
+    float average = (float) sums[i] * tareFraction / tareSamples;
+    float offset = average - zeroReading(line, config->calibrationADC);
+    float maxOffset = limit / line.K / (config->calibrationADC * refADC) * maxADC * tareFraction;
+
+    if (offset > maxOffset || offset < -maxOffset){
+      return false;
+    }
+    offsets[i] = (int16_t) (offset < 0 ? offset - 0.5f : offset + 0.5f);
+  }
+
+  return true;
+}
+
+void initTare(){
+  state = TARE_IDLE;
+  samples = 0;
+}
+
+ackStatus_t startTare(mode_t currentMode){
+  if (currentMode != WAIT){
+    return ACK_REJECTED;
+  }
+  if (state == TARE_SAMPLING || isConfigStoring()){
+    return ACK_BUSY;
+  }
+
+  for (uint8_t i = 0; i < tareChannelCount; i++){
+    sums[i] = 0;
+  }
+  samples = 0;
+  state = TARE_SAMPLING;
+
+  return ACK_OK;
+}
+
+tareState_t addTareSample(const values_t& values, mode_t currentMode){
+  if (state != TARE_SAMPLING){
+    return TARE_IDLE;
+  }
+  if (currentMode != WAIT){
+    state = TARE_IDLE;
+    return TARE_ABORTED;
+  }
+  //Outside SEQUENCE the medium sensors are read with every sample
+  if (!values.cold.mediumUpdated){
+    return TARE_SAMPLING;
+  }
+
+  sums[FEEDING_PRESSURE_OXIDIZER] += values.cold.N2OFeedingPressure;
+  sums[LINE_PRESSURE] += values.cold.linePressure;
+  sums[CHAMBER_PRESSURE] += values.hot.combustionPressure;
+  sums[FEEDING_PRESSURE_N2] += values.cold.N2FeedingPressure;
+  sums[TARE_LOAD_CELL] += values.hot.loadCell;
+
+  if (++samples < tareSamples){
+    return TARE_SAMPLING;
+  }
+
+  int16_t offsets[tareChannelCount];
+  state = TARE_IDLE;
+
+  if (!computeOffsets(offsets) || !setTare(offsets)){
+    return TARE_FAILED;
+  }
+  return TARE_DONE;
+}
@@ -0,0 +1,47 @@
+/* Filename:      Tare.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Tare <<passive>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef TARE_H
+#define TARE_H
+
+/* Function:      Initialize the Tare object
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initTare(void);
+
+
+/* Function:      Start a tare of the pressure sensors and the load cell. The
+ *                samples are collected by addTareSample().
+ *
+ * IN:            mode_t current mode
+ * OUT:           ackStatus_t, ACK_REJECTED outside WAIT, ACK_BUSY while a tare
+ *                is running or a config block is being stored
+ */
+ackStatus_t startTare(mode_t currentMode);
+
+
+/* Function:      Add the latest sample to a running tare. When tareSamples
+ *                samples are collected, the zero offsets are checked against
+ *                their limits and taken into use in the Config object.
+ *                Leaving WAIT aborts the tare.
+ *
+ * IN:            Reference to a values_t struct with the latest measurements,
+ *                mode_t current mode
+ * OUT:           tareState_t, TARE_DONE, TARE_FAILED and TARE_ABORTED are
+ *                returned once when the tare ends
+ */
+tareState_t addTareSample(const values_t& values, mode_t currentMode);
+
+#endif
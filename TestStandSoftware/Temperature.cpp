@@ -7,7 +7,7 @@
  *                test bench.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 
 #include "Temperature.h"
 #include "Globals.h"
@@ -34,7 +34,12 @@ static Adafruit_MAX31855 thermocouple3(tempChipSelectPins[3]);
 
 static Adafruit_MAX31855 thermocouples[tempCount] = {thermocouple0, thermocouple1, thermocouple2, thermocouple3};
 
+//MAX31855 fault bit of each thermocouple from the latest read, bit = sensor number
+static uint8_t temperatureFaults = 0;
+
 void initTemp(){
+  temperatureFaults = 0;
+
   for (uint16_t i = 0; i<tempCount; i++){
     thermocouples[i].begin();
     pinMode(tempChipSelectPins[i], OUTPUT);
@@ -62,6 +67,13 @@ int readTemp(uint16_t sensorNum){
    }
     */
 
+  // Bit 16 is set if any of the fault bits (open, short to GND, short to VCC) is set
+  if (temperature & 0x00010000) {
+    temperatureFaults |= (1 << sensorNum);
+  } else {
+    temperatureFaults &= ~(1 << sensorNum);
+  }
+
   if (temperature & 0x80000000) {
     // Negative value, drop the lower 18 bits and explicitly extend sign bits.
     temperature = 0xFFFFC000 | ((temperature >> 18) & 0x00003FFF);
@@ -79,6 +91,11 @@ int readTemp(uint16_t sensorNum){
 }
 
 
+uint8_t readTempFaults(){
+  return temperatureFaults;
+}
+
+
 int readTMP36(){
   // In V1.51 testing out different ref voltage
   //analogReference(INTERNAL2V56);
@@ -26,6 +26,14 @@ void initTemp(void);
 int readTemp(uint16_t senorNum);
 
 
+/* Function:      Get the fault bits of the thermocouples from their latest reads.
+ *
+ * IN:            Nothing
+ * OUT:           Bitmask with a bit set for each thermocouple reporting a fault
+ */
+uint8_t readTempFaults(void);
+
+
 /* Function:      Read the TMP36 temperature sensors and return the measurements.
  *
  * IN:            Nothing
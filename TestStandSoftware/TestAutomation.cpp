@@ -17,8 +17,21 @@
 #include "SerialComms.h"
 #include "TestAutomation.h"
 #include "TestInOut.h"
+#include "DigitalInputs.h"
 #include "Buzzer.h"
 #include "FaultDetection.h"
+#include "SensorHealth.h"
+#include "Pulse.h"
+#include "Profiler.h"
+#include "Executive.h"
+#include "Retained.h"
+#include "Config.h"
+#include "Uplink.h"
+#include "Tare.h"
+#include "Statistics.h"
+#include "Burn.h"
+#include "BurnEvents.h"
+#include "Timebase.h"
 
 void initTestAutomation(){
   //Nothing to initialize currently
@@ -44,16 +57,162 @@ void forwardGetLatestValues(values_t* values, mode_t currentMode){
   getValuesFromSensors(values, currentMode);
 }
 
-void sendValuesToSerial(values_t* values, statusValues_t statusValues){
+void sendValuesToSerial(const values_t& values, const statusValues_t& statusValues){
   writeValues(values, statusValues);
 }
 
+void sendPulseEdgesToSerial(){
+  pulseEdges_t edges;
+
+  for (uint8_t i = 0; i < pulseChannelCount; i++){
+    if (getPulseEdges((pulseChannel_t) i, &edges)){
+      writePulseEdges(&edges);
+    }
+  }
+}
+
+void sendSampleTimingToSerial(){
+  sampleTiming_t timing;
+
+  //Held back to a later frame while the UART is busy, the statistics are kept until fetched
+  if (serialHasRoom(timingFrameLength + 1) && getTimingFromSensors(&timing)){
+    writeSampleTiming(&timing);
+  }
+}
+
+void sendExecutiveToSerial(){
+  executiveStats_t stats;
+
+  //Both frames with their end markers
+  if (serialHasRoom(executiveFrameLength + taskTimesFrameLength + 2) && getExecutiveStats(&stats)){
+    writeExecutive(&stats);
+  }
+}
+
+void sendBootToSerial(mode_t currentMode){
+  bootReport_t report;
+
+  if (getBootReport(&report, currentMode)){
+    writeBoot(&report);
+  }
+}
+
+void sendConfigToSerial(mode_t currentMode){
+  configChunk_t chunk;
+
+  if (getConfigChunk(&chunk, currentMode)){
+    writeConfigChunk(&chunk);
+  }
+}
+
+bool forwardGetCommand(command_t* command, mode_t currentMode){
+  return getCommand(command, currentMode);
+}
+
+void sendAckToSerial(const command_t& command, ackStatus_t status){
+  ack_t ack;
+
+  ack.sequence = command.sequence;
+  ack.id = command.id;
+  ack.status = status;
+  ack.badFrames = getBadFrames();
+  writeAck(&ack);
+}
+
+void requestConfigFrames(){
+  requestConfig();
+}
+
+ackStatus_t forwardConfigChunk(uint8_t index, const uint8_t* bytes){
+  return receiveConfigChunk(index, bytes);
+}
+
+ackStatus_t forwardConfigStore(){
+  return storeReceivedConfig();
+}
+
+void continueConfigWrite(){
+  continueConfigStore();
+}
+
+ackStatus_t forwardStartTare(mode_t currentMode){
+  return startTare(currentMode);
+}
+
+tareState_t forwardTareSample(const values_t& values, mode_t currentMode){
+  tareState_t state = addTareSample(values, currentMode);
+
+  if (state == TARE_DONE){
+    updateFaultLimits();
+  }
+  return state;
+}
+
+void forwardStatisticsSample(const values_t& values, mode_t currentMode){
+  addStatisticsSample(values, currentMode);
+}
+
+void sampleStatisticsChannels(mode_t currentMode){
+  values_t sample;
+
+  getAnalogFromSensors(&sample);
+  addStatisticsSample(sample, currentMode);
+}
+
+void sendStatisticsToSerial(){
+  statisticsReport_t report;
+
+  if (getStatisticsReport(&report)){
+    writeStatistics(&report);
+  }
+}
+
+void forwardBurnSample(const values_t& values, mode_t currentMode, substate_t currentSubstate){
+  bool loadHealthy = !(getUnhealthyChannels() & (1 << CH_LOAD_CELL));
+  addBurnSample(values, loadHealthy, currentMode, currentSubstate);
+  addBurnEventSample(values, currentMode);
+}
+
+void forwardBurnCommand(burnCommand_t command){
+  addBurnCommand(command, timebaseTicks());
+}
+
+void sendBurnToSerial(mode_t currentMode){
+  burnSummary_t summary;
+
+  if (getBurnSummary(&summary, currentMode)){
+    writeBurn(&summary);
+  }
+}
+
+void sendBurnEventsToSerial(){
+  burnEvent_t event;
+
+  if (getBurnEvent(&event)){
+    writeBurnEvent(&event);
+  }
+}
+
+bool setNewSensorRates(uint16_t mediumRate, uint16_t slowRate){
+  return setRatesOfSensors(mediumRate, slowRate);
+}
+
+#ifdef PROFILE_BUILD
+void sendProfileToSerial(){
+  profileStats_t stats;
+
+  if (getProfile(&stats)){
+    writeProfile(&stats);
+  }
+}
+#endif
+
 void sendMessageToSerial(uint16_t messageIndex){
   saveMessage(messageIndex);
   //writeMessage(message);
 }
 
-void setNewBaudRate(uint16_t newBaudrate){
+void setNewBaudRate(uint32_t newBaudrate){
   switchBaudrate(newBaudrate);
 }
 
@@ -63,6 +222,10 @@ void sendIntMessageToSerial(int16_t integer){
 }
 */
 
+void latchInputs(){
+  latchDigitalInputs();
+}
+
 void getTestInput(testInput_t* testInput, bool readAll){
   readTestInput(testInput, readAll);
 }
@@ -79,12 +242,16 @@ void setNewRepeatIndicator(bool newState){
   setRepeatIndicator(newState);
 }
 
-void callBuzzerUpdate(){
-  updateBuzzer();
+void setNewTestModeIndicator(bool newState){
+  setTestModeIndicator(newState);
+}
+
+void setNewBuzzerPattern(buzzerPattern_t newPattern){
+  startBuzzerPattern(newPattern);
 }
 
 
-void sendToCheck(values_t values){
+void sendToCheck(const values_t& values){
   checkData(values);
 }
 
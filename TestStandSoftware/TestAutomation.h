@@ -73,11 +73,237 @@ void forwardGetLatestValues(values_t* values, mode_t currentMode);
  *                current state of the SW to the SerialComms object.
  *                Uses the writeValues() interface.
  *    
- * IN:            Pointer to a values_t struct with the latest sensor measurements
- *                statusValues_t struct with information about the status of the SW
+ * IN:            Reference to a values_t struct with the latest sensor measurements
+ *                Reference to a statusValues_t struct with information about the status of the SW
  * OUT:           Nothing      
  */
-void sendValuesToSerial(values_t* values, statusValues_t statusValues);
+void sendValuesToSerial(const values_t& values, const statusValues_t& statusValues);
+
+
+/* Function:      Intermediate interface for sending the new edge times of
+ *                the igniter and camera pulses to the SerialComms object.
+ *                Uses the getPulseEdges() and writePulseEdges() interfaces.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void sendPulseEdgesToSerial(void);
+
+
+/* Function:      Intermediate interface for sending the sample timing statistics
+ *                of the Sensing object to the SerialComms object.
+ *                Uses the getTimingFromSensors() and writeSampleTiming() interfaces.
+ *                Waits for a later call while the UART transmit buffer is full.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void sendSampleTimingToSerial(void);
+
+
+/* Function:      Intermediate interface for sending the overrun counts and the
+ *                task run times of the Executive object to the SerialComms object.
+ *                Uses the getExecutiveStats() and writeExecutive() interfaces.
+ *                Waits for a later call while the UART transmit buffer is full.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void sendExecutiveToSerial(void);
+
+
+/* Function:      Intermediate interface for sending the boot report of the
+ *                Retained object to the SerialComms object once after a reset.
+ *                Uses the getBootReport() and writeBoot() interfaces.
+ *
+ * IN:            mode_t current mode
+ * OUT:           Nothing
+ */
+void sendBootToSerial(mode_t currentMode);
+
+
+/* Function:      Intermediate interface for sending the config block of the
+ *                Config object to the SerialComms object, one chunk per call.
+ *                Uses the getConfigChunk() and writeConfigChunk() interfaces.
+ *
+ * IN:            mode_t current mode
+ * OUT:           Nothing
+ */
+void sendConfigToSerial(mode_t currentMode);
+
+
+/* Function:      Intermediate interface for getting a command of the Rock from
+ *                the Uplink object. Uses the getCommand() interface.
+ *
+ * IN:            command_t pointer where a received command will be stored,
+ *                mode_t current mode
+ * OUT:           Boolean telling if a command was received
+ */
+bool forwardGetCommand(command_t* command, mode_t currentMode);
+
+
+/* Function:      Intermediate interface for sending the acknowledgement of a
+ *                command to the SerialComms object.
+ *                Uses the getBadFrames() and writeAck() interfaces.
+ *
+ * IN:            Reference to the command_t,
+ *                ackStatus_t of the command
+ * OUT:           Nothing
+ */
+void sendAckToSerial(const command_t& command, ackStatus_t status);
+
+
+/* Function:      Intermediate interface for restarting the sending of the
+ *                config block. Uses the requestConfig() interface.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void requestConfigFrames(void);
+
+
+/* Function:      Intermediate interface for passing a chunk of a new config
+ *                block to the Config object.
+ *                Uses the receiveConfigChunk() interface.
+ *
+ * IN:            uint8_t index of the chunk,
+ *                Pointer to the configChunkBytes bytes of the chunk
+ * OUT:           ackStatus_t of the chunk
+ */
+ackStatus_t forwardConfigChunk(uint8_t index, const uint8_t* bytes);
+
+
+/* Function:      Intermediate interface for storing the received config block
+ *                to the EEPROM. Uses the storeReceivedConfig() interface.
+ *
+ * IN:            Nothing
+ * OUT:           ackStatus_t of the store
+ */
+ackStatus_t forwardConfigStore(void);
+
+
+/* Function:      Intermediate interface for writing the next byte of a config
+ *                block being stored. Uses the continueConfigStore() interface.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void continueConfigWrite(void);
+
+
+/* Function:      Intermediate interface for starting a tare in the Tare object.
+ *                Uses the startTare() interface.
+ *
+ * IN:            mode_t current mode
+ * OUT:           ackStatus_t of the start
+ */
+ackStatus_t forwardStartTare(mode_t currentMode);
+
+
+/* Function:      Intermediate interface for passing the latest sample to a
+ *                running tare. Uses the addTareSample() interface. Once the
+ *                tare is done, the limits of the FaultDetection object are
+ *                converted again with the updateFaultLimits() interface.
+ *
+ * IN:            Reference to a values_t struct with the latest measurements,
+ *                mode_t current mode
+ * OUT:           tareState_t of the tare
+ */
+tareState_t forwardTareSample(const values_t& values, mode_t currentMode);
+
+
+/* Function:      Intermediate interface for adding the latest sample to the
+ *                channel statistics. Uses the addStatisticsSample() interface.
+ *
+ * IN:            Reference to a values_t struct with the latest measurements,
+ *                mode_t current mode
+ * OUT:           Nothing
+ */
+void forwardStatisticsSample(const values_t& values, mode_t currentMode);
+
+
+/* Function:      Intermediate interface for reading the analog channels
+ *                between the samples and adding them to the channel statistics.
+ *                Uses the getAnalogFromSensors() and addStatisticsSample() interfaces.
+ *
+ * IN:            mode_t current mode
+ * OUT:           Nothing
+ */
+void sampleStatisticsChannels(mode_t currentMode);
+
+
+/* Function:      Intermediate interface for sending the channel statistics of
+ *                the Statistics object to the SerialComms object, one channel per call.
+ *                Uses the getStatisticsReport() and writeStatistics() interfaces.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void sendStatisticsToSerial(void);
+
+
+/* Function:      Intermediate interface for adding the latest sample to the
+ *                burn metrics and the burn event detector. Uses the
+ *                addBurnSample(), addBurnEventSample() and
+ *                getUnhealthyChannels() interfaces.
+ *
+ * IN:            Reference to a values_t struct with the latest measurements,
+ *                mode_t current mode,
+ *                substate_t current substate
+ * OUT:           Nothing
+ */
+void forwardBurnSample(const values_t& values, mode_t currentMode, substate_t currentSubstate);
+
+
+/* Function:      Intermediate interface for timing the burn events from an
+ *                actuator command. Stamps the command with the Timer1 tick
+ *                and uses the addBurnCommand() interface. Called right after
+ *                the command is given.
+ *
+ * IN:            burnCommand_t command that was given
+ * OUT:           Nothing
+ */
+void forwardBurnCommand(burnCommand_t command);
+
+
+/* Function:      Intermediate interface for sending the summary of the last
+ *                burn of the Burn object to the SerialComms object.
+ *                Uses the getBurnSummary() and writeBurn() interfaces.
+ *
+ * IN:            mode_t current mode
+ * OUT:           Nothing
+ */
+void sendBurnToSerial(mode_t currentMode);
+
+
+/* Function:      Intermediate interface for sending the detected burn events
+ *                of the BurnEvents object to the SerialComms object, one event
+ *                per call. Uses the getBurnEvent() and writeBurnEvent() interfaces.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void sendBurnEventsToSerial(void);
+
+
+/* Function:      Intermediate interface for setting the rates of the slower
+ *                sensors. Uses the setRatesOfSensors() interface.
+ *
+ * IN:            uint16_t medium rate (Hz), uint16_t slow rate (Hz)
+ * OUT:           true if the rates were taken into use
+ */
+bool setNewSensorRates(uint16_t mediumRate, uint16_t slowRate);
+
+
+/* Function:      Intermediate interface for sending the loop phase statistics
+ *                of the Profiler object to the SerialComms object at a low rate.
+ *                Uses the getProfile() and writeProfile() interfaces.
+ *                Only exists in -DPROFILE_BUILD builds.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void sendProfileToSerial(void);
 
 
 /* Function:      Intermediate interface for sending text message to the 
@@ -98,6 +324,16 @@ void sendValuesToSerial(values_t* values, statusValues_t statusValues);
  void sendIntMessageToSerial(int16_t integer);
 
 
+/* Function:      Intermediate interface for latching the digital inputs of
+ *                this loop in the DigitalInputs object.
+ *                Uses the latchDigitalInputs() interface.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void latchInputs(void);
+
+
 /* Function:      Intermediate interface for getting the current readout of the
  *                test intput pins from the TestInOut object.
  *                Uses the readTestInput() interface.
@@ -137,13 +373,22 @@ void setNewBuzzerState(bool newState);
 void setNewRepeatIndicator(bool newState);
 
 
-/* Function:      Intermediate interface for calling the buzzer update function
- *                in the Buzzer object. Uses the updateBuzzer() interface.
+/* Function:      Intermediate interface for controlling the test mode LED
+ *                in the Mode object. Uses the setTestModeIndicator() interface.
  *
- * IN:            Nothing
+ * IN:            Boolean that the LED is set to. true -> ON, false -> OFF.
+ * OUT:           Nothing
+ */
+void setNewTestModeIndicator(bool newState);
+
+
+/* Function:      Intermediate interface for playing a buzzer pattern
+ *                in the Buzzer object. Uses the startBuzzerPattern() interface.
+ *
+ * IN:            buzzerPattern_t to be played, BUZZER_OFF stops the buzzer
  * OUT:           Nothing
  */
-void callBuzzerUpdate(void);
+void setNewBuzzerPattern(buzzerPattern_t newPattern);
 
 
 
@@ -159,18 +404,18 @@ void callBuzzerUpdate(void);
  *                FaultDetection object to be checked for limit violations.
  *                Uses the checkData() interface.
  *
- * IN:            values_t structure containing the newest measurements
+ * IN:            Reference to a values_t struct containing the newest measurements
  * OUT:           Nothing
  */
-void sendToCheck(values_t values);
+void sendToCheck(const values_t& values);
 
 
 /* Function:      Intermediate interface for switching the baudrate of 
- *                the Serial interface.
+ *                the Serial interface. Uses the switchBaudrate() interface.
  *
- * IN:            uint16_t to set the baudrate to
+ * IN:            uint32_t to set the baudrate to
  * OUT:           Nothing
  */
-void setNewBaudRate(uint16_t newBaudrate);
+void setNewBaudRate(uint32_t newBaudrate);
 
 #endif
\ No newline at end of file
@@ -7,11 +7,16 @@
  *                the software in test mode and test the various actuators.
  */
  
-#include <Arduino.h>
+#include "Hal.h"
 
 #include <stdint.h>
 #include "TestInOut.h"
 #include "Globals.h"
+#include "Gpio.h"
+#include "DigitalInputs.h"
+
+//IGN_GND test input, sampled with every sample in TEST mode
+static uint16_t ignitionGroundLevel;
 
 
 /*
@@ -42,28 +47,35 @@ void initTestInOut(){
   pinMode(MAIN_VALVE_TEST_PIN, INPUT);
 
   pinMode(IGN_GND_RELAY_TEST_DRIVE_PIN, OUTPUT);
-  
+
+  ignitionGroundLevel = 0;
 }
 
 void readTestInput(testInput_t* testInput, bool readAll){
 
-    testInput->MAIN_VALVE_VOLTAGE_IN = PINC & (1 << MAIN_VALVE_TEST_PIN_PORTC); //digitalRead(MAIN_VALVE_TEST_PIN);
-    testInput->IGN_VOLTAGE_IN = PINA & (1 << IGN_SW_RELAY_TEST_PIN_PORTA); //digitalRead(IGN_SW_RELAY_TEST_PIN);
+    testInput->MAIN_VALVE_VOLTAGE_IN = inputHigh(IN_MAIN_VALVE_TEST);
+    testInput->IGN_VOLTAGE_IN = inputHigh(IN_IGN_SW_RELAY_TEST);
 
   if (readAll == true){
     //Pullup pins have inverted input, Button pressed -> LOW, Not pressed -> HIGH
-    testInput->resetSW = !(PINC & (1 << SW_RESET_PIN_PORTC)); //digitalRead(SW_RESET_PIN);            //Inverted input
-    testInput->startTest = !(PINA & (1 << AUTO_TEST_START_PIN_PORTA)); //digitalRead(AUTO_TEST_START_PIN);   //Inverted input
-    testInput->repeat = !(PINC & (1 << REPEAT_SEQUENECE_PIN_PORTC)); //digitalRead(REPEAT_SEQUENECE_PIN);     //Inverted input
+    testInput->resetSW = !inputHigh(IN_SW_RESET);               //Inverted input
+    testInput->startTest = !inputHigh(IN_AUTO_TEST_START);      //Inverted input
+    testInput->repeat = !inputHigh(IN_REPEAT_SEQUENCE);         //Inverted input
 
-    //Analog to digital calibration is not included here due to the 
-    //error being way less than the margins for this specific value
-    testInput->IGN_GND_IN = analogRead(IGN_GND_RELAY_TEST_MEASURE_PIN);
+    testInput->IGN_GND_IN = ignitionGroundLevel;
   } 
 }
 
-//Allowing any pin to be changed by this instead of pins in a list is slightly sus
-//Either keep this and trust the process, go back to a list of pins for this or include a check.
+void sampleIgnitionGround(){
+  //Analog to digital calibration is not included here due to the 
+  //error being way less than the margins for this specific value
+  ignitionGroundLevel = analogRead(IGN_GND_RELAY_TEST_MEASURE_PIN);
+}
+
+//Only the test output pins can be changed by this
 void activateOutputPin(uint16_t pinNumber, bool pinState){
-    digitalWrite(pinNumber, pinState);
+  switch (pinNumber){
+    case IGN_GND_RELAY_TEST_DRIVE_PIN: fastWrite<IGN_GND_RELAY_TEST_DRIVE_PIN>(pinState); break;
+    default: break;
+  }
 }
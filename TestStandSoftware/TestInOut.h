@@ -30,6 +30,16 @@ void initTestInOut(void);
  */
 void readTestInput(testInput_t* testInput, bool readAll);
 
+
+/* Function:      Sample the analog IGN_GND relay test input. Called with
+ *                every sample in TEST mode, readTestInput() returns the
+ *                latest sample.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void sampleIgnitionGround(void);
+
 /* Function:      Set the state of the pin at testOutputPins[pinIndex] to 
  *                the desired state.
  *
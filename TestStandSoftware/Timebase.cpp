@@ -0,0 +1,168 @@
+/* Filename:      Timebase.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       32-bit sample timebase from the 16-bit Timer1 and its overflow
+ *                interrupt. Replaces the 64-bit micros() arithmetic of the
+ *                sampling loop.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Timebase.h"
+
+/* Timebase explanation:
+ * Timer1 counts at 16MHz / 64 = 250kHz, one tick = 4us, and overflows every 262ms.
+ * The overflow interrupt counts the high 16 bits of the tick. When the counter has
+ * overflowed but the interrupt is still pending (interrupts disabled, or the read
+ * happens right at the overflow) the TOV1 flag is set and TCNT1 is small, so the
+ * high word is corrected by one. The 32-bit tick wraps every 2^32 * 4us = 4.77h,
+ * the wraps are counted in tickEpoch for extendTicks().
+ *
+ * Frame clock explanation:
+ * The compare unit A of the same timer releases the minor frames of the cyclic executive.
+ * Its interrupt moves OCR1A one frame ahead and counts the release. If the interrupt was
+ * held off past the next release, that release is counted too and OCR1A is moved ahead
+ * of the counter, otherwise the next match would come only after a full timer round.
+ * The OC1A pin is not connected.
+ */
+
+#if F_CPU != 16000000L
+#error "Timebase assumes a 16MHz clock"
+#endif
+
+static_assert(usPerSample % timebaseTickMicros == 0, "usPerSample must be a whole number of ticks");
+
+static volatile uint16_t overflowCount;   //High 16 bits of the tick
+static volatile uint16_t tickEpoch;       //Wraps of the 32-bit tick
+
+static volatile uint16_t framePeriod;     //Minor frame (ticks), 0 while the frame clock is stopped
+static volatile uint8_t releasedFrames;   //Releases not yet taken by waitForFrame(), saturates
+
+void initTimebase(){
+  uint8_t oldSREG = SREG;
+  cli();
+
+  //Normal mode, outputs disconnected, prescaler 64
+  TCCR1A = 0;
+  TCCR1C = 0;
+  TCCR1B = (1 << CS11) | (1 << CS10);
+
+  overflowCount = 0;
+  tickEpoch = 0;
+  framePeriod = 0;
+  releasedFrames = 0;
+  TIMSK1 &= ~(1 << OCIE1A);
+  TIFR1 = (1 << TOV1);    //Cleared by writing one
+  TIMSK1 |= (1 << TOIE1);
+
+  SREG = oldSREG;
+}
+
+ISR(TIMER1_OVF_vect){
+  overflowCount++;
+  if (overflowCount == 0){
+    tickEpoch++;
+  }
+}
+
+ISR(TIMER1_COMPA_vect){
+  uint16_t next = OCR1A + framePeriod;
+  uint8_t released = 1;
+
+  while ((int16_t) (next - TCNT1) < (int16_t) frameMinLead){
+    next += framePeriod;
+    released++;
+  }
+  OCR1A = next;
+
+  releasedFrames = (releasedFrames > 255 - released) ? 255 : releasedFrames + released;
+}
+
+//Read the tick and its epoch in one critical section
+static uint32_t readTicks(uint16_t* epoch){
+  uint8_t oldSREG = SREG;
+  cli();
+
+  uint16_t low = TCNT1;
+  uint16_t high = overflowCount;
+  uint16_t wraps = tickEpoch;
+
+  if ((TIFR1 & (1 << TOV1)) && low < 0x8000){
+    high++;
+    if (high == 0){
+      wraps++;
+    }
+  }
+
+  SREG = oldSREG;
+
+  *epoch = wraps;
+  return ((uint32_t) high << 16) | low;
+}
+
+uint32_t timebaseTicks(){
+  uint16_t epoch;
+  return readTicks(&epoch);
+}
+
+uint64_t extendTicks(uint32_t tick){
+  uint16_t epoch;
+  uint32_t now = readTicks(&epoch);
+
+  //A tick later than now is from before the latest wrap
+  if (tick > now){
+    epoch--;
+  }
+
+  return ((uint64_t) epoch << 32) | tick;
+}
+
+uint16_t timebaseTicks16(){
+  //TCNT1 is read through the shared TEMP register, an interrupt must not split the read
+  uint8_t oldSREG = SREG;
+  cli();
+  uint16_t low = TCNT1;
+  SREG = oldSREG;
+
+  return low;
+}
+
+void setFramePeriod(uint16_t frameTicks){
+  uint8_t oldSREG = SREG;
+  cli();
+
+  //The clock restarts from now, a release pending with the old period is dropped
+  OCR1A = TCNT1 + frameTicks;
+  framePeriod = frameTicks;
+  releasedFrames = 0;
+  TIFR1 = (1 << OCF1A);   //Cleared by writing one
+  TIMSK1 |= (1 << OCIE1A);
+
+  SREG = oldSREG;
+}
+
+uint8_t waitForFrame(bool* late){
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  *late = true;
+
+  while (true){
+    cli();
+    uint8_t released = releasedFrames;
+    if (released > 0){
+      releasedFrames = 0;
+      sei();
+      return released;
+    }
+
+    //The instruction after SEI runs before any interrupt, so a release can't slip in before the sleep
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    *late = false;
+  }
+}
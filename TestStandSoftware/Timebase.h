@@ -0,0 +1,78 @@
+/* Filename:      Timebase.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Timebase <<device>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+/* Function:      Start Timer1 as a free running 4us timebase in normal mode
+ *                and enable its overflow interrupt, which extends the counter
+ *                to 32 bits. Must be called before initPulse(), which uses
+ *                the compare units of the same timer.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initTimebase(void);
+
+
+/* Function:      Current time in ticks of timebaseTickMicros since
+ *                initTimebase(). Wraps every 4.77 hours, so only differences
+ *                of ticks should be used on the hot path.
+ *
+ * IN:            Nothing
+ * OUT:           uint32_t ticks
+ */
+uint32_t timebaseTicks(void);
+
+
+/* Function:      Extend a tick from the last 4.77 hours to a 64-bit tick count
+ *                that doesn't wrap. Meant for the slow frames only, the 64-bit
+ *                arithmetic is expensive on the AVR.
+ *
+ * IN:            uint32_t tick from timebaseTicks()
+ * OUT:           uint64_t ticks since initTimebase()
+ */
+uint64_t extendTicks(uint32_t tick);
+
+
+/* Function:      Low 16 bits of the current tick. Cheaper than timebaseTicks(),
+ *                for measuring durations shorter than 262ms.
+ *
+ * IN:            Nothing
+ * OUT:           uint16_t ticks
+ */
+uint16_t timebaseTicks16(void);
+
+
+/* Function:      Set the minor frame of the frame clock, which releases the
+ *                frames of the cyclic executive from the Timer1 compare unit A.
+ *                Every call restarts the clock with the next release one frame
+ *                from now, and drops the releases not yet taken.
+ *
+ * IN:            uint16_t frame length in ticks
+ * OUT:           Nothing
+ */
+void setFramePeriod(uint16_t frameTicks);
+
+
+/* Function:      Sleep in the idle mode until a frame is released. Returns at
+ *                once if frames were released since the previous call.
+ *
+ * IN:            Boolean pointer, set when a frame was already released at
+ *                the call, so the previous frame ran past its slot
+ * OUT:           uint8_t frames released since the previous call, more than
+ *                one when the previous frame overran a whole frame
+ */
+uint8_t waitForFrame(bool* late);
+
+#endif
@@ -0,0 +1,104 @@
+/* Filename:      Trend.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Streaming derivative estimators for the fast and medium rate
+ *                channels. Used by the FaultDetection object for rate of change
+ *                redlines and for extrapolating a channel a short time ahead,
+ *                and by the BurnEvents object for the slope checks.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Trend.h"
+
+/* Slope estimation explanation:
+ * Both the change of the value and the time between samples are filtered
+ * with the same first order IIR filter (time constant 2^trendFilterShift samples).
+ * The slope is the ratio of the two: slope = filteredDelta / filteredTime.
+ * The ratio is never calculated on the hot path. Instead the comparisons are
+ * cross-multiplied, so the update and every check are a few integer operations
+ * without divisions, and uneven sampling intervals are handled correctly.
+ *
+ * filteredDelta = Change of raw value per sample in Q8 fixed-point
+ * filteredTime = Time between samples in us, limited to 16 bits
+ */
+static int32_t filteredDelta[trendChannelCount];
+static uint16_t filteredTime[trendChannelCount];
+static int16_t lastValue[trendChannelCount];
+static uint32_t lastTime[trendChannelCount];
+static uint8_t sampleCount[trendChannelCount];
+
+void initTrend(){
+  for (uint8_t i = 0; i < trendChannelCount; i++){
+    filteredDelta[i] = 0;
+    filteredTime[i] = 0;
+    lastValue[i] = 0;
+    lastTime[i] = 0;
+    sampleCount[i] = 0;
+  }
+}
+
+static void updateChannel(uint8_t channel, int16_t value, uint32_t time){
+  uint32_t timeDiff = time - lastTime[channel];
+  if (timeDiff > 0xFFFF){
+    timeDiff = 0xFFFF;
+  }
+
+  int32_t delta = (int32_t) (value - lastValue[channel]) * 256;
+
+  lastValue[channel] = value;
+  lastTime[channel] = time;
+
+  if (sampleCount[channel] < 2){
+    //First sample has nothing to compare to, second one initializes the filters
+    sampleCount[channel]++;
+    filteredDelta[channel] = delta;
+    filteredTime[channel] = timeDiff;
+    return;
+  }
+
+  filteredDelta[channel] += (delta - filteredDelta[channel]) >> trendFilterShift;
+  filteredTime[channel] += ((int32_t) timeDiff - filteredTime[channel]) >> trendFilterShift;
+}
+
+void updateTrend(const values_t& values){
+  uint32_t time = values.hot.tick * timebaseTickMicros;
+
+  //Fast channels are sampled every loop
+  updateChannel(CH_CHAMBER_PRESSURE, values.hot.combustionPressure, time);
+  updateChannel(CH_LOAD_CELL, values.hot.loadCell, time);
+
+  if (values.cold.mediumUpdated == true){
+    updateChannel(CH_N2_FEEDING_PRESSURE, values.cold.N2FeedingPressure, time);
+    updateChannel(CH_LINE_PRESSURE, values.cold.linePressure, time);
+    updateChannel(CH_N2O_FEEDING_PRESSURE, values.cold.N2OFeedingPressure, time);
+  }
+}
+
+/* Slope (counts/ms) > rate / 256
+ * <=> 1000 * filteredDelta / (256 * filteredTime) > rate / 256
+ * <=> 1000 * filteredDelta > rate * filteredTime
+ */
+bool slopeAbove(sensorChannel_t channel, int16_t rate){
+  if (sampleCount[channel] < 2){return false;}
+  return 1000 * filteredDelta[channel] > (int32_t) rate * filteredTime[channel];
+}
+
+bool slopeBelow(sensorChannel_t channel, int16_t rate){
+  if (sampleCount[channel] < 2){return false;}
+  return 1000 * filteredDelta[channel] < (int32_t) rate * filteredTime[channel];
+}
+
+/* Value + slope (counts/us) * 16 * horizon > level
+ * <=> filteredDelta * 16 * horizon / (256 * filteredTime) > level - value
+ * <=> filteredDelta * horizon > 16 * filteredTime * (level - value)
+ * The horizon is limited to 100ms to keep the products within 32 bits.
+ */
+bool predictAbove(sensorChannel_t channel, int16_t value, int16_t level, int16_t horizon){
+  if (value > level){return true;}
+  if (sampleCount[channel] < 2 || filteredDelta[channel] <= 0){return false;}
+  return filteredDelta[channel] * horizon > 16 * (int32_t) filteredTime[channel] * (level - value);
+}
@@ -0,0 +1,65 @@
+/* Filename:      Trend.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Trend <<passive>> object. 
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef TREND_H
+#define TREND_H
+
+/* Function:      Initialize the Trend object. Clears the derivative estimators
+ *                of all channels.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initTrend(void);
+
+
+/* Function:      Feed the newest measurements to the derivative estimators.
+ *                Only the channels that were sampled this loop are updated.
+ *                Constant time, integer only.
+ *
+ * IN:            Reference to a values_t struct with the newest measurements
+ * OUT:           Nothing
+ */
+void updateTrend(const values_t& values);
+
+
+/* Function:      Compare the estimated slope of a channel against a rate.
+ *
+ * IN:            Channel to check (only channels below trendChannelCount),
+ *                rate in raw counts per ms in Q8 fixed-point (see lineRateToRaw())
+ * OUT:           True if the slope is above the given rate
+ */
+bool slopeAbove(sensorChannel_t channel, int16_t rate);
+
+
+/* Function:      Compare the estimated slope of a channel against a rate.
+ *
+ * IN:            Channel to check (only channels below trendChannelCount),
+ *                rate in raw counts per ms in Q8 fixed-point (see lineRateToRaw())
+ * OUT:           True if the slope is below the given rate
+ */
+bool slopeBelow(sensorChannel_t channel, int16_t rate);
+
+
+/* Function:      Extrapolate the channel along its current slope and check
+ *                if it will be above the given level within the horizon.
+ *
+ * IN:            Channel to check (only channels below trendChannelCount),
+ *                current raw value of the channel,
+ *                level in raw counts,
+ *                horizon in units of 16us (see msToTrendHorizon())
+ * OUT:           True if the level is already exceeded or will be within the horizon
+ */
+bool predictAbove(sensorChannel_t channel, int16_t value, int16_t level, int16_t horizon);
+
+#endif
@@ -0,0 +1,135 @@
+/* Filename:      Uplink.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Receives the commands of the Rock 4C+ microcomputer. The bytes
+ *                are buffered by the receive interrupt of HardwareSerial and
+ *                parsed here a bounded amount at a time, so a command never
+ *                stalls the frame it is parsed in.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Uplink.h"
+
+/* Uplink explanation:
+ * Frames are unstuffed into frameBuffer as they arrive and checked when the end marker
+ * is received. After startup or a SEQUENCE the parser is out of sync: the bytes up to the
+ * next end marker may be the tail of an older frame and are dropped. The Rock therefore
+ * starts every command with an end marker, empty frames are ignored.
+ * The receive interrupt of HardwareSerial takes a few microseconds per byte. It is turned
+ * off in SEQUENCE, so the burst sampling sees no added latency from the uplink.
+ */
+
+static uint8_t frameBuffer[commandFrameMax];
+static uint8_t frameLength;
+static bool escaped;
+static bool synchronized;   //false until the first end marker after the receiver was turned on
+static bool receiving;
+
+static uint16_t badFrames;
+
+//UCSR0B is outside the SBI/CBI range and also written by the transmit interrupt
+static void setReceiver(bool state){
+  uint8_t oldSREG = SREG;
+  cli();
+  if (state){UCSR0B |= (1 << RXCIE0);}
+  else      {UCSR0B &= ~(1 << RXCIE0);}
+  SREG = oldSREG;
+
+  receiving = state;
+  frameLength = 0;
+  escaped = false;
+  synchronized = false;
+}
+
+static void countBadFrame(){
+  if (badFrames < UINT16_MAX){
+    badFrames++;
+  }
+}
+
+static bool decodeFrame(command_t* command){
+  if (frameLength == 0){
+    return false;
+  }
+  if (frameLength < 4){
+    countBadFrame();
+    return false;
+  }
+
+  uint8_t dataLength = frameLength - 2;
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < dataLength; i++){
+    crc = _crc_ccitt_update(crc, frameBuffer[i]);
+  }
+  if (crc != ((uint16_t) frameBuffer[dataLength] << 8 | frameBuffer[dataLength + 1])){
+    countBadFrame();
+    return false;
+  }
+
+  command->sequence = frameBuffer[0];
+  command->id = frameBuffer[1];
+  command->length = dataLength - 2;
+  for (uint8_t i = 0; i < command->length; i++){
+    command->payload[i] = frameBuffer[2 + i];
+  }
+
+  return true;
+}
+
+void initUplink(){
+  badFrames = 0;
+  //Serial.begin() turned the receive interrupt on
+  setReceiver(true);
+}
+
+bool getCommand(command_t* command, mode_t currentMode){
+  if (currentMode == SEQUENCE){
+    if (receiving){
+      setReceiver(false);
+    }
+    return false;
+  }
+  if (!receiving){
+    setReceiver(true);
+  }
+
+  for (uint8_t i = 0; i < uplinkBytesPerCall; i++){
+    int received = Serial.read();
+    if (received < 0){
+      return false;
+    }
+    uint8_t byte = received;
+
+    if (byte == END_MARKER){
+      bool decoded = synchronized && !escaped && decodeFrame(command);
+      frameLength = 0;
+      escaped = false;
+      synchronized = true;
+      if (decoded){
+        return true;
+      }
+    }else if (!synchronized){
+      //Dropped until the next end marker
+    }else if (byte == ESCAPE_BYTE){
+      escaped = true;
+    }else if (frameLength == commandFrameMax){
+      //Too long for any command, the rest of the frame is dropped
+      countBadFrame();
+      synchronized = false;
+    }else{
+      frameBuffer[frameLength++] = escaped ? byte ^ ESCAPE_XOR : byte;
+      escaped = false;
+    }
+  }
+
+  return false;
+}
+
+uint16_t getBadFrames(){
+  return badFrames;
+}
@@ -0,0 +1,44 @@
+/* Filename:      Uplink.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Uplink <<device>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef UPLINK_H
+#define UPLINK_H
+
+/* Function:      Initialize the Uplink object. Must be called after initSerial().
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initUplink(void);
+
+
+/* Function:      Parse the received bytes for a command, at most
+ *                uplinkBytesPerCall bytes per call. In SEQUENCE the receive
+ *                interrupt is turned off and nothing is parsed, the bytes
+ *                received meanwhile are lost.
+ *
+ * IN:            command_t pointer where a received command will be stored,
+ *                mode_t current mode
+ * OUT:           Boolean telling if a command was received
+ */
+bool getCommand(command_t* command, mode_t currentMode);
+
+
+/* Function:      Get the count of the frames dropped for a CRC or length error.
+ *
+ * IN:            Nothing
+ * OUT:           uint16_t count since startup, saturates
+ */
+uint16_t getBadFrames(void);
+
+#endif
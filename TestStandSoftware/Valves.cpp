@@ -7,12 +7,13 @@
  *                control the flow of the oxidizer and purge gas.
  */
  
-#include <Arduino.h>
+#include "Hal.h"
 //#include <Arduino_FreeRTOS.h>
 //#include <semphr.h>
 #include <stdint.h>
 
 #include "Globals.h"
+#include "Gpio.h"
 
 // valvePins:
 // Arduino Pin 2 -> ConnectorPin 1 -> mainValve -> code value 0
@@ -27,21 +28,32 @@ void initValves(){
   //If this comment was me, I don't know what it means. -E.M.
 
   pinMode(pin_names_t::OXIDIZER_VALVE_PIN, OUTPUT);
-  digitalWrite(pin_names_t::OXIDIZER_VALVE_PIN, LOW);
+  fastWrite<pin_names_t::OXIDIZER_VALVE_PIN>(LOW);
   
   pinMode(pin_names_t::DUMP_VALVE_PIN, OUTPUT);
-  digitalWrite(pin_names_t::DUMP_VALVE_PIN, LOW); // Even though normally open, nominal state is dump valve open
+  fastWrite<pin_names_t::DUMP_VALVE_PIN>(LOW); // Even though normally open, nominal state is dump valve open
   
   pinMode(pin_names_t::N2FEEDING_VALVE_PIN, OUTPUT);
-  digitalWrite(pin_names_t::N2FEEDING_VALVE_PIN, LOW);
+  fastWrite<pin_names_t::N2FEEDING_VALVE_PIN>(LOW);
   
   //valveSemaphore = xSemaphoreCreateMutex();
 }
 
 void setValve(pin_names_t valve_pin, bool state){
-  digitalWrite(valve_pin, state);
+  //The pin is resolved here so each valve write is a single instruction
+  switch (valve_pin){
+    case pin_names_t::OXIDIZER_VALVE_PIN:  fastWrite<pin_names_t::OXIDIZER_VALVE_PIN>(state);  break;
+    case pin_names_t::DUMP_VALVE_PIN:      fastWrite<pin_names_t::DUMP_VALVE_PIN>(state);      break;
+    case pin_names_t::N2FEEDING_VALVE_PIN: fastWrite<pin_names_t::N2FEEDING_VALVE_PIN>(state); break;
+    default: break;
+  }
 }
 
 void getValve(pin_names_t valve_pin, bool* valveState){
-  *valveState = digitalRead(valve_pin);  
+  switch (valve_pin){
+    case pin_names_t::OXIDIZER_VALVE_PIN:  *valveState = fastRead<pin_names_t::OXIDIZER_VALVE_PIN>();  break;
+    case pin_names_t::DUMP_VALVE_PIN:      *valveState = fastRead<pin_names_t::DUMP_VALVE_PIN>();      break;
+    case pin_names_t::N2FEEDING_VALVE_PIN: *valveState = fastRead<pin_names_t::N2FEEDING_VALVE_PIN>(); break;
+    default: *valveState = false; break;
+  }
 }
@@ -7,7 +7,7 @@
  *                Prompts the control box operator to press buttons at relevant times.
  */
 
-#include <Arduino.h>
+#include "Hal.h"
 //#include <Arduino_FreeRTOS.h>
 #include <stdint.h>
 #include "Globals.h"
@@ -15,6 +15,7 @@
 #include "Ignition.h"
 #include "Valves.h"
 #include "TestAutomation.h"
+#include "Retained.h"
 
 static bool ignitionPowerPassed;
 static bool ignitionGroundPassed;
@@ -33,13 +34,13 @@ static uint32_t endCountTime;
 static int16_t endCount;
 //static char message[64];
 //static char* msg = message;
-static uint16_t msg;
 
-bool runVerificationStep(values_t buttonValues, testInput_t testInput){
+bool runVerificationStep(const coldValues_t& buttonValues, const testInput_t& testInput){
   if (!testCompleted){
     switch (verificationState){
       case TEST_START:
         sendMessageToSerial(MSG_TEST_SEQUENCE_START);
+        setNewBuzzerPattern(BUZZER_TEST);
         verificationState = OFF_STATE_BUTTON;
         break;
 
@@ -229,9 +230,11 @@ bool runVerificationStep(values_t buttonValues, testInput_t testInput){
 
           if (allPassed){
             sendMessageToSerial(MSG_TEST_PASSED);
+            setNewBuzzerPattern(BUZZER_TEST);
           }
           else{
             sendMessageToSerial(MSG_TEST_FAILED);
+            setNewBuzzerPattern(BUZZER_RESET);
           }
           verificationState = TEST_END;
           //Immediately start the countdown
@@ -255,6 +258,7 @@ bool runVerificationStep(values_t buttonValues, testInput_t testInput){
           //sendMessageToSerial(msg);
           if (allPassed){
             testCompleted = true;
+            retainVerification(true);
           }
           else{
             testCompleted = false;
@@ -290,6 +294,9 @@ void initVerification(){
   
   //Initial state for the verification
   verificationState = TEST_START;
+  buttonFaultMessageFlag = false;
+  testStateChangeTime = 0;
+  endCountTime = 0;
 
   //Counter for seconds at the end of the test.
   endCount = verificationEndCount;
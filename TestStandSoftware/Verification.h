@@ -28,6 +28,6 @@
  * IN:            Latest values for control buttons and test pins       
  * OUT:           Boolean stating of the test has been completed       
  */
-bool runVerificationStep(values_t buttonValues, testInput_t testInput);
+bool runVerificationStep(const coldValues_t& buttonValues, const testInput_t& testInput);
 
 #endif
\ No newline at end of file
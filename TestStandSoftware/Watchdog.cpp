@@ -0,0 +1,75 @@
+/* Filename:      Watchdog.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Supervises the tasks of the executive with the hardware
+ *                watchdog. The watchdog is only restarted when every task of
+ *                the schedule has returned since the previous restart. On the
+ *                first timeout the interrupt forces the igniter and the valves
+ *                safe and records the stalled task, the second one resets.
+ */
+
+#include "Hal.h"
+#include <stdint.h>
+
+#include "Globals.h"
+#include "Watchdog.h"
+#include "Ignition.h"
+#include "Valves.h"
+#include "Retained.h"
+
+/* Watchdog explanation:
+ * With WDIE and WDE both set the first timeout only raises the interrupt, the hardware
+ * clears WDIE when the interrupt is entered and the next timeout resets the system.
+ * A task that never returns, or a loop that stops running the tasks, leaves the actuators
+ * in their reset state after one timeout and restarts the system after two. A task that
+ * returns after the interrupt doesn't feed the watchdog anymore, the reset always follows.
+ * The stall phase is kept by the Retained object and sent in the boot frame.
+ */
+
+static volatile uint8_t heartbeats;
+static volatile uint8_t lastTask;
+static volatile bool taskRunning;
+static volatile bool expired;
+
+void initWatchdog(){
+  heartbeats = 0;
+  lastTask = noStall;
+  taskRunning = false;
+  expired = false;
+
+  wdt_enable(watchdogTimeout);
+  //WDIE can be set without the timed sequence
+  WDTCSR |= (1 << WDIE);
+}
+
+void taskStarted(task_t task){
+  lastTask = task;
+  taskRunning = true;
+}
+
+void taskFinished(task_t task){
+  taskRunning = false;
+  heartbeats |= 1 << task;
+}
+
+void feedWatchdog(uint8_t expectedTasks){
+  if (expired || (heartbeats & expectedTasks) != expectedTasks){
+    return;
+  }
+  heartbeats = 0;
+  wdt_reset();
+}
+
+ISR(WDT_vect){
+  expired = true;
+
+  //Same levels as after the reset: igniter off, oxidizer and feeding closed, dump open
+  setIgnition(false);
+  setValve(pin_names_t::OXIDIZER_VALVE_PIN, false);
+  setValve(pin_names_t::N2FEEDING_VALVE_PIN, false);
+  setValve(pin_names_t::DUMP_VALVE_PIN, false);
+
+  retainStall(taskRunning ? lastTask | stallInTask : lastTask);
+}
@@ -0,0 +1,53 @@
+/* Filename:      Watchdog.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Header file for the Watchdog <<device>> object.
+ *                Contains function definitions.
+ */
+
+#include <stdint.h>
+
+#include "Globals.h"
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+/* Function:      Start the watchdog in the interrupt and system reset mode
+ *                with watchdogTimeout. Must be the last initialization, the
+ *                executive has to feed the watchdog from then on.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void initWatchdog(void);
+
+
+/* Function:      Mark the start of a task of the executive.
+ *
+ * IN:            task_t task that is started
+ * OUT:           Nothing
+ */
+void taskStarted(task_t task);
+
+
+/* Function:      Mark the return of a task of the executive and record its
+ *                heartbeat.
+ *
+ * IN:            task_t task that returned
+ * OUT:           Nothing
+ */
+void taskFinished(task_t task);
+
+
+/* Function:      Restart the watchdog timeout if every expected task has
+ *                recorded a heartbeat since the previous restart. Called at
+ *                the end of every frame of the executive.
+ *
+ * IN:            uint8_t mask of the expected tasks, bit n is task_t n
+ * OUT:           Nothing
+ */
+void feedWatchdog(uint8_t expectedTasks);
+
+#endif
@@ -0,0 +1,351 @@
+/* Filename:      bench.c
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Cycle accurate benchmark of the Test Stand Software. Runs the
+ *                real ATmega2560 image, built with -DBENCH_BUILD, in simavr
+ *                with scripted button, ADC, MAX31855 and UART stimulus, and
+ *                writes the cycle counts of the functions marked in Bench.h,
+ *                the loop times per mode and the achieved sample rate as JSON.
+ *
+ *                Usage: bench [-t seconds] [-p ignition press s] [-o results.json] firmware.elf
+ *
+ *                Stimulus: the operator box is idle and the automatic test is
+ *                off, so the firmware boots to WAIT. The ignition button is
+ *                pressed at -p and held, which runs one full sequence. A burn
+ *                is shown on the chamber, line and load cell inputs between
+ *                the nominal valve opening and closing times of Globals.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+#include "avr_ioport.h"
+#include "avr_adc.h"
+#include "avr_uart.h"
+#include "avr_spi.h"
+
+#include "Bench.h"
+#include "Timings.h"
+
+//Data space addresses of GPIOR0 and GPIOR1 on the ATmega2560
+#define GPIOR0_ADDRESS 0x3E
+#define GPIOR1_ADDRESS 0x4A
+
+#define CPU_FREQUENCY 16000000UL
+
+//Mode names in the order of mode_t. The times of the sequence and MODE_COUNT come from
+//Globals.h through Timings.h, generated by timings.cpp
+static const char* const modeNames[MODE_COUNT] = {"INIT", "TEST", "WAIT", "SEQUENCE", "SAFE", "SHUTDOWN"};
+
+//Keep in sync with benchMarker_t
+static const char* const benchFunctionNames[BENCH_MARKER_COUNT] = {
+  NULL, "senseLoop", "writeValues", "sendByteArray", "checkData"
+};
+
+struct cycleStats {
+  uint64_t count;
+  uint64_t sum;
+  uint64_t min;
+  uint64_t max;
+};
+
+static avr_t* avr;
+
+static struct cycleStats functionStats[BENCH_MARKER_COUNT];
+static avr_cycle_count_t enterCycle[BENCH_MARKER_COUNT];
+static int entered[BENCH_MARKER_COUNT];
+
+static struct cycleStats loopStats[MODE_COUNT];
+static avr_cycle_count_t loopStart;
+static int loopMode = -1;
+
+static uint64_t uartBytes;
+static uint64_t uartFrames;
+
+
+/* ---------------------------------------------------------------------------
+ * Markers
+ * ------------------------------------------------------------------------- */
+
+static void addSample(struct cycleStats* stats, uint64_t cycles){
+  if (stats->count == 0 || cycles < stats->min){stats->min = cycles;}
+  if (cycles > stats->max){stats->max = cycles;}
+  stats->sum += cycles;
+  stats->count++;
+}
+
+static void functionMarker(struct avr_t* avr, avr_io_addr_t addr, uint8_t value, void* param){
+  avr->data[addr] = value;
+
+  uint8_t marker = value & ~BENCH_EXIT_FLAG;
+  if (marker == 0 || marker >= BENCH_MARKER_COUNT){
+    return;
+  }
+
+  if (!(value & BENCH_EXIT_FLAG)){
+    enterCycle[marker] = avr->cycle;
+    entered[marker] = 1;
+  }else if (entered[marker]){
+    addSample(&functionStats[marker], avr->cycle - enterCycle[marker]);
+    entered[marker] = 0;
+  }
+}
+
+static void loopMarker(struct avr_t* avr, avr_io_addr_t addr, uint8_t value, void* param){
+  avr->data[addr] = value;
+
+  if (loopMode >= 0){
+    addSample(&loopStats[loopMode], avr->cycle - loopStart);
+  }
+  loopStart = avr->cycle;
+  loopMode = value < MODE_COUNT ? value : -1;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Stimulus
+ * ------------------------------------------------------------------------- */
+
+static void setPin(char port, int bit, int level){
+  avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(port), bit), level);
+}
+
+static void setAnalog(int channel, uint32_t millivolts){
+  avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0 + channel), millivolts);
+}
+
+//Linear approximations of the sensor calibrations in Globals.h, enough for the code paths
+static uint32_t pressureMillivolts(double bars, double fullScale){
+  return (uint32_t) (bars / fullScale * 5000.0);
+}
+
+static uint32_t loadMillivolts(double newtons){
+  return (uint32_t) (500.0 + newtons / 1112.0 * 4000.0);
+}
+
+static void setBurn(int burning){
+  setAnalog(1, pressureMillivolts(burning ? 43 : 0, 100));    //Line pressure
+  setAnalog(2, pressureMillivolts(burning ? 15 : 0, 25));     //Chamber pressure
+  setAnalog(3, loadMillivolts(burning ? 600 : 0));            //Load cell
+  setAnalog(6, burning ? 2400 : 400);                         //IR
+}
+
+static void initStimulus(){
+  //Operator box idle, pullup inputs high
+  setPin('B', 4, 0);    //DUMP_VALVE_BUTTON_PIN
+  setPin('H', 5, 0);    //IGNITION_SENSE_PIN
+  setPin('H', 6, 0);    //HEATING_SENSE_PIN
+  setPin('D', 1, 0);    //MAIN_VALVE_BUTTON_PIN
+  setPin('D', 0, 0);    //FEEDING_VALVE_BUTTON_PIN
+  setPin('A', 1, 1);    //AUTO_TEST_START_PIN, inverted, not pressed
+  setPin('C', 4, 1);    //REPEAT_SEQUENECE_PIN
+  setPin('C', 2, 1);    //SW_RESET_PIN
+  setPin('A', 5, 0);    //IGN_SW_RELAY_TEST_PIN
+  setPin('C', 6, 1);    //MAIN_VALVE_TEST_PIN, inverted, valve inactive
+
+  setAnalog(0, pressureMillivolts(50, 100));    //N2O feeding pressure
+  setAnalog(5, pressureMillivolts(60, 100));    //N2 feeding pressure
+  setAnalog(4, 720);                            //TMP36, 22C
+  setAnalog(15, 0);                             //IGN_GND_RELAY_TEST_MEASURE_PIN
+  setBurn(0);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * MAX31855 thermocouples on the hardware SPI, chip selects A2, A4, A6 and C7
+ * ------------------------------------------------------------------------- */
+
+#define THERMOCOUPLE_COUNT 4
+static const char csPort[THERMOCOUPLE_COUNT] = {'A', 'A', 'A', 'C'};
+static const int csBit[THERMOCOUPLE_COUNT] = {2, 4, 6, 7};
+static uint32_t thermocoupleWord[THERMOCOUPLE_COUNT];
+static int selected = -1;
+static int spiByte;
+
+//Thermocouple in bits 31...18 (0.25C), cold junction in bits 15...4 (0.0625C)
+static uint32_t max31855Word(double celsius){
+  uint32_t hot = (uint32_t) (int32_t) (celsius * 4) & 0x3FFF;
+  uint32_t cold = (uint32_t) (int32_t) (22.0 * 16) & 0xFFF;
+  return (hot << 18) | (cold << 4);
+}
+
+static void chipSelect(struct avr_irq_t* irq, uint32_t value, void* param){
+  int index = (int) (intptr_t) param;
+  if (value == 0){
+    selected = index;
+    spiByte = 0;
+  }else if (selected == index){
+    selected = -1;
+  }
+}
+
+static void spiOutput(struct avr_irq_t* irq, uint32_t value, void* param){
+  uint8_t reply = 0;
+  if (selected >= 0 && spiByte < 4){
+    reply = thermocoupleWord[selected] >> (24 - 8 * spiByte);
+    spiByte++;
+  }
+  avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_INPUT), reply);
+}
+
+static void uartOutput(struct avr_irq_t* irq, uint32_t value, void* param){
+  uartBytes++;
+  if ((value & 0xFF) == 0x7F){uartFrames++;}
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Results
+ * ------------------------------------------------------------------------- */
+
+static double cyclesToMicros(double cycles){
+  return cycles * 1000000.0 / CPU_FREQUENCY;
+}
+
+static void writeStats(FILE* out, const struct cycleStats* stats){
+  double mean = stats->count ? (double) stats->sum / stats->count : 0;
+  fprintf(out, "{\"count\": %llu, \"min_cycles\": %llu, \"mean_cycles\": %.1f, \"max_cycles\": %llu, \"max_us\": %.2f}",
+          (unsigned long long) stats->count, (unsigned long long) stats->min, mean,
+          (unsigned long long) stats->max, cyclesToMicros(stats->max));
+}
+
+static void writeResults(FILE* out, double seconds, double pressTime, int targetRate){
+  fprintf(out, "{\n  \"mcu\": \"atmega2560\",\n  \"f_cpu\": %lu,\n  \"simulated_s\": %.3f,\n  \"ignition_press_s\": %.3f,\n",
+          CPU_FREQUENCY, seconds, pressTime);
+
+  fprintf(out, "  \"functions\": {\n");
+  for (int i = 1; i < BENCH_MARKER_COUNT; i++){
+    fprintf(out, "    \"%s\": ", benchFunctionNames[i]);
+    writeStats(out, &functionStats[i]);
+    fprintf(out, "%s\n", i + 1 < BENCH_MARKER_COUNT ? "," : "");
+  }
+  fprintf(out, "  },\n");
+
+  fprintf(out, "  \"loops\": {\n");
+  int first = 1;
+  for (int i = 0; i < MODE_COUNT; i++){
+    if (loopStats[i].count == 0){continue;}
+    fprintf(out, "%s    \"%s\": ", first ? "" : ",\n", modeNames[i]);
+    writeStats(out, &loopStats[i]);
+    first = 0;
+  }
+  fprintf(out, "\n  },\n");
+
+  const struct cycleStats* sequence = &loopStats[MODE_SEQUENCE];
+  double achieved = sequence->sum ? sequence->count / (sequence->sum / (double) CPU_FREQUENCY) : 0;
+  double worst = sequence->max ? CPU_FREQUENCY / (double) sequence->max : 0;
+  fprintf(out, "  \"sample_rate\": {\"target_hz\": %d, \"achieved_hz\": %.1f, \"worst_loop_hz\": %.1f},\n",
+          targetRate, achieved, worst);
+
+  fprintf(out, "  \"uart\": {\"bytes\": %llu, \"frames\": %llu}\n}\n",
+          (unsigned long long) uartBytes, (unsigned long long) uartFrames);
+}
+
+
+int main(int argc, char** argv){
+  double seconds = 14.0;
+  double pressTime = 2.0;
+  int targetRate = 5000;
+  const char* outPath = NULL;
+
+  int option;
+  while ((option = getopt(argc, argv, "t:p:r:o:")) != -1){
+    switch (option){
+      case 't': seconds = atof(optarg); break;
+      case 'p': pressTime = atof(optarg); break;
+      case 'r': targetRate = atoi(optarg); break;
+      case 'o': outPath = optarg; break;
+      default:
+        fprintf(stderr, "Usage: %s [-t seconds] [-p ignition press s] [-r target Hz] [-o results.json] firmware.elf\n", argv[0]);
+        return 2;
+    }
+  }
+  if (optind >= argc){
+    fprintf(stderr, "No firmware given\n");
+    return 2;
+  }
+
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if (elf_read_firmware(argv[optind], &firmware) != 0){
+    fprintf(stderr, "Could not read %s\n", argv[optind]);
+    return 1;
+  }
+
+  avr = avr_make_mcu_by_name("atmega2560");
+  if (avr == NULL){
+    fprintf(stderr, "simavr has no atmega2560 core\n");
+    return 1;
+  }
+  avr_init(avr);
+  avr_load_firmware(avr, &firmware);
+  avr->frequency = CPU_FREQUENCY;
+  avr->vcc = 5000;
+  avr->avcc = 5000;
+  avr->aref = 5000;
+  avr->log = LOG_ERROR;
+
+  avr_register_io_write(avr, GPIOR0_ADDRESS, functionMarker, NULL);
+  avr_register_io_write(avr, GPIOR1_ADDRESS, loopMarker, NULL);
+
+  for (int i = 0; i < THERMOCOUPLE_COUNT; i++){
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(csPort[i]), csBit[i]), chipSelect, (void*) (intptr_t) i);
+    thermocoupleWord[i] = max31855Word(20.0);
+  }
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_OUTPUT), spiOutput, NULL);
+
+  //The UART runs at its baud rate, the bytes are only counted
+  uint32_t flags = 0;
+  avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+  flags &= ~AVR_UART_FLAG_STDIO;
+  avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+  avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uartOutput, NULL);
+
+  initStimulus();
+
+  avr_cycle_count_t end = (avr_cycle_count_t) (seconds * CPU_FREQUENCY);
+  avr_cycle_count_t press = (avr_cycle_count_t) (pressTime * CPU_FREQUENCY);
+  avr_cycle_count_t burnStart = press + (avr_cycle_count_t) (IGNITION_SAFE_TIME + VALVE_ON_TIME) * (CPU_FREQUENCY / 1000);
+  avr_cycle_count_t burnEnd = press + (avr_cycle_count_t) (IGNITION_SAFE_TIME + VALVE_OFF_TIME) * (CPU_FREQUENCY / 1000);
+  int pressed = 0, burning = 0, burnt = 0;
+
+  while (avr->cycle < end){
+    int state = avr_run(avr);
+    if (state == cpu_Done || state == cpu_Crashed){
+      fprintf(stderr, "Firmware stopped at cycle %llu\n", (unsigned long long) avr->cycle);
+      return 1;
+    }
+
+    if (!pressed && avr->cycle >= press){
+      setPin('H', 5, 1);
+      pressed = 1;
+    }
+    if (!burning && avr->cycle >= burnStart){
+      setBurn(1);
+      thermocoupleWord[2] = max31855Word(400.0);
+      burning = 1;
+    }
+    if (!burnt && avr->cycle >= burnEnd){
+      setBurn(0);
+      burnt = 1;
+    }
+  }
+
+  FILE* out = outPath ? fopen(outPath, "w") : stdout;
+  if (out == NULL){
+    fprintf(stderr, "Could not write %s\n", outPath);
+    return 1;
+  }
+  writeResults(out, seconds, pressTime, targetRate);
+  if (out != stdout){fclose(out);}
+
+  return 0;
+}
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# Filename:      compare.py
+# Author:        Eemeli Mykrä
+# Date:          18.10.2026
+# Version:       V1.56 (18.10.2026)
+#
+# Purpose:       Compare two results.json files of bench and print the changes.
+#                Exits with 1 if a function or loop got slower than the
+#                tolerance, or the achieved sample rate of the sequence dropped.
+
+import argparse
+import json
+import sys
+
+
+def change(old, new):
+    return (new - old) / old if old else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("results")
+    parser.add_argument("--tolerance", type=float, default=0.05,
+                        help="allowed relative increase of the cycle counts")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        old = json.load(f)
+    with open(args.results) as f:
+        new = json.load(f)
+
+    regressions = []
+
+    def check(name, before, after, key):
+        if before is None or after is None:
+            print(f"{name:32s} {key:12s} {'-':>10} {after[key] if after else '-':>10}")
+            return
+        delta = change(before[key], after[key])
+        print(f"{name:32s} {key:12s} {before[key]:>10} {after[key]:>10} {delta:+8.1%}")
+        if delta > args.tolerance:
+            regressions.append(f"{name} {key} {delta:+.1%}")
+
+    for group in ("functions", "loops"):
+        names = sorted(set(old.get(group, {})) | set(new.get(group, {})))
+        for name in names:
+            before = old.get(group, {}).get(name)
+            after = new.get(group, {}).get(name)
+            for key in ("mean_cycles", "max_cycles"):
+                check(f"{group}.{name}", before, after, key)
+
+    before = old["sample_rate"]["achieved_hz"]
+    after = new["sample_rate"]["achieved_hz"]
+    delta = change(before, after)
+    print(f"{'sample_rate':32s} {'achieved_hz':12s} {before:>10} {after:>10} {delta:+8.1%}")
+    if -delta > args.tolerance:
+        regressions.append(f"sample rate {delta:+.1%}")
+    if after < new["sample_rate"]["target_hz"] * (1 - args.tolerance):
+        regressions.append(f"sample rate {after} Hz under the target {new['sample_rate']['target_hz']} Hz")
+
+    if regressions:
+        print("\nRegressions:")
+        for line in regressions:
+            print("  " + line)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,26 @@
+/* Filename:      timings.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Writes the times of the sequence and the mode numbers of
+ *                Globals.h as a C header for bench.c, which is plain C and
+ *                can't include Globals.h. Built for the machine running the
+ *                benchmark with the Linux backend of the Hal.
+ */
+
+#include <stdio.h>
+
+#include "Globals.h"
+
+int main(){
+  printf("/* Generated from Globals.h by timings.cpp, don't edit */\n\n");
+  printf("//Times of the sequence (ms from the start of the sequence)\n");
+  printf("#define IGNITION_SAFE_TIME %d\n", ignitionSafeTime);
+  printf("#define VALVE_ON_TIME      %d\n", valveOnTime);
+  printf("#define VALVE_OFF_TIME     %d\n\n", valveOffTime);
+  printf("//Modes of mode_t\n");
+  printf("#define MODE_COUNT    %d\n", SHUTDOWN + 1);
+  printf("#define MODE_SEQUENCE %d\n", SEQUENCE);
+  return 0;
+}
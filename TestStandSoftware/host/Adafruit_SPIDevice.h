@@ -0,0 +1,51 @@
+/* Filename:      Adafruit_SPIDevice.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Host build stand-in for the Adafruit BusIO SPI device. Reads
+ *                return the word set with hostSetSpiWord() for the chip select pin.
+ */
+
+#ifndef HOST_ADAFRUIT_SPIDEVICE_H
+#define HOST_ADAFRUIT_SPIDEVICE_H
+
+#include "HostArduino.h"
+
+typedef enum {
+  SPI_BITORDER_MSBFIRST,
+  SPI_BITORDER_LSBFIRST
+} BusIOBitOrder;
+
+typedef enum {
+  SPI_MODE0,
+  SPI_MODE1,
+  SPI_MODE2,
+  SPI_MODE3
+} BusIOSPIMode;
+
+class SPIClass {};
+extern SPIClass SPI;
+
+class Adafruit_SPIDevice {
+public:
+  Adafruit_SPIDevice(int8_t cspin, int8_t sckpin, int8_t misopin, int8_t mosipin, uint32_t freq)
+    : cs(cspin) {}
+  Adafruit_SPIDevice(int8_t cspin, uint32_t freq, BusIOBitOrder dataOrder, BusIOSPIMode dataMode, SPIClass* theSPI)
+    : cs(cspin) {}
+
+  bool begin(void) { return true; }
+
+  bool read(uint8_t* buffer, size_t len) {
+    uint32_t word = hostGetSpiWord(cs);
+    for (size_t i = 0; i < len; i++){
+      buffer[i] = (i < 4) ? (word >> (24 - 8 * i)) & 255 : 0;
+    }
+    return true;
+  }
+
+private:
+  int8_t cs;
+};
+
+#endif
@@ -0,0 +1,16 @@
+/* Filename:      Arduino.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Host build stand-in for the Arduino core header, for the
+ *                third party code that includes it directly. The objects of
+ *                the Test Stand Software include Hal.h instead.
+ */
+
+#ifndef HOST_ARDUINO_CORE_H
+#define HOST_ARDUINO_CORE_H
+
+#include "HostArduino.h"
+
+#endif
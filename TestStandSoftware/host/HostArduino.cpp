@@ -0,0 +1,650 @@
+/* Filename:      HostArduino.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Linux backend of the Hal. Virtual clock, register emulation
+ *                and the simulated ADC, GPIO, SPI and Serial.
+ */
+
+#include <stdio.h>
+
+#include "HostArduino.h"
+#include "Adafruit_SPIDevice.h"
+
+volatile uint8_t PORTA, PORTB, PORTC, PORTD, PORTE, PORTF, PORTG, PORTH, PORTJ, PORTK, PORTL;
+volatile uint8_t DDRA, DDRB, DDRC, DDRD, DDRE, DDRF, DDRG, DDRH, DDRJ, DDRK, DDRL;
+volatile uint8_t SREG;
+volatile uint8_t ADCSRA, ADCSRB, ADMUX;
+volatile uint8_t GPIOR0, GPIOR1, GPIOR2;
+volatile uint8_t MCUSR;
+volatile uint8_t WDTCSR;
+volatile uint8_t UCSR0B;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1;
+HostFlagRegister TIFR1;
+HostForceRegister TCCR1C(0);
+volatile uint16_t TCNT1, OCR1A, OCR1B, OCR1C;
+volatile uint8_t TCCR3A, TCCR3B, TIMSK3;
+HostFlagRegister TIFR3;
+HostForceRegister TCCR3C(1);
+volatile uint16_t TCNT3, OCR3A, OCR3B, OCR3C;
+
+HostSerial Serial;
+SPIClass SPI;
+
+//Vectors the firmware does not define stay null
+extern "C" {
+  void TIMER1_COMPA_vect(void) __attribute__((weak));
+  void TIMER1_COMPB_vect(void) __attribute__((weak));
+  void TIMER1_COMPC_vect(void) __attribute__((weak));
+  void TIMER1_OVF_vect(void) __attribute__((weak));
+  void TIMER3_COMPA_vect(void) __attribute__((weak));
+  void TIMER3_COMPB_vect(void) __attribute__((weak));
+  void TIMER3_COMPC_vect(void) __attribute__((weak));
+  void TIMER3_OVF_vect(void) __attribute__((weak));
+  void WDT_vect(void) __attribute__((weak));
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Pins
+ * ------------------------------------------------------------------------- */
+
+static volatile uint8_t* const portRegisters[hostPortCount] = {&PORTA, &PORTB, &PORTC, &PORTD, &PORTE, &PORTF, &PORTG, &PORTH, &PORTJ, &PORTK, &PORTL};
+static volatile uint8_t* const ddrRegisters[hostPortCount] = {&DDRA, &DDRB, &DDRC, &DDRD, &DDRE, &DDRF, &DDRG, &DDRH, &DDRJ, &DDRK, &DDRL};
+
+//Arduino Mega 2560 pin mapping, pin number -> port and bit
+static const uint8_t megaPinCount = 70;
+static const uint8_t pinPort[megaPinCount] = {
+  HOST_PORT_E, HOST_PORT_E, HOST_PORT_E, HOST_PORT_E, HOST_PORT_G, HOST_PORT_E, HOST_PORT_H, HOST_PORT_H,  // 0...7
+  HOST_PORT_H, HOST_PORT_H, HOST_PORT_B, HOST_PORT_B, HOST_PORT_B, HOST_PORT_B, HOST_PORT_J, HOST_PORT_J,  // 8...15
+  HOST_PORT_H, HOST_PORT_H, HOST_PORT_D, HOST_PORT_D, HOST_PORT_D, HOST_PORT_D, HOST_PORT_A, HOST_PORT_A,  //16...23
+  HOST_PORT_A, HOST_PORT_A, HOST_PORT_A, HOST_PORT_A, HOST_PORT_A, HOST_PORT_A, HOST_PORT_C, HOST_PORT_C,  //24...31
+  HOST_PORT_C, HOST_PORT_C, HOST_PORT_C, HOST_PORT_C, HOST_PORT_C, HOST_PORT_C, HOST_PORT_D, HOST_PORT_G,  //32...39
+  HOST_PORT_G, HOST_PORT_G, HOST_PORT_L, HOST_PORT_L, HOST_PORT_L, HOST_PORT_L, HOST_PORT_L, HOST_PORT_L,  //40...47
+  HOST_PORT_L, HOST_PORT_L, HOST_PORT_B, HOST_PORT_B, HOST_PORT_B, HOST_PORT_B, HOST_PORT_F, HOST_PORT_F,  //48...55
+  HOST_PORT_F, HOST_PORT_F, HOST_PORT_F, HOST_PORT_F, HOST_PORT_F, HOST_PORT_F, HOST_PORT_K, HOST_PORT_K,  //56...63
+  HOST_PORT_K, HOST_PORT_K, HOST_PORT_K, HOST_PORT_K, HOST_PORT_K, HOST_PORT_K                            //64...69
+};
+static const uint8_t pinBit[megaPinCount] = {
+  0, 1, 4, 5, 5, 3, 3, 4,
+  5, 6, 4, 5, 6, 7, 1, 0,
+  1, 0, 3, 2, 1, 0, 0, 1,
+  2, 3, 4, 5, 6, 7, 7, 6,
+  5, 4, 3, 2, 1, 0, 7, 2,
+  1, 0, 7, 6, 5, 4, 3, 2,
+  1, 0, 3, 2, 1, 0, 0, 1,
+  2, 3, 4, 5, 6, 7, 0, 1,
+  2, 3, 4, 5, 6, 7
+};
+
+//Externally driven inputs
+static uint8_t inputDriven[hostPortCount];
+static uint8_t inputLevel[hostPortCount];
+
+
+/* ---------------------------------------------------------------------------
+ * Timers
+ * ------------------------------------------------------------------------- */
+
+struct hostTimer_t {
+  volatile uint8_t* controlA;
+  volatile uint8_t* controlB;
+  volatile uint16_t* counter;
+  volatile uint16_t* compare[3];
+  volatile uint8_t* interruptMask;
+  HostFlagRegister* interruptFlags;
+  hostPort_t outputPort;
+  uint8_t outputBit[3];
+  void (*compareVector[3])(void);
+  void (*overflowVector)(void);
+};
+
+static const uint8_t hostTimerCount = 2;
+static hostTimer_t timers[hostTimerCount] = {
+  {&TCCR1A, &TCCR1B, &TCNT1, {&OCR1A, &OCR1B, &OCR1C}, &TIMSK1, &TIFR1, HOST_PORT_B, {5, 6, 7},
+   {TIMER1_COMPA_vect, TIMER1_COMPB_vect, TIMER1_COMPC_vect}, TIMER1_OVF_vect},
+  {&TCCR3A, &TCCR3B, &TCNT3, {&OCR3A, &OCR3B, &OCR3C}, &TIMSK3, &TIFR3, HOST_PORT_E, {3, 4, 5},
+   {TIMER3_COMPA_vect, TIMER3_COMPB_vect, TIMER3_COMPC_vect}, TIMER3_OVF_vect}
+};
+
+//Compare output latches (OCnx) and CPU cycles not yet counted by each timer
+static uint8_t outputLatch[hostTimerCount][3];
+static uint32_t timerCycles[hostTimerCount];
+
+//Virtual clock in CPU cycles
+static uint64_t cycles;
+static void (*clockHook)(void) = NULL;
+static bool inClockHook = false;
+static const uint64_t cyclesPerMicro = F_CPU / 1000000L;
+
+//Watchdog, the deadline is in cycles of the virtual clock
+static bool watchdogEnabled = false;
+static uint64_t watchdogTimeout;
+static uint64_t watchdogDeadline;
+static void (*resetHandler)(void) = NULL;
+
+static uint16_t timerPrescaler(uint8_t clockSelect){
+  switch (clockSelect & 7){
+    case 1: return 1;
+    case 2: return 8;
+    case 3: return 64;
+    case 4: return 256;
+    case 5: return 1024;
+    default: return 0;  //Stopped or external clock
+  }
+}
+
+//COMnx bits of a compare unit, 0 = output disconnected
+static uint8_t compareOutputMode(hostTimer_t* timer, uint8_t unit){
+  return (*timer->controlA >> (6 - 2 * unit)) & 3;
+}
+
+static void serviceInterrupts(){
+  if (!(SREG & (1 << SREG_I))){
+    return;
+  }
+
+  bool serviced = true;
+  while (serviced){
+    serviced = false;
+
+    //Entering the watchdog interrupt clears WDIF and WDIE, the next timeout resets
+    if ((WDTCSR & (1 << WDIF)) && (WDTCSR & (1 << WDIE))){
+      WDTCSR &= ~((1 << WDIF) | (1 << WDIE));
+      if (WDT_vect != NULL){
+        SREG &= ~(1 << SREG_I);
+        WDT_vect();
+        SREG |= (1 << SREG_I);
+      }
+      serviced = true;
+    }
+
+    for (uint8_t t = 0; t < hostTimerCount; t++){
+      hostTimer_t* timer = &timers[t];
+
+      for (uint8_t unit = 0; unit < 4; unit++){
+        uint8_t flag = (unit < 3) ? (1 << (unit + 1)) : 1;
+        if ((*timer->interruptFlags & flag) && (*timer->interruptMask & flag)){
+          //The flag is cleared when the interrupt routine is entered
+          *timer->interruptFlags = flag;
+
+          void (*vector)(void) = (unit < 3) ? timer->compareVector[unit] : timer->overflowVector;
+          if (vector != NULL){
+            //Interrupts are disabled while an interrupt routine runs
+            SREG &= ~(1 << SREG_I);
+            vector();
+            SREG |= (1 << SREG_I);
+          }
+          serviced = true;
+        }
+      }
+    }
+  }
+}
+
+//Compare output latch update of a compare match or a forced compare
+static void updateLatch(uint8_t t, uint8_t unit){
+  uint8_t mode = compareOutputMode(&timers[t], unit);
+  if (mode == 1){outputLatch[t][unit] ^= 1;}
+  else if (mode == 2){outputLatch[t][unit] = 0;}
+  else if (mode == 3){outputLatch[t][unit] = 1;}
+}
+
+//FOCnA, FOCnB and FOCnC are bits 7, 6 and 5. No interrupt flag is set
+HostForceRegister& HostForceRegister::operator=(uint8_t value){
+  for (uint8_t unit = 0; unit < 3; unit++){
+    if (value & (1 << (7 - unit))){
+      updateLatch(timer, unit);
+    }
+  }
+  return *this;
+}
+
+//Step a timer in normal mode, stopping at every compare match and overflow
+static void stepTimer(uint8_t t, uint32_t ticks){
+  hostTimer_t* timer = &timers[t];
+
+  while (ticks > 0){
+    uint32_t step = 0x10000 - *timer->counter;  //Ticks to overflow
+
+    for (uint8_t unit = 0; unit < 3; unit++){
+      uint32_t distance = (uint16_t) (*timer->compare[unit] - *timer->counter);
+      if (distance == 0){distance = 0x10000;}
+      if (distance < step){step = distance;}
+    }
+    if (ticks < step){step = ticks;}
+
+    uint32_t next = *timer->counter + step;
+    *timer->counter = (uint16_t) next;
+    ticks -= step;
+
+    if (next == 0x10000){
+      timer->interruptFlags->raise(1);
+    }
+
+    for (uint8_t unit = 0; unit < 3; unit++){
+      if (*timer->counter == *timer->compare[unit]){
+        timer->interruptFlags->raise(1 << (unit + 1));
+        updateLatch(t, unit);
+      }
+    }
+
+    serviceInterrupts();
+  }
+}
+
+void hostAdvanceMicros(uint32_t us){
+  uint64_t advance = (uint64_t) us * cyclesPerMicro;
+  cycles += advance;
+
+  for (uint8_t t = 0; t < hostTimerCount; t++){
+    uint16_t prescaler = timerPrescaler(*timers[t].controlB);
+    if (prescaler == 0){
+      continue;
+    }
+    uint64_t total = timerCycles[t] + advance;
+    timerCycles[t] = total % prescaler;
+    stepTimer(t, (uint32_t) (total / prescaler));
+  }
+
+  serviceInterrupts();
+
+  while (watchdogEnabled && cycles >= watchdogDeadline){
+    //The first timeout with WDIE set only raises the interrupt
+    if ((WDTCSR & (1 << WDIE)) && !(WDTCSR & (1 << WDIF))){
+      WDTCSR |= (1 << WDIF);
+      watchdogDeadline += watchdogTimeout;
+      serviceInterrupts();
+      continue;
+    }
+
+    watchdogEnabled = false;
+    MCUSR |= (1 << WDRF);
+
+    if (resetHandler == NULL){
+      fprintf(stderr, "Watchdog reset at %.3f ms\n", hostMicros() / 1000.0);
+      exit(2);
+    }
+    resetHandler();
+  }
+
+  if (clockHook != NULL && !inClockHook){
+    inClockHook = true;
+    clockHook();
+    inClockHook = false;
+  }
+}
+
+void hostSleep(){
+  //Cycles to the first enabled timer interrupt, the Timebase overflow interrupt is always enabled
+  uint64_t wait = 0;
+
+  for (uint8_t t = 0; t < hostTimerCount; t++){
+    hostTimer_t* timer = &timers[t];
+    uint16_t prescaler = timerPrescaler(*timer->controlB);
+    if (prescaler == 0){
+      continue;
+    }
+
+    uint32_t ticks = 0;
+    if (*timer->interruptMask & 1){
+      ticks = 0x10000 - *timer->counter;
+    }
+    for (uint8_t unit = 0; unit < 3; unit++){
+      if (*timer->interruptMask & (1 << (unit + 1))){
+        uint32_t distance = (uint16_t) (*timer->compare[unit] - *timer->counter);
+        if (distance == 0){distance = 0x10000;}
+        if (ticks == 0 || distance < ticks){ticks = distance;}
+      }
+    }
+    if (ticks == 0){
+      continue;
+    }
+
+    uint64_t timerWait = (uint64_t) ticks * prescaler - timerCycles[t];
+    if (wait == 0 || timerWait < wait){wait = timerWait;}
+  }
+
+  //The watchdog wakes up the sleep with a reset
+  if (watchdogEnabled && (wait == 0 || watchdogDeadline - cycles < wait)){
+    wait = watchdogDeadline - cycles;
+  }
+
+  //A sleep without a wake-up source would never end on the AVR, the host moves on
+  if (wait == 0){
+    wait = cyclesPerMicro;
+  }
+
+  hostAdvanceMicros((uint32_t) ((wait + cyclesPerMicro - 1) / cyclesPerMicro));
+}
+
+void wdt_enable(uint8_t timeout){
+  //Like avr-libc, the write clears WDIE and leaves the watchdog in the system reset mode
+  WDTCSR = (1 << WDE) | (timeout & 7) | ((timeout & 8) << 2);
+  watchdogTimeout = (16000ULL << timeout) * cyclesPerMicro;
+  watchdogDeadline = cycles + watchdogTimeout;
+  watchdogEnabled = true;
+}
+
+void wdt_disable(){
+  WDTCSR = 0;
+  watchdogEnabled = false;
+}
+
+void wdt_reset(){
+  watchdogDeadline = cycles + watchdogTimeout;
+}
+
+void hostSetResetHandler(void (*handler)(void)){
+  resetHandler = handler;
+}
+
+void hostSetClockHook(void (*hook)(void)){
+  clockHook = hook;
+}
+
+uint64_t hostMicros(){
+  return cycles / cyclesPerMicro;
+}
+
+void hostSei(){
+  SREG |= (1 << SREG_I);
+  serviceInterrupts();
+}
+
+
+/* ---------------------------------------------------------------------------
+ * GPIO
+ * ------------------------------------------------------------------------- */
+
+uint8_t hostReadPin(hostPort_t port){
+  uint8_t ddr = *ddrRegisters[port];
+  uint8_t portValue = *portRegisters[port];
+
+  //Outputs, pullups and external drivers
+  uint8_t level = portValue & ddr;
+  uint8_t inputs = ~ddr;
+  level |= inputs & inputDriven[port] & inputLevel[port];
+  level |= inputs & ~inputDriven[port] & portValue;
+
+  //Compare outputs override PORT when connected
+  for (uint8_t t = 0; t < hostTimerCount; t++){
+    if (timers[t].outputPort != port){
+      continue;
+    }
+    for (uint8_t unit = 0; unit < 3; unit++){
+      uint8_t mask = 1 << timers[t].outputBit[unit];
+      if (compareOutputMode(&timers[t], unit) != 0 && (ddr & mask)){
+        level = outputLatch[t][unit] ? (level | mask) : (level & ~mask);
+      }
+    }
+  }
+
+  return level;
+}
+
+void pinMode(uint8_t pin, uint8_t mode){
+  if (pin >= megaPinCount){return;}
+  uint8_t mask = 1 << pinBit[pin];
+
+  if (mode == OUTPUT){
+    *ddrRegisters[pinPort[pin]] |= mask;
+  }else{
+    *ddrRegisters[pinPort[pin]] &= ~mask;
+    if (mode == INPUT_PULLUP){*portRegisters[pinPort[pin]] |= mask;}
+    else                     {*portRegisters[pinPort[pin]] &= ~mask;}
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value){
+  if (pin >= megaPinCount){return;}
+  uint8_t mask = 1 << pinBit[pin];
+
+  if (value == LOW){*portRegisters[pinPort[pin]] &= ~mask;}
+  else             {*portRegisters[pinPort[pin]] |= mask;}
+}
+
+int digitalRead(uint8_t pin){
+  if (pin >= megaPinCount){return LOW;}
+  return (hostReadPin((hostPort_t) pinPort[pin]) >> pinBit[pin]) & 1;
+}
+
+void hostSetInput(uint8_t pin, bool level){
+  if (pin >= megaPinCount){return;}
+  uint8_t mask = 1 << pinBit[pin];
+
+  inputDriven[pinPort[pin]] |= mask;
+  if (level){inputLevel[pinPort[pin]] |= mask;}
+  else      {inputLevel[pinPort[pin]] &= ~mask;}
+}
+
+void hostReleaseInput(uint8_t pin){
+  if (pin >= megaPinCount){return;}
+  inputDriven[pinPort[pin]] &= ~(1 << pinBit[pin]);
+}
+
+bool hostPinLevel(uint8_t pin){
+  return digitalRead(pin) == HIGH;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * ADC and SPI
+ * ------------------------------------------------------------------------- */
+
+static const uint8_t analogChannelCount = 16;
+static uint16_t analogValues[analogChannelCount];
+
+static uint32_t spiWords[megaPinCount];
+
+void hostSetAnalog(uint8_t channel, uint16_t value){
+  if (channel >= A0){channel -= A0;}
+  if (channel >= analogChannelCount){return;}
+  analogValues[channel] = value > 1023 ? 1023 : value;
+}
+
+int analogRead(uint8_t pin){
+  if (pin >= A0){pin -= A0;}
+
+  //A conversion takes 13 ADC clocks
+  static const uint8_t adcPrescaler[8] = {2, 2, 4, 8, 16, 32, 64, 128};
+  uint32_t conversionCycles = 13UL * adcPrescaler[ADCSRA & 7];
+  hostAdvanceMicros((conversionCycles + cyclesPerMicro - 1) / cyclesPerMicro);
+
+  if (pin >= analogChannelCount){return 0;}
+  return analogValues[pin];
+}
+
+void hostSetSpiWord(uint8_t csPin, uint32_t word){
+  if (csPin >= megaPinCount){return;}
+  spiWords[csPin] = word;
+}
+
+uint32_t hostGetSpiWord(uint8_t csPin){
+  if (csPin >= megaPinCount){return 0;}
+
+  //32 bits at 1MHz with chip select handling
+  hostAdvanceMicros(40);
+  return spiWords[csPin];
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Time
+ * ------------------------------------------------------------------------- */
+
+unsigned long millis(){
+  return (unsigned long) (hostMicros() / 1000);
+}
+
+unsigned long micros(){
+  return (unsigned long) hostMicros();
+}
+
+void delay(unsigned long ms){
+  while (ms > 0){
+    hostAdvanceMicros(1000);
+    ms--;
+  }
+}
+
+void delayMicroseconds(unsigned int us){
+  hostAdvanceMicros(us);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Serial. Transmit buffer drains at the baud rate like the 64 byte
+ * HardwareSerial buffer, a write to a full buffer waits on the virtual clock.
+ * ------------------------------------------------------------------------- */
+
+static const size_t serialBufferSize = 1 << 16;
+static const uint8_t serialHardwareBuffer = 63;
+
+static uint8_t txBuffer[serialBufferSize];
+static size_t txHead, txTail;
+static uint8_t rxBuffer[serialBufferSize];
+static size_t rxHead, rxTail;
+
+static unsigned long serialBaud;
+static uint64_t txBusyUntil;    //Virtual time when the hardware buffer is empty (cycles)
+
+static uint64_t byteCycles(){
+  return serialBaud == 0 ? 0 : (10ULL * F_CPU) / serialBaud;
+}
+
+void HostSerial::begin(unsigned long baud){
+  serialBaud = baud;
+  UCSR0B = (1 << RXEN0) | (1 << TXEN0) | (1 << RXCIE0);
+}
+
+void HostSerial::end(){
+  serialBaud = 0;
+  UCSR0B = 0;
+}
+
+size_t HostSerial::write(uint8_t byte){
+  if (txBusyUntil < cycles){txBusyUntil = cycles;}
+
+  //Wait for room in the hardware buffer
+  uint64_t full = serialHardwareBuffer * byteCycles();
+  if (txBusyUntil - cycles > full){
+    uint64_t wait = txBusyUntil - cycles - full;
+    hostAdvanceMicros((uint32_t) ((wait + cyclesPerMicro - 1) / cyclesPerMicro));
+  }
+  txBusyUntil += byteCycles();
+
+  txBuffer[txHead] = byte;
+  txHead = (txHead + 1) % serialBufferSize;
+  if (txHead == txTail){txTail = (txTail + 1) % serialBufferSize;}   //Drop the oldest byte
+  return 1;
+}
+
+int HostSerial::available(){
+  return (int) ((rxHead + serialBufferSize - rxTail) % serialBufferSize);
+}
+
+int HostSerial::read(){
+  if (rxHead == rxTail){return -1;}
+  uint8_t byte = rxBuffer[rxTail];
+  rxTail = (rxTail + 1) % serialBufferSize;
+  return byte;
+}
+
+int HostSerial::peek(){
+  if (rxHead == rxTail){return -1;}
+  return rxBuffer[rxTail];
+}
+
+int HostSerial::availableForWrite(){
+  if (txBusyUntil <= cycles || byteCycles() == 0){return serialHardwareBuffer;}
+  uint64_t queued = (txBusyUntil - cycles + byteCycles() - 1) / byteCycles();
+  return queued >= serialHardwareBuffer ? 0 : (int) (serialHardwareBuffer - queued);
+}
+
+void HostSerial::flush(){
+  if (txBusyUntil > cycles){
+    hostAdvanceMicros((uint32_t) ((txBusyUntil - cycles + cyclesPerMicro - 1) / cyclesPerMicro));
+  }
+}
+
+size_t hostSerialTake(uint8_t* buffer, size_t size){
+  size_t count = 0;
+  while (txTail != txHead && count < size){
+    buffer[count++] = txBuffer[txTail];
+    txTail = (txTail + 1) % serialBufferSize;
+  }
+  return count;
+}
+
+void hostSerialInject(const uint8_t* data, size_t length){
+  if (!(UCSR0B & (1 << RXCIE0))){return;}
+
+  for (size_t i = 0; i < length; i++){
+    rxBuffer[rxHead] = data[i];
+    rxHead = (rxHead + 1) % serialBufferSize;
+  }
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Reset
+ * ------------------------------------------------------------------------- */
+
+static void resetBoard(){
+  for (uint8_t i = 0; i < hostPortCount; i++){
+    *portRegisters[i] = 0;
+    *ddrRegisters[i] = 0;
+    inputDriven[i] = 0;
+    inputLevel[i] = 0;
+  }
+
+  //Arduino core leaves interrupts enabled and the ADC prescaler at 128
+  SREG = (1 << SREG_I);
+  ADCSRA = (1 << ADEN) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+  ADCSRB = 0;
+  ADMUX = 0;
+  GPIOR0 = GPIOR1 = GPIOR2 = 0;
+
+  for (uint8_t t = 0; t < hostTimerCount; t++){
+    *timers[t].controlA = 0;
+    *timers[t].controlB = 0;
+    *timers[t].counter = 0;
+    *timers[t].interruptMask = 0;
+    timers[t].interruptFlags->reset();
+    for (uint8_t unit = 0; unit < 3; unit++){
+      *timers[t].compare[unit] = 0;
+      outputLatch[t][unit] = 0;
+    }
+    timerCycles[t] = 0;
+  }
+  TCCR1C = 0;
+  TCCR3C = 0;
+
+  for (uint8_t i = 0; i < analogChannelCount; i++){analogValues[i] = 0;}
+  for (uint8_t i = 0; i < megaPinCount; i++){spiWords[i] = 0;}
+
+  txHead = txTail = rxHead = rxTail = 0;
+  serialBaud = 0;
+  txBusyUntil = 0;
+  UCSR0B = 0;
+
+  WDTCSR = 0;
+  watchdogEnabled = false;
+  cycles = 0;
+}
+
+void hostReset(){
+  resetBoard();
+  MCUSR = (1 << PORF);
+}
+
+void hostRestart(){
+  resetBoard();
+
+  //WDRF keeps the watchdog on with the shortest timeout until the firmware clears it
+  if (MCUSR & (1 << WDRF)){
+    wdt_enable(WDTO_15MS);
+  }
+}
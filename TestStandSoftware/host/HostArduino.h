@@ -0,0 +1,373 @@
+/* Filename:      HostArduino.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Linux backend of the Hal. Provides the parts of the Arduino
+ *                core and the ATmega2560 registers used by the Test Stand
+ *                Software, so the control logic can be built and run on a
+ *                normal Linux machine. Also contains the host* interfaces used
+ *                by simulators to drive the inputs and read the outputs.
+ *
+ *                Nothing takes real time. The virtual clock only advances in
+ *                delay(), delayMicroseconds(), analogRead(), SPI reads, when
+ *                the Serial transmit buffer is full, in the idle sleep and in
+ *                hostAdvanceMicros(). A watchdog timeout calls the reset
+ *                handler set by the simulator.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/types.h>
+
+//glibc defines mode_t in sys/types.h, the firmware uses the name for its mode enumeration
+#define mode_t fwMode_t
+
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+
+#ifndef F_CPU
+#define F_CPU 16000000L
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define bit(b) (1UL << (b))
+#define _BV(b) (1 << (b))
+
+
+/* ---------------------------------------------------------------------------
+ * Registers. Written and read like on the AVR. PINx are read through
+ * hostReadPin(), which combines the outputs, pullups, timer compare outputs
+ * and the simulated external inputs.
+ * ------------------------------------------------------------------------- */
+
+typedef enum {
+  HOST_PORT_A, HOST_PORT_B, HOST_PORT_C, HOST_PORT_D, HOST_PORT_E, HOST_PORT_F,
+  HOST_PORT_G, HOST_PORT_H, HOST_PORT_J, HOST_PORT_K, HOST_PORT_L
+} hostPort_t;
+
+const uint8_t hostPortCount = 11;
+
+extern volatile uint8_t PORTA, PORTB, PORTC, PORTD, PORTE, PORTF, PORTG, PORTH, PORTJ, PORTK, PORTL;
+extern volatile uint8_t DDRA, DDRB, DDRC, DDRD, DDRE, DDRF, DDRG, DDRH, DDRJ, DDRK, DDRL;
+
+uint8_t hostReadPin(hostPort_t port);
+
+#define PINA hostReadPin(HOST_PORT_A)
+#define PINB hostReadPin(HOST_PORT_B)
+#define PINC hostReadPin(HOST_PORT_C)
+#define PIND hostReadPin(HOST_PORT_D)
+#define PINE hostReadPin(HOST_PORT_E)
+#define PINF hostReadPin(HOST_PORT_F)
+#define PING hostReadPin(HOST_PORT_G)
+#define PINH hostReadPin(HOST_PORT_H)
+#define PINJ hostReadPin(HOST_PORT_J)
+#define PINK hostReadPin(HOST_PORT_K)
+#define PINL hostReadPin(HOST_PORT_L)
+
+enum { PORTA0, PORTA1, PORTA2, PORTA3, PORTA4, PORTA5, PORTA6, PORTA7 };
+enum { PORTB0, PORTB1, PORTB2, PORTB3, PORTB4, PORTB5, PORTB6, PORTB7 };
+enum { PORTC0, PORTC1, PORTC2, PORTC3, PORTC4, PORTC5, PORTC6, PORTC7 };
+enum { PORTD0, PORTD1, PORTD2, PORTD3, PORTD4, PORTD5, PORTD6, PORTD7 };
+enum { PORTE0, PORTE1, PORTE2, PORTE3, PORTE4, PORTE5, PORTE6, PORTE7 };
+enum { PORTF0, PORTF1, PORTF2, PORTF3, PORTF4, PORTF5, PORTF6, PORTF7 };
+enum { PORTG0, PORTG1, PORTG2, PORTG3, PORTG4, PORTG5 };
+enum { PORTH0, PORTH1, PORTH2, PORTH3, PORTH4, PORTH5, PORTH6, PORTH7 };
+enum { PORTJ0, PORTJ1, PORTJ2, PORTJ3, PORTJ4, PORTJ5, PORTJ6, PORTJ7 };
+enum { PORTK0, PORTK1, PORTK2, PORTK3, PORTK4, PORTK5, PORTK6, PORTK7 };
+enum { PORTL0, PORTL1, PORTL2, PORTL3, PORTL4, PORTL5, PORTL6, PORTL7 };
+
+//Status register, only the global interrupt enable bit is emulated
+extern volatile uint8_t SREG;
+enum { SREG_I = 7 };
+
+void hostSei(void);
+#define cli() (SREG &= ~(1 << SREG_I))
+#define sei() hostSei()
+
+//ADC, only the prescaler bits affect the conversion time
+extern volatile uint8_t ADCSRA, ADCSRB, ADMUX;
+enum { ADPS0, ADPS1, ADPS2, ADIE, ADIF, ADATE, ADSC, ADEN };
+
+//General purpose IO registers
+extern volatile uint8_t GPIOR0, GPIOR1, GPIOR2;
+
+/* TCCRnC only has the force output compare strobes. Writing a FOCnx bit updates
+ * the compare output latch by the COMnx bits at once, so the register is an object.
+ */
+class HostForceRegister {
+public:
+  explicit HostForceRegister(uint8_t timer) : timer(timer) {}
+  HostForceRegister& operator=(uint8_t value);
+  operator uint8_t() const { return 0; }   //Strobes read as zero
+private:
+  uint8_t timer;
+};
+
+/* A TIFRn flag is cleared by writing a one to it, writing a zero leaves it as it is.
+ * The flags are set by the timer emulation.
+ */
+class HostFlagRegister {
+public:
+  HostFlagRegister& operator=(uint8_t value){ flags &= ~value; return *this; }
+  operator uint8_t() const { return flags; }
+  void raise(uint8_t mask){ flags |= mask; }
+  void reset(){ flags = 0; }
+private:
+  volatile uint8_t flags = 0;
+};
+
+typedef HostFlagRegister flagRegister_t;
+
+//16-bit Timer1 and Timer3, normal mode with output compare units
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1;
+extern HostFlagRegister TIFR1;
+extern HostForceRegister TCCR1C;
+extern volatile uint16_t TCNT1, OCR1A, OCR1B, OCR1C;
+extern volatile uint8_t TCCR3A, TCCR3B, TIMSK3;
+extern HostFlagRegister TIFR3;
+extern HostForceRegister TCCR3C;
+extern volatile uint16_t TCNT3, OCR3A, OCR3B, OCR3C;
+
+enum { WGM10, WGM11, COM1C0, COM1C1, COM1B0, COM1B1, COM1A0, COM1A1 };
+enum { CS10, CS11, CS12, WGM12, WGM13, ICES1 = 6, ICNC1 };
+enum { FOC1C = 5, FOC1B, FOC1A };
+enum { TOIE1, OCIE1A, OCIE1B, OCIE1C, ICIE1 = 5 };
+enum { TOV1, OCF1A, OCF1B, OCF1C, ICF1 = 5 };
+enum { WGM30, WGM31, COM3C0, COM3C1, COM3B0, COM3B1, COM3A0, COM3A1 };
+enum { CS30, CS31, CS32, WGM32, WGM33, ICES3 = 6, ICNC3 };
+enum { FOC3C = 5, FOC3B, FOC3A };
+enum { TOIE3, OCIE3A, OCIE3B, OCIE3C, ICIE3 = 5 };
+enum { TOV3, OCF3A, OCF3B, OCF3C, ICF3 = 5 };
+
+//Interrupt vectors are plain functions, called by the virtual clock
+#define ISR(vector) extern "C" void vector(void)
+
+//Sleep, only the idle mode is emulated. sleep_cpu() runs the virtual clock to the next timer interrupt
+enum { SLEEP_MODE_IDLE };
+void hostSleep(void);
+#define set_sleep_mode(mode) ((void) (mode))
+#define sleep_enable() ((void) 0)
+#define sleep_disable() ((void) 0)
+#define sleep_cpu() hostSleep()
+
+//Watchdog in the system reset or the interrupt and system reset mode, and the reset flags.
+//The timeouts are 16ms << WDTO_x
+extern volatile uint8_t MCUSR;
+extern volatile uint8_t WDTCSR;
+enum { PORF, EXTRF, BORF, WDRF, JTRF };
+enum { WDP0, WDP1, WDP2, WDE, WDCE, WDP3, WDIE, WDIF };
+enum { WDTO_15MS, WDTO_30MS, WDTO_60MS, WDTO_120MS, WDTO_250MS, WDTO_500MS, WDTO_1S, WDTO_2S, WDTO_4S, WDTO_8S };
+void wdt_enable(uint8_t timeout);
+void wdt_disable(void);
+void wdt_reset(void);
+
+//Variables kept over a reset. Host statics are never cleared, MCUSR tells a power-on from a restart
+#define NOINIT
+
+//EEPROM variables are plain statics, kept over a reset like the EEPROM. Writes take no time
+#define EEMEM
+inline void eeprom_read_block(void* dst, const void* src, size_t n){ memcpy(dst, src, n); }
+inline void eeprom_update_block(const void* src, void* dst, size_t n){ memcpy(dst, src, n); }
+inline void eeprom_update_byte(uint8_t* address, uint8_t value){ *address = value; }
+inline bool eeprom_is_ready(void){ return true; }
+
+//CRC-16/CCITT step of <util/crc16.h>, reflected polynomial 0x8408
+inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data){
+  data ^= crc & 0xFF;
+  data ^= data << 4;
+  return (((uint16_t) data << 8) | (crc >> 8)) ^ (uint8_t) (data >> 4) ^ ((uint16_t) data << 3);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Arduino core
+ * ------------------------------------------------------------------------- */
+
+enum { A0 = 54, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11, A12, A13, A14, A15 };
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+class HostSerial {
+public:
+  void begin(unsigned long baud);
+  void end(void);
+  size_t write(uint8_t byte);
+  int available(void);
+  int read(void);
+  int peek(void);
+  int availableForWrite(void);
+  void flush(void);
+  operator bool() { return true; }
+};
+
+extern HostSerial Serial;
+
+//USART0 control register B. begin() turns the receiver and its interrupt on,
+//bytes arriving while RXCIE0 is clear are lost
+extern volatile uint8_t UCSR0B;
+enum { TXB80, RXB80, UCSZ02, TXEN0, RXEN0, UDRIE0, TXCIE0, RXCIE0 };
+
+
+/* ---------------------------------------------------------------------------
+ * Simulator interfaces
+ * ------------------------------------------------------------------------- */
+
+/* Function:      Reset every register, pin, analog and SPI value, the Serial
+ *                buffers and the virtual clock to power-on state.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void hostReset(void);
+
+
+/* Function:      Reset the board like hostReset(), but keep MCUSR as set by
+ *                the cause of the reset. Called by the reset handler before
+ *                starting the firmware again.
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void hostRestart(void);
+
+
+/* Function:      Set the function called when the watchdog times out, after
+ *                the WDRF flag is set. The handler must not return, e.g. it
+ *                calls hostRestart() and jumps back to the start of the
+ *                firmware. Without a handler a watchdog reset ends the
+ *                program. Survives hostReset().
+ *
+ * IN:            Function to call, NULL to remove
+ * OUT:           Nothing
+ */
+void hostSetResetHandler(void (*handler)(void));
+
+
+/* Function:      Advance the virtual clock. Timers are stepped and pending
+ *                interrupts are called when interrupts are enabled.
+ *
+ * IN:            Microseconds to advance
+ * OUT:           Nothing
+ */
+void hostAdvanceMicros(uint32_t us);
+
+
+/* Function:      Set a function called every time the virtual clock has
+ *                advanced, e.g. a plant model following the outputs between
+ *                the analog reads and delays of a firmware loop. Survives
+ *                hostReset(). The hook may not advance the clock itself.
+ *
+ * IN:            Function to call, NULL to remove
+ * OUT:           Nothing
+ */
+void hostSetClockHook(void (*hook)(void));
+
+
+/* Function:      Current time of the virtual clock without the 32-bit wrap
+ *                of micros().
+ *
+ * IN:            Nothing
+ * OUT:           Microseconds since hostReset()
+ */
+uint64_t hostMicros(void);
+
+
+/* Function:      Drive a digital input pin from outside. Pins that are not
+ *                driven read as their pullup or LOW.
+ *
+ * IN:            Arduino pin number,
+ *                Level of the pin
+ * OUT:           Nothing
+ */
+void hostSetInput(uint8_t pin, bool level);
+
+
+/* Function:      Stop driving a digital input pin.
+ *
+ * IN:            Arduino pin number
+ * OUT:           Nothing
+ */
+void hostReleaseInput(uint8_t pin);
+
+
+/* Function:      Level of a pin as seen from outside the board. Includes the
+ *                timer compare outputs.
+ *
+ * IN:            Arduino pin number
+ * OUT:           true if the pin is high
+ */
+bool hostPinLevel(uint8_t pin);
+
+
+/* Function:      Set the value returned by analogRead() for a channel.
+ *
+ * IN:            Analog channel (0...15) or pin (A0...A15),
+ *                ADC value 0...1023
+ * OUT:           Nothing
+ */
+void hostSetAnalog(uint8_t channel, uint16_t value);
+
+
+/* Function:      Set the 32-bit word read from the SPI device selected by a
+ *                chip select pin, e.g. the raw MAX31855 frame.
+ *
+ * IN:            Arduino pin number of the chip select,
+ *                Word returned by the device, MSB first
+ * OUT:           Nothing
+ */
+void hostSetSpiWord(uint8_t csPin, uint32_t word);
+
+
+/* Function:      Read the 32-bit word of an SPI device. Used by the host
+ *                Adafruit_SPIDevice.
+ *
+ * IN:            Arduino pin number of the chip select
+ * OUT:           Word of the device
+ */
+uint32_t hostGetSpiWord(uint8_t csPin);
+
+
+/* Function:      Take the bytes written to Serial since the last call.
+ *
+ * IN:            Buffer for the bytes,
+ *                Size of the buffer
+ * OUT:           Number of bytes stored
+ */
+size_t hostSerialTake(uint8_t* buffer, size_t size);
+
+
+/* Function:      Queue bytes to be read by Serial.read(). Dropped while the
+ *                receive interrupt is off.
+ *
+ * IN:            Pointer to the bytes,
+ *                Number of bytes
+ * OUT:           Nothing
+ */
+void hostSerialInject(const uint8_t* data, size_t length);
+
+#endif
@@ -0,0 +1,423 @@
+/* Filename:      Plant.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Closed-loop plant model of the hybrid test stand for the host
+ *                simulators. See Plant.h.
+ */
+
+#include <math.h>
+
+#include "HostArduino.h"
+
+#include "Globals.h"
+#include "Plant.h"
+
+/* Plant explanation:
+ * The model is lumped and first order everywhere, it is meant for timing and
+ * redline logic, not for performance predictions. Pressures are in bar, times in s.
+ *
+ * Run tank -> main valve -> line -> injector -> chamber
+ * N2 supply -> purge valve -> line
+ *
+ * The line pressure settles to the conductance weighted mean of the sources
+ * connected to it. The injector flow is sqrt(line - chamber) scaled to 1 at the
+ * nominal pressure drop. The chamber pressure follows the oxidizer flow when the
+ * grain burns, the grain lights when oxidizer arrives while the igniter is lit.
+ * Oxidizer that arrives before the igniter is lit accumulates in the chamber and
+ * makes a pressure spike when it lights (hard start).
+ */
+
+const char* const plantFaultNames[plantFaultCount] = {
+  "none", "hard start", "overpressure", "feed overpr.", "chamber EMI",
+  "chamber stuck", "chamber open", "valve stuck", "valve late", "loadcell open"
+};
+
+//Longest integration step (us)
+static const uint32_t maxStepMicros = 1000;
+
+//Shorter updates are skipped, a few firmware loops per step at the full sample rate (us)
+static const uint32_t minStepMicros = 100;
+
+//Nominal pressure drop over the injector (bar)
+static const double injectorDrop = 28.0;
+
+//Conductance of the injector relative to an open valve
+static const double injectorConductance = 0.25;
+
+//Pressure of the N2 purge relative to the supply, set by the regulator
+static const double purgeRegulation = 0.7;
+
+//Time constant of the line pressure with one open valve (s)
+static const double lineTau = 0.02;
+
+//Time constant of the chamber pressure (s)
+static const double chamberTau = 0.025;
+
+//How long the pyrogen keeps burning after the igniter relay opens (s)
+static const double igniterAfterburn = 0.08;
+
+//How long a full valve stroke takes (s)
+static const double valveStroke = 0.015;
+
+//Injector flow needed to light the grain and to keep it burning
+static const double lightFlow = 0.1;
+static const double extinguishFlow = 0.05;
+
+//Chamber pressure of the hard start spike per nominal flow second of accumulated oxidizer (bar)
+static const double hardStartGain = 200.0;
+
+//Nominal burn of a full run tank (nominal flow seconds)
+static const double tankCapacity = 6.0;
+
+struct valveModel_t {
+  uint8_t pin;
+  bool command;
+  uint64_t changeTime;
+  double openDelay;
+  double closeDelay;
+  double target;
+  double position;
+};
+
+static plantState_t state;
+static plantFault_t fault;
+static uint64_t rng;
+static uint64_t lastTime;
+
+static valveModel_t oxValve;
+static valveModel_t n2Valve;
+
+//Operating point of the run
+static double tankStart;
+static double chamberGain;
+static double thrustPerBar;
+static double igniterLightDelay;
+static double faultDelay;
+static double faultRate;
+
+static double tankUsed;
+static double tankHeating;
+static double oxFraction;       //How much of the line content is oxidizer
+static double oxAccumulated;    //Unburned oxidizer in the chamber (nominal flow seconds)
+static double spikeAmplitude;
+static double spikeLevel;
+static double overpressureGain;
+static double nozzleTemperature;
+static double pipingTemperature;
+static double plumeVoltage;
+
+static bool igniterCommand;
+static uint64_t igniterRiseTime;
+static uint64_t igniterFallTime;
+
+static uint64_t slowWriteTime;
+static int16_t stuckChamberADC;
+static uint64_t emiEndTime;
+
+//xorshift64*, a separate sequence for every run
+static double randomUniform(){
+  rng ^= rng >> 12;
+  rng ^= rng << 25;
+  rng ^= rng >> 27;
+  return ((rng * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double randomRange(double low, double high){
+  return low + (high - low) * randomUniform();
+}
+
+//Approximately normal, sum of four uniforms scaled to unit variance
+static double randomGauss(double sigma){
+  double sum = randomUniform() + randomUniform() + randomUniform() + randomUniform();
+  return sigma * (sum - 2.0) * 1.7320508075688772;
+}
+
+static double seconds(uint64_t micros){
+  return micros / 1000000.0;
+}
+
+static void writeOutputs(uint64_t time, double dt);
+
+static void resetValve(valveModel_t* valve, uint8_t pin, double openDelay, double closeDelay){
+  valve->pin = pin;
+  valve->command = false;
+  valve->changeTime = 0;
+  valve->openDelay = openDelay;
+  valve->closeDelay = closeDelay;
+  valve->target = 0;
+  valve->position = 0;
+}
+
+void plantReset(plantFault_t newFault, uint64_t seed){
+  fault = newFault;
+  rng = seed * 0x9E3779B97F4A7C15ULL + 0x2545F4914F6CDD1DULL;
+  if (rng == 0){rng = 1;}
+  lastTime = hostMicros();
+
+  state = plantState_t();
+  tankStart = randomRange(46, 54);
+  state.tankPressure = tankStart;
+  state.n2Pressure = randomRange(57, 63);
+  chamberGain = randomRange(12, 16);
+  thrustPerBar = randomRange(38, 41);
+  igniterLightDelay = randomRange(0.03, 0.09);
+
+  resetValve(&oxValve, OXIDIZER_VALVE_PIN, randomRange(0.025, 0.045), randomRange(0.02, 0.035));
+  resetValve(&n2Valve, N2FEEDING_VALVE_PIN, randomRange(0.02, 0.04), randomRange(0.02, 0.035));
+
+  tankUsed = 0;
+  tankHeating = 0;
+  oxFraction = 0;
+  oxAccumulated = 0;
+  spikeAmplitude = 0;
+  spikeLevel = 0;
+  overpressureGain = 1;
+  nozzleTemperature = 20;
+  pipingTemperature = 20;
+  plumeVoltage = 0.4;
+
+  igniterCommand = false;
+  igniterRiseTime = 0;
+  igniterFallTime = 0;
+  slowWriteTime = 0;
+  stuckChamberADC = -1;
+  emiEndTime = 0;
+
+  //Onset of the fault from the rising edge of the igniter, or from the reset for the feed pressure
+  switch (fault){
+    case FAULT_HARD_START:        igniterLightDelay = randomRange(0.25, 0.5); break;
+    case FAULT_OVERPRESSURE:      faultDelay = randomRange(0.5, 4.5); faultRate = randomRange(10, 200); break;
+    case FAULT_FEED_OVERPRESSURE: faultDelay = randomRange(0.5, 10); faultRate = randomRange(4, 15); break;
+    case FAULT_CHAMBER_EMI:       faultDelay = randomRange(0, 5); break;
+    case FAULT_CHAMBER_STUCK:
+    case FAULT_CHAMBER_OPEN:
+    case FAULT_LOADCELL_OPEN:     faultDelay = randomRange(0.5, 4.5); break;
+    case FAULT_VALVE_STUCK:       oxValve.openDelay = 1e9; break;
+    case FAULT_VALVE_LATE:        oxValve.openDelay += randomRange(0.2, 0.4); break;
+    default: break;
+  }
+
+  writeOutputs(lastTime, 0);
+}
+
+//Follow the output pin of a valve. The pin changes are seen at the start of the update
+static void readValve(valveModel_t* valve, uint64_t time){
+  bool command = hostPinLevel(valve->pin);
+  if (command != valve->command){
+    valve->command = command;
+    valve->changeTime = time;
+  }
+}
+
+static void stepValve(valveModel_t* valve, uint64_t time, double dt){
+  double sinceChange = seconds(time - valve->changeTime);
+  if (valve->command && sinceChange >= valve->openDelay){
+    valve->target = 1;
+  }else if (!valve->command && sinceChange >= valve->closeDelay){
+    valve->target = 0;
+  }
+
+  double stroke = dt / valveStroke;
+  if (valve->position < valve->target){
+    valve->position = fmin(valve->target, valve->position + stroke);
+  }else{
+    valve->position = fmax(valve->target, valve->position - stroke);
+  }
+}
+
+//First order response towards the target, backward Euler so that any step is stable
+static double follow(double value, double target, double tau, double dt){
+  return value + (target - value) * dt / (tau + dt);
+}
+
+//Is the fault active at the given time
+static bool faultActive(plantFault_t which, uint64_t time){
+  if (fault != which){return false;}
+
+  uint64_t reference = (which == FAULT_FEED_OVERPRESSURE) ? 0 : igniterRiseTime;
+  if (which != FAULT_FEED_OVERPRESSURE && igniterRiseTime == 0){return false;}
+
+  uint64_t onset = reference + (uint64_t) (faultDelay * 1000000.0);
+  if (time < onset){return false;}
+
+  if (state.faultTime == 0){state.faultTime = onset;}
+  return true;
+}
+
+static void step(uint64_t time, double dt){
+  stepValve(&oxValve, time, dt);
+  stepValve(&n2Valve, time, dt);
+  state.oxValve = oxValve.position;
+  state.n2Valve = n2Valve.position;
+
+  //Run tank: blowdown with the used oxidizer, vapour pressure drop when the liquid runs out
+  bool dumpOpen = !hostPinLevel(DUMP_VALVE_PIN);
+  if (faultActive(FAULT_FEED_OVERPRESSURE, time)){
+    tankHeating += faultRate * dt;
+  }
+  double tank = (tankStart + tankHeating) * (1.0 - 0.3 * fmin(tankUsed, 1.0));
+  if (tankUsed > 1.0){
+    tank *= exp(-(tankUsed - 1.0) * 5.0);
+  }
+  if (dumpOpen){
+    tankStart -= tankStart * dt / 3.0;
+  }
+  state.tankPressure = tank;
+
+  //Line pressure
+  double oxConductance = oxValve.position;
+  double n2Conductance = n2Valve.position;
+  double supply = oxConductance * tank + n2Conductance * purgeRegulation * state.n2Pressure + injectorConductance * state.chamberPressure;
+  double conductance = oxConductance + n2Conductance + injectorConductance;
+  state.linePressure = follow(state.linePressure, supply / conductance, lineTau / conductance, dt);
+
+  if (oxConductance + n2Conductance > 0.01){
+    oxFraction = follow(oxFraction, oxConductance / (oxConductance + n2Conductance), 0.05, dt);
+  }
+
+  //Injector
+  double drop = fmax(state.linePressure - state.chamberPressure, 0.0);
+  double injectorFlow = sqrt(drop / injectorDrop);
+  state.oxFlow = injectorFlow * oxFraction;
+  tankUsed += state.oxFlow * oxConductance / (oxConductance + n2Conductance + 1e-9) * dt / tankCapacity;
+
+  if (state.oxFlow > lightFlow && state.oxArrivalTime == 0){
+    state.oxArrivalTime = time;
+  }
+
+  //Igniter
+  if (igniterCommand){
+    state.igniterLit = seconds(time - igniterRiseTime) >= igniterLightDelay;
+  }else{
+    state.igniterLit = state.igniterLit && seconds(time - igniterFallTime) < igniterAfterburn;
+  }
+  if (state.igniterLit && state.igniterLitTime == 0){
+    state.igniterLitTime = time;
+  }
+
+  //Grain
+  if (!state.burning && state.igniterLit && state.oxFlow > lightFlow){
+    state.burning = true;
+    spikeAmplitude = hardStartGain * oxAccumulated;
+    oxAccumulated = 0;
+  }else if (state.burning && state.oxFlow < extinguishFlow){
+    state.burning = false;
+  }
+  if (!state.burning){
+    oxAccumulated += state.oxFlow * dt;
+  }
+
+  if (faultActive(FAULT_OVERPRESSURE, time) && state.burning){
+    overpressureGain += faultRate / chamberGain * dt;
+  }
+
+  double chamberTarget = 0.5 * injectorFlow;
+  if (state.burning){
+    chamberTarget = chamberGain * overpressureGain * state.oxFlow;
+  }else if (state.igniterLit){
+    chamberTarget += 0.4;
+  }
+  double chamber = follow(state.chamberPressure - spikeLevel, chamberTarget, chamberTau, dt);
+
+  //Hard start spike, rises in a few ms and decays as the accumulated oxidizer burns
+  spikeAmplitude -= spikeAmplitude * dt / (0.04 + dt);
+  spikeLevel = follow(spikeLevel, spikeAmplitude, 0.004, dt);
+  state.chamberPressure = chamber + spikeLevel;
+  state.thrust = thrustPerBar * state.chamberPressure;
+
+  //Temperatures
+  nozzleTemperature = follow(nozzleTemperature, state.burning ? 600.0 : 20.0, 2.0, dt);
+  pipingTemperature = follow(pipingTemperature, 20.0 - 30.0 * state.oxFlow, 1.0, dt);
+  plumeVoltage = follow(plumeVoltage, state.burning ? 2.4 : 0.4, 0.2, dt);
+}
+
+//Raw MAX31855 word: thermocouple in bits 31...18 (0.25C), cold junction in bits 15...4 (0.0625C)
+static uint32_t thermocoupleWord(double celsius){
+  uint32_t hot = (uint32_t) temperatureToRaw(celsius) & 0x3FFF;
+  uint32_t cold = (uint32_t) (int16_t) (22.0 * 16) & 0xFFF;
+  return (hot << 18) | (cold << 4);
+}
+
+static void writeOutputs(uint64_t time, double dt){
+  //Chamber pressure sensor with the signal faults
+  int16_t chamberADC = pressureToADC(CHAMBER_PRESSURE, state.chamberPressure + randomGauss(0.05));
+
+  if (faultActive(FAULT_CHAMBER_EMI, time)){
+    //Bursts of 100...600us, 20 per second on average
+    if (time >= emiEndTime && randomUniform() < 20.0 * dt){
+      emiEndTime = time + (uint64_t) randomRange(100, 600);
+    }
+    if (time < emiEndTime){
+      chamberADC = maxADC;
+    }
+  }
+  if (faultActive(FAULT_CHAMBER_STUCK, time)){
+    if (stuckChamberADC < 0){stuckChamberADC = chamberADC;}
+    chamberADC = stuckChamberADC;
+  }
+  if (faultActive(FAULT_CHAMBER_OPEN, time)){
+    chamberADC = 0;
+  }
+
+  int16_t loadADC = loadToADC(state.thrust + randomGauss(2.0));
+  if (faultActive(FAULT_LOADCELL_OPEN, time)){
+    loadADC = voltageToADC(0.02);
+  }
+
+  hostSetAnalog(PRESSURE_INPUT_PIN0, pressureToADC(FEEDING_PRESSURE_OXIDIZER, state.tankPressure + randomGauss(0.1)));
+  hostSetAnalog(PRESSURE_INPUT_PIN1, pressureToADC(LINE_PRESSURE, state.linePressure + randomGauss(0.1)));
+  hostSetAnalog(PRESSURE_INPUT_PIN2, chamberADC);
+  hostSetAnalog(PRESSURE_INPUT_PIN3, pressureToADC(FEEDING_PRESSURE_N2, state.n2Pressure + randomGauss(0.1)));
+  hostSetAnalog(LOADCELL_INPUT_PIN, loadADC);
+
+  //Test inputs: ignition relay sense and the inverted main valve sense
+  hostSetInput(IGN_SW_RELAY_TEST_PIN, hostPinLevel(IGNITER_CONTROL_PIN));
+  hostSetInput(MAIN_VALVE_TEST_PIN, !hostPinLevel(OXIDIZER_VALVE_PIN));
+
+  //The slow rate channels change little within a millisecond
+  if (slowWriteTime != 0 && time - slowWriteTime < maxStepMicros){return;}
+  slowWriteTime = time;
+
+  hostSetAnalog(TMP36_INPUT_PIN, voltageToADC(0.5 + 22.0 / 100.0));
+  hostSetAnalog(INFRARED_INPUT_PIN, voltageToADC(plumeVoltage + randomGauss(0.01)));
+
+  hostSetSpiWord(THERMOCOUPLE_CS_PIN0, thermocoupleWord(20.0));
+  hostSetSpiWord(THERMOCOUPLE_CS_PIN1, thermocoupleWord(20.0));
+  hostSetSpiWord(THERMOCOUPLE_CS_PIN2, thermocoupleWord(nozzleTemperature));
+  hostSetSpiWord(THERMOCOUPLE_CS_PIN3, thermocoupleWord(pipingTemperature));
+}
+
+void plantUpdate(){
+  uint64_t now = hostMicros();
+  if (now - lastTime < minStepMicros){return;}
+  double dt = seconds(now - lastTime);
+
+  //Outputs of the firmware, assumed to have changed at the start of the interval
+  readValve(&oxValve, lastTime);
+  readValve(&n2Valve, lastTime);
+
+  bool igniter = hostPinLevel(IGNITER_CONTROL_PIN);
+  if (igniter != igniterCommand){
+    igniterCommand = igniter;
+    if (igniter){
+      igniterRiseTime = lastTime;
+    }else{
+      igniterFallTime = lastTime;
+    }
+  }
+
+  while (lastTime < now){
+    uint64_t stepMicros = now - lastTime;
+    if (stepMicros > maxStepMicros){stepMicros = maxStepMicros;}
+    lastTime += stepMicros;
+    step(lastTime, seconds(stepMicros));
+  }
+
+  writeOutputs(now, dt);
+}
+
+const plantState_t* plantGetState(){
+  return &state;
+}
@@ -0,0 +1,88 @@
+/* Filename:      Plant.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Closed-loop plant model of the hybrid test stand for the host
+ *                simulators. Reads the valve and igniter outputs of the firmware
+ *                from the emulated pins and feeds the pressures, load cell,
+ *                temperatures and test inputs back through the simulated ADC,
+ *                SPI and GPIO of the Hal.
+ *
+ *                Modelled: N2O run tank blowdown, N2 purge supply, valve opening
+ *                and closing delays, oxidizer line pressure, igniter delay,
+ *                chamber pressure rise, thrust and sensor noise. Faults can be
+ *                injected to exercise the redlines and the sensor health checks.
+ */
+
+#ifndef PLANT_H
+#define PLANT_H
+
+#include <stdint.h>
+
+//Injected fault of a simulated run
+typedef enum {
+  FAULT_NONE,
+  FAULT_HARD_START,         //Igniter lights late, accumulated oxidizer makes a chamber pressure spike
+  FAULT_OVERPRESSURE,       //Nozzle blockage, chamber pressure ramps over the redline during the burn
+  FAULT_FEED_OVERPRESSURE,  //Run tank heats up over the N2O feeding pressure redline
+  FAULT_CHAMBER_EMI,        //Short full scale spikes on the chamber pressure signal
+  FAULT_CHAMBER_STUCK,      //Chamber pressure signal freezes during the burn
+  FAULT_CHAMBER_OPEN,       //Chamber pressure sensor wire breaks during the burn
+  FAULT_VALVE_STUCK,        //Main oxidizer valve does not open
+  FAULT_VALVE_LATE,         //Main oxidizer valve opens a few hundred ms late
+  FAULT_LOADCELL_OPEN       //Load cell wire breaks during the burn
+} plantFault_t;
+
+const uint8_t plantFaultCount = FAULT_LOADCELL_OPEN + 1;
+
+extern const char* const plantFaultNames[plantFaultCount];
+
+//Physical state of the plant, for the measurements of the simulators
+struct plantState_t {
+  double tankPressure;      //N2O run tank (bar)
+  double n2Pressure;        //N2 purge supply (bar)
+  double linePressure;      //Oxidizer line after the main valve (bar)
+  double chamberPressure;   //True chamber pressure (bar)
+  double thrust;            //N
+  double oxValve;           //Main valve opening 0...1
+  double n2Valve;           //Purge valve opening 0...1
+  double oxFlow;            //Oxidizer flow through the injector, 1 = nominal
+  bool igniterLit;
+  bool burning;
+
+  //Event times in hostMicros(), 0 = not happened
+  uint64_t igniterLitTime;
+  uint64_t oxArrivalTime;   //Oxidizer flow through the injector above 10% of nominal
+  uint64_t faultTime;       //Onset of the injected fault
+};
+
+
+/* Function:      Reset the plant to a filled and pressurized stand with a
+ *                randomized operating point and the given fault.
+ *
+ * IN:            Fault to inject,
+ *                Seed of the random generator of the run
+ * OUT:           Nothing
+ */
+void plantReset(plantFault_t fault, uint64_t seed);
+
+
+/* Function:      Advance the plant to the current hostMicros() in steps of at
+ *                most 1ms and write the sensor outputs. Meant to be called
+ *                from the clock hook of the Hal, see hostSetClockHook().
+ *
+ * IN:            Nothing
+ * OUT:           Nothing
+ */
+void plantUpdate(void);
+
+
+/* Function:      Current physical state of the plant.
+ *
+ * IN:            Nothing
+ * OUT:           Pointer to the state
+ */
+const plantState_t* plantGetState(void);
+
+#endif
@@ -0,0 +1,472 @@
+/* Filename:      Simulate.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Batch simulator of the Test Stand Software. Runs complete
+ *                firing sequences of the firmware against the plant model of
+ *                Plant.cpp on the virtual clock, with a randomized operating
+ *                point and an injected fault in every run, and prints the
+ *                abort latency and sequence timing distributions, the burns
+ *                without thrust of AUX_FRAME_BURN and the longest task runs
+ *                reported in AUX_FRAME_TASK_TIMES.
+ *
+ *                Usage: teststand_sim [-n runs] [-s seed] [-j workers] [-c file.csv]
+ *
+ *                Runs are spread round-robin over the faults of plantFault_t.
+ *                The firmware state is global, so the workers are processes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "HostArduino.h"
+
+#include "Globals.h"
+#include "Init.h"
+#include "Countdown.h"
+#include "Mode.h"
+#include "Plant.h"
+
+//How long the firmware is followed after entering SAFE (us)
+static const uint64_t safeFollowTime = 200000;
+
+//Longest simulated run (us)
+static const uint64_t runTimeout = 30000000;
+
+struct runResult_t {
+  uint32_t index;
+  uint8_t fault;
+  bool finished;            //Sequence reached SHUTDOWN
+  bool aborted;             //Firmware entered SAFE
+  double peakChamber;       //Highest true chamber pressure (bar)
+
+  //Times in hostMicros(), 0 = not happened
+  uint64_t crossTime;       //True chamber pressure above chamberPressureThreshold
+  uint64_t safeTime;
+  uint64_t valveCloseTime;  //Main valve pin low after crossTime or safeTime
+  uint64_t igniterRise;
+  uint64_t igniterFall;
+  uint64_t oxOpen;
+  uint64_t oxClose;
+  uint64_t n2Open;
+  uint64_t n2Close;
+  uint64_t cameraRise;
+  uint64_t igniterLit;
+  uint64_t oxArrival;
+  uint64_t endTime;
+
+  uint8_t burnFlags;        //burnFlags_t bits of the last AUX_FRAME_BURN
+
+  //Longest run of each task_t in SEQUENCE and in the other modes (Timer1 ticks)
+  uint16_t taskTicks[2][taskCount];
+};
+
+static uint8_t serialScratch[4096];
+
+//Frame being read from the Serial bytes
+static uint8_t serialFrame[32];
+static uint8_t serialFrameLength;
+static bool serialEscaped;
+
+//Run being observed by the clock hook
+static runResult_t* observed;
+static bool sequenceStarted;
+static bool igniter, igniterFallen, ox, oxClosed, n2, n2Closed, camera;
+
+//Store the time of the first edge of a pin in the given direction
+static void recordEdge(uint64_t* time, bool* last, bool level, bool rising, uint64_t now){
+  if (level != *last){
+    if (level == rising && *time == 0){*time = now;}
+    *last = level;
+  }
+}
+
+/* Called by the Hal every time the virtual clock advances, so the plant and the
+ * edges follow the firmware between the analog reads and delays of a loop.
+ * An output written by the firmware is seen at the next advance.
+ */
+static void observe(){
+  plantUpdate();
+
+  runResult_t* result = observed;
+  uint64_t now = hostMicros();
+  const plantState_t* plant = plantGetState();
+
+  mode_t mode;
+  getMode(&mode);
+
+  bool igniterPin = hostPinLevel(IGNITER_CONTROL_PIN);
+  bool oxPin = hostPinLevel(OXIDIZER_VALVE_PIN);
+  bool n2Pin = hostPinLevel(N2FEEDING_VALVE_PIN);
+  bool cameraPin = hostPinLevel(CAMERA_TRIGGER_PIN);
+
+  //The sequence outputs, not the boot camera pulse or the actuator tests
+  if (!sequenceStarted){
+    sequenceStarted = (mode == SEQUENCE);
+    igniter = igniterFallen = igniterPin;
+    ox = oxClosed = oxPin;
+    n2 = n2Closed = n2Pin;
+    camera = cameraPin;
+    return;
+  }
+
+  recordEdge(&result->igniterRise, &igniter, igniterPin, true, now);
+  recordEdge(&result->igniterFall, &igniterFallen, igniterPin, false, now);
+  recordEdge(&result->oxOpen, &ox, oxPin, true, now);
+  recordEdge(&result->oxClose, &oxClosed, oxPin, false, now);
+  recordEdge(&result->n2Open, &n2, n2Pin, true, now);
+  recordEdge(&result->n2Close, &n2Closed, n2Pin, false, now);
+  recordEdge(&result->cameraRise, &camera, cameraPin, true, now);
+
+  result->peakChamber = std::max(result->peakChamber, plant->chamberPressure);
+  if (result->crossTime == 0 && plant->chamberPressure > chamberPressureThreshold){
+    result->crossTime = now;
+  }
+
+  if (mode == SAFE && result->safeTime == 0){
+    result->safeTime = now;
+    result->aborted = true;
+  }
+
+  uint64_t abortStart = result->crossTime ? result->crossTime : result->safeTime;
+  if (abortStart != 0 && result->valveCloseTime == 0 && !oxPin){
+    result->valveCloseTime = now;
+  }
+}
+
+static void handleFrame(runResult_t* result){
+  if (serialFrame[0] == AUX_FRAME_BURN && serialFrameLength == burnFrameLength){
+    result->burnFlags = serialFrame[1];
+    return;
+  }
+  if (serialFrame[0] != AUX_FRAME_TASK_TIMES || serialFrameLength != taskTimesFrameLength){
+    return;
+  }
+
+  uint16_t* ticks = result->taskTicks[serialFrame[1] == SEQUENCE ? 0 : 1];
+  for (uint8_t i = 0; i < taskCount; i++){
+    ticks[i] = std::max(ticks[i], (uint16_t) (serialFrame[2 + 2*i] << 8 | serialFrame[3 + 2*i]));
+  }
+}
+
+//Split the Serial bytes into frames like the Rock reader
+static void readSerial(runResult_t* result){
+  size_t count;
+
+  while ((count = hostSerialTake(serialScratch, sizeof(serialScratch))) > 0){
+    for (size_t i = 0; i < count; i++){
+      uint8_t byte = serialScratch[i];
+
+      if (serialEscaped){
+        byte ^= 0x20;
+        serialEscaped = false;
+      }else if (byte == 0x7D){
+        serialEscaped = true;
+        continue;
+      }else if (byte == 0x7F){
+        handleFrame(result);
+        serialFrameLength = 0;
+        continue;
+      }
+
+      if (serialFrameLength < sizeof(serialFrame)){
+        serialFrame[serialFrameLength++] = byte;
+      }
+    }
+  }
+}
+
+static runResult_t runOne(uint32_t index, uint64_t seed){
+  runResult_t result = {};
+  result.index = index;
+  result.fault = index % plantFaultCount;
+
+  observed = &result;
+  sequenceStarted = false;
+  serialFrameLength = 0;
+  serialEscaped = false;
+
+  hostReset();
+
+  //Operator control box: all switches off, ignition pressed once the stand waits
+  hostSetInput(DUMP_VALVE_BUTTON_PIN, false);
+  hostSetInput(HEATING_SENSE_PIN, false);
+  hostSetInput(IGNITION_SENSE_PIN, false);
+  hostSetInput(FEEDING_VALVE_BUTTON_PIN, false);
+  hostSetInput(MAIN_VALVE_BUTTON_PIN, false);
+
+  plantReset((plantFault_t) result.fault, seed);
+  hostSetClockHook(observe);
+  initObjects();
+
+  while (true){
+    mode_t mode;
+    getMode(&mode);
+
+    if (mode == WAIT){
+      hostSetInput(IGNITION_SENSE_PIN, true);
+    }
+
+    countdownStep();
+    readSerial(&result);
+
+    uint64_t now = hostMicros();
+    getMode(&mode);
+
+    if (mode == SHUTDOWN){
+      result.finished = true;
+      break;
+    }
+    if (result.aborted && now - result.safeTime > safeFollowTime){break;}
+    if (now > runTimeout){break;}
+  }
+
+  hostSetClockHook(NULL);
+
+  result.igniterLit = plantGetState()->igniterLitTime;
+  result.oxArrival = plantGetState()->oxArrivalTime;
+  result.endTime = hostMicros();
+  return result;
+}
+
+//Seed of a run, independent of how the runs are split between the workers
+static uint64_t runSeed(uint64_t seed, uint32_t index){
+  return seed * 1000003ULL + index;
+}
+
+static bool runWorkers(uint32_t runs, uint64_t seed, uint32_t workers, std::vector<runResult_t>* results){
+  //One worker runs in this process, easier to debug and profile
+  if (workers == 1){
+    for (uint32_t i = 0; i < runs; i++){
+      results->push_back(runOne(i, runSeed(seed, i)));
+    }
+    return true;
+  }
+
+  std::vector<int> pipes;
+  std::vector<pid_t> children;
+
+  for (uint32_t w = 0; w < workers; w++){
+    int fd[2];
+    if (pipe(fd) != 0){return false;}
+
+    pid_t pid = fork();
+    if (pid < 0){return false;}
+
+    if (pid == 0){
+      close(fd[0]);
+      for (uint32_t i = w; i < runs; i += workers){
+        runResult_t result = runOne(i, runSeed(seed, i));
+        if (write(fd[1], &result, sizeof(result)) != (ssize_t) sizeof(result)){_exit(1);}
+      }
+      _exit(0);
+    }
+
+    close(fd[1]);
+    pipes.push_back(fd[0]);
+    children.push_back(pid);
+  }
+
+  for (size_t w = 0; w < pipes.size(); w++){
+    runResult_t result;
+    while (read(pipes[w], &result, sizeof(result)) == (ssize_t) sizeof(result)){
+      results->push_back(result);
+    }
+    close(pipes[w]);
+    waitpid(children[w], NULL, 0);
+  }
+
+  std::sort(results->begin(), results->end(),
+            [](const runResult_t& a, const runResult_t& b){ return a.index < b.index; });
+  return results->size() == runs;
+}
+
+static double ms(uint64_t from, uint64_t to){
+  return ((double) to - (double) from) / 1000.0;
+}
+
+static void printDistribution(const char* name, std::vector<double> samples){
+  if (samples.empty()){
+    printf("  %-28s %6s\n", name, "-");
+    return;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+  printf("  %-28s %6zu %9.2f %9.2f %9.2f %9.2f\n", name, n,
+         samples[0], samples[n / 2], samples[(n * 95) / 100 < n ? (n * 95) / 100 : n - 1], samples[n - 1]);
+}
+
+static void printSummary(const std::vector<runResult_t>& results){
+  printf("\n%-14s %6s %6s %6s %6s %6s %6s %8s  %s\n",
+         "fault", "runs", "cross", "abort", "missed", "false", "done", "no thr.", "peak chamber max (bar)");
+
+  for (uint8_t f = 0; f < plantFaultCount; f++){
+    uint32_t runs = 0, crossed = 0, aborted = 0, missed = 0, falseAborts = 0, finished = 0, noThrust = 0;
+    double peak = 0;
+
+    for (const runResult_t& r : results){
+      if (r.fault != f){continue;}
+      runs++;
+      crossed += r.crossTime != 0;
+      aborted += r.aborted;
+      missed += r.crossTime != 0 && !r.aborted;
+      falseAborts += r.crossTime == 0 && r.aborted;
+      finished += r.finished;
+      noThrust += (r.burnFlags & BURN_NO_THRUST) != 0;
+      peak = std::max(peak, r.peakChamber);
+    }
+
+    printf("%-14s %6u %6u %6u %6u %6u %6u %8u  %.1f\n", plantFaultNames[f], runs, crossed, aborted, missed, falseAborts, finished, noThrust, peak);
+  }
+
+  std::vector<double> safeLatency, valveLatency;
+  for (const runResult_t& r : results){
+    if (r.crossTime != 0 && r.safeTime != 0){
+      safeLatency.push_back(ms(r.crossTime, r.safeTime));
+    }
+    if (r.crossTime != 0 && r.valveCloseTime != 0){
+      valveLatency.push_back(ms(r.crossTime, r.valveCloseTime));
+    }
+  }
+
+  printf("\nAbort latency from the true chamber pressure crossing %d bar (ms)\n", chamberPressureThreshold);
+  printf("  %-28s %6s %9s %9s %9s %9s\n", "", "n", "min", "median", "p95", "max");
+  printDistribution("to SAFE", safeLatency);
+  printDistribution("to main valve pin low", valveLatency);
+
+  for (uint8_t f = 0; f < plantFaultCount; f++){
+    std::vector<double> latency;
+    for (const runResult_t& r : results){
+      if (r.fault == f && r.crossTime != 0 && r.safeTime != 0){
+        latency.push_back(ms(r.crossTime, r.safeTime));
+      }
+    }
+    if (!latency.empty()){
+      char name[40];
+      snprintf(name, sizeof(name), "to SAFE, %s", plantFaultNames[f]);
+      printDistribution(name, latency);
+    }
+  }
+
+  //Sequence timing of the finished runs against the nominal times of Globals.h
+  std::vector<double> igniterWidth, oxOpen, oxClose, n2Open, n2Close, camera, ignitionMargin;
+  for (const runResult_t& r : results){
+    if (!r.finished || r.igniterRise == 0){continue;}
+    uint64_t t0 = r.igniterRise;
+    if (r.igniterFall) igniterWidth.push_back(ms(t0, r.igniterFall) - ignitionOffTime);
+    if (r.oxOpen)      oxOpen.push_back(ms(t0, r.oxOpen) - valveOnTime);
+    if (r.oxClose)     oxClose.push_back(ms(t0, r.oxClose) - valveOffTime);
+    if (r.n2Open)      n2Open.push_back(ms(t0, r.n2Open) - oxidiserEmptyTime);
+    if (r.n2Close)     n2Close.push_back(ms(t0, r.n2Close) - purgingTime);
+    if (r.cameraRise)  camera.push_back(ms(t0, r.cameraRise) - cameraTriggerTime);
+    if (r.igniterLit && r.oxArrival) ignitionMargin.push_back(ms(r.igniterLit, r.oxArrival));
+  }
+
+  printf("\nSequence timing error from the igniter rising edge, finished runs (ms)\n");
+  printf("  %-28s %6s %9s %9s %9s %9s\n", "", "n", "min", "median", "p95", "max");
+  printDistribution("igniter pulse width", igniterWidth);
+  printDistribution("main valve open", oxOpen);
+  printDistribution("main valve close", oxClose);
+  printDistribution("purge start", n2Open);
+  printDistribution("purge end", n2Close);
+  printDistribution("camera trigger", camera);
+  printDistribution("ox arrival after igniter lit", ignitionMargin);
+
+  //Blocking time of the ADC, SPI and UART at the AVR rates, the Linux backend doesn't charge the CPU time
+  static const char* taskNames[taskCount] = {"sense", "check", "seq", "verif", "comms", "ind", "stats"};
+  printf("\nLongest task runs, all runs (Timer1 ticks, 4us)\n  %-12s", "");
+  for (uint8_t i = 0; i < taskCount; i++){
+    printf(" %6s", taskNames[i]);
+  }
+  printf("\n");
+  for (uint8_t m = 0; m < 2; m++){
+    printf("  %-12s", m == 0 ? "SEQUENCE" : "other modes");
+    for (uint8_t i = 0; i < taskCount; i++){
+      uint16_t longest = 0;
+      for (const runResult_t& r : results){
+        longest = std::max(longest, r.taskTicks[m][i]);
+      }
+      printf(" %6u", longest);
+    }
+    printf("\n");
+  }
+}
+
+static bool writeCsv(const char* path, const std::vector<runResult_t>& results, uint64_t seed){
+  FILE* file = fopen(path, "w");
+  if (file == NULL){return false;}
+
+  fprintf(file, "run,seed,fault,finished,aborted,peak_chamber,cross_us,safe_us,valve_close_us,"
+                "igniter_rise_us,igniter_fall_us,ox_open_us,ox_close_us,n2_open_us,n2_close_us,"
+                "camera_rise_us,igniter_lit_us,ox_arrival_us,end_us\n");
+  for (const runResult_t& r : results){
+    fprintf(file, "%u,%llu,%s,%d,%d,%.2f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+            r.index, (unsigned long long) runSeed(seed, r.index), plantFaultNames[r.fault], r.finished, r.aborted, r.peakChamber,
+            (unsigned long long) r.crossTime, (unsigned long long) r.safeTime, (unsigned long long) r.valveCloseTime,
+            (unsigned long long) r.igniterRise, (unsigned long long) r.igniterFall,
+            (unsigned long long) r.oxOpen, (unsigned long long) r.oxClose,
+            (unsigned long long) r.n2Open, (unsigned long long) r.n2Close,
+            (unsigned long long) r.cameraRise, (unsigned long long) r.igniterLit,
+            (unsigned long long) r.oxArrival, (unsigned long long) r.endTime);
+  }
+
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char** argv){
+  uint32_t runs = 1000;
+  uint64_t seed = 1;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t workers = cpus > 0 ? (uint32_t) cpus : 1;
+  const char* csvPath = NULL;
+
+  int option;
+  while ((option = getopt(argc, argv, "n:s:j:c:")) != -1){
+    switch (option){
+      case 'n': runs = (uint32_t) strtoul(optarg, NULL, 0); break;
+      case 's': seed = strtoull(optarg, NULL, 0); break;
+      case 'j': workers = (uint32_t) strtoul(optarg, NULL, 0); break;
+      case 'c': csvPath = optarg; break;
+      default:
+        fprintf(stderr, "Usage: %s [-n runs] [-s seed] [-j workers] [-c file.csv]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (workers < 1){workers = 1;}
+  if (workers > runs){workers = runs > 0 ? runs : 1;}
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  std::vector<runResult_t> results;
+  if (!runWorkers(runs, seed, workers, &results)){
+    fprintf(stderr, "Simulation workers failed, %zu of %u runs\n", results.size(), runs);
+    return 1;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double wall = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  double simulated = 0;
+  for (const runResult_t& r : results){simulated += r.endTime / 1e6;}
+
+  printf("%u runs, seed %llu, %u workers: %.1f s wall, %.0f runs/min, %.0fx real time\n",
+         runs, (unsigned long long) seed, workers, wall, runs / wall * 60.0, simulated / wall);
+
+  printSummary(results);
+
+  if (csvPath != NULL && !writeCsv(csvPath, results, seed)){
+    fprintf(stderr, "Could not write %s\n", csvPath);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,65 @@
+/* Filename:      cppQueue.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Host build stand-in for the cppQueue library.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "cppQueue.h"
+
+cppQueue::cppQueue(size_t size_rec, uint16_t nb_recs, cppQueueType type, bool overwrite)
+  : recordSize(size_rec), recordCount(nb_recs), implementation(type), overwrite(overwrite){
+  queue = (uint8_t*) malloc(recordSize * recordCount);
+  flush();
+}
+
+cppQueue::~cppQueue(){
+  free(queue);
+}
+
+void cppQueue::flush(){
+  in = 0;
+  out = 0;
+  count = 0;
+}
+
+bool cppQueue::push(const void* record){
+  if (isFull()){
+    if (!overwrite){
+      return false;
+    }
+    //Drop the oldest record
+    if (implementation == FIFO){out = (out + 1) % recordCount;}
+    count--;
+  }
+
+  memcpy(&queue[in * recordSize], record, recordSize);
+  in = (in + 1) % recordCount;
+  count++;
+  return true;
+}
+
+bool cppQueue::peek(void* record){
+  if (isEmpty()){
+    return false;
+  }
+
+  uint16_t index = (implementation == FIFO) ? out : (in + recordCount - 1) % recordCount;
+  memcpy(record, &queue[index * recordSize], recordSize);
+  return true;
+}
+
+bool cppQueue::pop(void* record){
+  if (!peek(record)){
+    return false;
+  }
+
+  if (implementation == FIFO){out = (out + 1) % recordCount;}
+  else                       {in = (in + recordCount - 1) % recordCount;}
+  count--;
+  return true;
+}
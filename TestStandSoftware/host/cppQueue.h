@@ -0,0 +1,45 @@
+/* Filename:      cppQueue.h
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Host build stand-in for the cppQueue library. Same interface
+ *                and overwrite behaviour for the parts used by the firmware.
+ */
+
+#ifndef HOST_CPPQUEUE_H
+#define HOST_CPPQUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+  FIFO = 0,
+  LIFO = 1
+} cppQueueType;
+
+class cppQueue {
+public:
+  cppQueue(size_t size_rec, uint16_t nb_recs = 20, cppQueueType type = FIFO, bool overwrite = false);
+  ~cppQueue();
+
+  void flush(void);
+  bool isEmpty(void) { return count == 0; }
+  bool isFull(void) { return count == recordCount; }
+  uint16_t getCount(void) { return count; }
+  bool push(const void* record);
+  bool pop(void* record);
+  bool peek(void* record);
+
+private:
+  uint8_t* queue;
+  size_t recordSize;
+  uint16_t recordCount;
+  cppQueueType implementation;
+  bool overwrite;
+  uint16_t in;
+  uint16_t out;
+  uint16_t count;
+};
+
+#endif
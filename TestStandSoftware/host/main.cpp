@@ -0,0 +1,213 @@
+/* Filename:      main.cpp
+ * Author:        Eemeli Mykrä
+ * Date:          18.10.2026
+ * Version:       V1.56 (18.10.2026)
+ *
+ * Purpose:       Host executable of the Test Stand Software. Boots the firmware
+ *                on the Linux backend of the Hal, holds the ignition button to
+ *                run one full sequence and prints the mode and substate changes
+ *                decoded from the Serial data lines. Builds with -DPROFILE_BUILD
+ *                also print the loop phase statistics of AUX_FRAME_PROFILE.
+ *                The sample timing of AUX_FRAME_TIMING, the overrun counts
+ *                of AUX_FRAME_EXECUTIVE, the longest task runs of
+ *                AUX_FRAME_TASK_TIMES, the AUX_FRAME_BOOT report, the
+ *                config block of AUX_FRAME_CONFIG, the burn summary of
+ *                AUX_FRAME_BURN and the events of AUX_FRAME_BURN_EVENT are
+ *                always printed.
+ *
+ *                Usage: teststand_host [simulated seconds]
+ */
+
+#include <stdio.h>
+
+#include "HostArduino.h"
+
+#include "Globals.h"
+#include "Init.h"
+#include "Countdown.h"
+
+//When the operator presses the ignition button (us)
+static const uint64_t ignitionPressTime = 2000000;
+
+struct frameReader_t {
+  uint8_t frame[32];
+  uint8_t length;
+  bool escaped;
+};
+
+struct runStats_t {
+  uint32_t dataLines;
+  uint32_t auxFrames;
+  int lastMode;
+  int lastSubstate;
+  uint64_t sequenceStart;
+  uint64_t sequenceEnd;
+  uint32_t sequenceLoops;
+};
+
+//Config block collected from the AUX_FRAME_CONFIG chunks
+static uint8_t configBlock[configChunkCount * configChunkBytes];
+
+//Print the config block once its last chunk has arrived, the CRC is checked like on the Rock
+static void printConfig(uint8_t source){
+  config_t config;
+  memcpy(&config, configBlock, sizeof(config_t));
+
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < offsetof(config_t, crc); i++){
+    crc = _crc_ccitt_update(crc, configBlock[i]);
+  }
+
+  printf("%10.3f ms  config source %u, version %u, crc %s, chamber K %.4f B %.4f, load K %.4f B %.4f, tares %u\n",
+         hostMicros() / 1000.0, source, config.version, (crc == config.crc) ? "ok" : "error",
+         config.pressure[CHAMBER_PRESSURE].K, config.pressure[CHAMBER_PRESSURE].B, config.load.K, config.load.B,
+         config.tareCount);
+}
+
+static void handleFrame(const uint8_t* frame, uint8_t length, runStats_t* stats){
+  if (length == 12 || length == 20){
+    stats->dataLines++;
+
+    uint8_t status = frame[11] & 63;
+    int mode = status >> 3;
+    int substate = status & 7;
+
+    if (mode != stats->lastMode || substate != stats->lastSubstate){
+      printf("%10.3f ms  %-8s %s\n", hostMicros() / 1000.0, modeStrings[mode], substateStrings[substate]);
+      stats->lastMode = mode;
+      stats->lastSubstate = substate;
+    }
+  }else if (length == 3){
+    stats->dataLines++;
+  }else if (length > 0){
+    stats->auxFrames++;
+
+    if (frame[0] == AUX_FRAME_PROFILE && length == profileFrameLength){
+      printf("%10.3f ms  phase %u: n %u, min %u us, max %u us, mean %u us, bins",
+             hostMicros() / 1000.0, frame[1], frame[2] << 8 | frame[3], (frame[4] << 8 | frame[5]) * 4,
+             (frame[6] << 8 | frame[7]) * 4, (frame[8] << 8 | frame[9]) * 4);
+      for (uint8_t i = 0; i < profileHistogramBins; i++){
+        printf(" %u", frame[10 + i]);
+      }
+      printf("\n");
+    }else if (frame[0] == AUX_FRAME_TIMING && length == timingFrameLength){
+      printf("%10.3f ms  timing %-8s samples %lu, misses %u, max late %u us, bins",
+             hostMicros() / 1000.0, modeStrings[frame[1]],
+             (unsigned long) frame[2] << 24 | (unsigned long) frame[3] << 16 | frame[4] << 8 | frame[5],
+             frame[6] << 8 | frame[7], frame[8] << 8 | frame[9]);
+      for (uint8_t i = 0; i < timingHistogramBins; i++){
+        printf(" %u", frame[10 + i]);
+      }
+      printf("\n");
+    }else if (frame[0] == AUX_FRAME_BOOT && length == bootFrameLength){
+      printf("%10.3f ms  boot %s, reset flags 0x%02x, mode %s, warm restarts %u, stall phase 0x%02x, watchdog stalls %u\n",
+             hostMicros() / 1000.0, frame[2] ? "warm" : "cold", frame[1], modeStrings[frame[3]], frame[4] << 8 | frame[5],
+             frame[6], frame[7] << 8 | frame[8]);
+    }else if (frame[0] == AUX_FRAME_CONFIG && length == configFrameLength && frame[1] < configChunkCount){
+      memcpy(&configBlock[frame[1] * configChunkBytes], &frame[3], configChunkBytes);
+      if (frame[1] == configChunkCount - 1){
+        printConfig(frame[2]);
+      }
+    }else if (frame[0] == AUX_FRAME_BURN && length == burnFrameLength){
+      int32_t impulse = (uint32_t) frame[2] << 24 | (uint32_t) frame[3] << 16 | frame[4] << 8 | frame[5];
+      printf("%10.3f ms  burn flags 0x%02x, impulse %.1f Ns, peak %d N, average %d N, peak chamber %.2f bar, rise %.1f ms, duration %u ms\n",
+             hostMicros() / 1000.0, frame[1], impulse / 10.0, (int16_t) (frame[6] << 8 | frame[7]), (int16_t) (frame[8] << 8 | frame[9]),
+             (int16_t) (frame[10] << 8 | frame[11]) / 100.0, (frame[12] << 8 | frame[13]) / 10.0, frame[14] << 8 | frame[15]);
+    }else if (frame[0] == AUX_FRAME_BURN_EVENT && length == burnEventFrameLength){
+      static const char* eventStrings[] = {"ignition", "steady", "tail-off", "flame-out"};
+      int32_t sinceIgniter = (uint32_t) frame[3] << 24 | (uint32_t) frame[4] << 16 | frame[5] << 8 | frame[6];
+      int32_t sinceValve = (uint32_t) frame[7] << 24 | (uint32_t) frame[8] << 16 | frame[9] << 8 | frame[10];
+      printf("%10.3f ms  burn event %-9s channel %u, igniter +%.3f ms, valve ",
+             hostMicros() / 1000.0, frame[1] < 4 ? eventStrings[frame[1]] : "?", frame[2], sinceIgniter / 1000.0);
+      if (sinceValve == burnEventNoCommand){
+        printf("-\n");
+      }else{
+        printf("%+.3f ms\n", sinceValve / 1000.0);
+      }
+    }else if (frame[0] == AUX_FRAME_EXECUTIVE && length == executiveFrameLength){
+      printf("%10.3f ms  executive %-8s frame overruns %u, task overruns",
+             hostMicros() / 1000.0, modeStrings[frame[1]], frame[2] << 8 | frame[3]);
+      for (uint8_t i = 0; i < taskCount; i++){
+        printf(" %u", frame[4 + 2*i] << 8 | frame[5 + 2*i]);
+      }
+      printf("\n");
+    }else if (frame[0] == AUX_FRAME_TASK_TIMES && length == taskTimesFrameLength){
+      printf("%10.3f ms  executive %-8s longest task runs (ticks)",
+             hostMicros() / 1000.0, modeStrings[frame[1]]);
+      for (uint8_t i = 0; i < taskCount; i++){
+        printf(" %u", frame[2 + 2*i] << 8 | frame[3 + 2*i]);
+      }
+      printf("\n");
+    }
+  }
+}
+
+static void readSerial(frameReader_t* reader, runStats_t* stats){
+  uint8_t bytes[256];
+  size_t count;
+
+  while ((count = hostSerialTake(bytes, sizeof(bytes))) > 0){
+    for (size_t i = 0; i < count; i++){
+      uint8_t byte = bytes[i];
+
+      if (reader->escaped){
+        byte ^= 0x20;
+        reader->escaped = false;
+      }else if (byte == 0x7D){
+        reader->escaped = true;
+        continue;
+      }else if (byte == 0x7F){
+        handleFrame(reader->frame, reader->length, stats);
+        reader->length = 0;
+        continue;
+      }
+
+      if (reader->length < sizeof(reader->frame)){
+        reader->frame[reader->length++] = byte;
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv){
+  double seconds = (argc > 1) ? atof(argv[1]) : 15.0;
+  uint64_t endTime = (uint64_t) (seconds * 1000000.0);
+
+  hostReset();
+
+  //Operator control box: all switches off
+  hostSetInput(DUMP_VALVE_BUTTON_PIN, false);
+  hostSetInput(HEATING_SENSE_PIN, false);
+  hostSetInput(IGNITION_SENSE_PIN, false);
+  hostSetInput(FEEDING_VALVE_BUTTON_PIN, false);
+  hostSetInput(MAIN_VALVE_BUTTON_PIN, false);
+
+  initObjects();
+
+  frameReader_t reader = {};
+  runStats_t stats = {};
+  stats.lastMode = -1;
+  stats.lastSubstate = -1;
+
+  while (hostMicros() < endTime){
+    hostSetInput(IGNITION_SENSE_PIN, hostMicros() >= ignitionPressTime);
+
+    countdownStep();
+    readSerial(&reader, &stats);
+
+    if (stats.lastMode == SEQUENCE){
+      if (stats.sequenceLoops == 0){stats.sequenceStart = hostMicros();}
+      stats.sequenceEnd = hostMicros();
+      stats.sequenceLoops++;
+    }
+  }
+
+  printf("Data lines: %u, auxiliary frames: %u\n", stats.dataLines, stats.auxFrames);
+  if (stats.sequenceLoops > 1){
+    double sequenceSeconds = (stats.sequenceEnd - stats.sequenceStart) / 1000000.0;
+    printf("Loops in SEQUENCE: %u, %.0f Hz (target %d Hz)\n", stats.sequenceLoops,
+           (stats.sequenceLoops - 1) / sequenceSeconds, targetSampleRate);
+  }
+
+  return 0;
+}